@@ -0,0 +1,174 @@
+/** @file bsplineKernels_benchmark.cpp
+
+    @brief Measures the evaluation of univariate B-spline bases and
+    their derivatives with the fixed-degree kernels against the generic
+    run-time degree algorithm.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+#include <gsNurbs/gsBSplineKernels.h>
+
+using namespace gismo;
+
+// Reference implementation: Algorithm A2.3 of the NURBS book with the
+// degree known at run time, point by point
+void evalReference(const gsKnotVector<> & kv, const int p, const gsMatrix<> & u,
+                   const int n, std::vector<gsMatrix<> > & result)
+{
+    const int p1 = p + 1;
+    std::vector<real_t> ndu(p1 * p1), left(p1), right(p1), a(2 * p1);
+    const real_t start = *(kv.begin() + p), end = *(kv.end() - p - 1);
+
+    result.resize(n+1);
+    for (int k = 0; k <= n; ++k)
+        result[k].resize(p1, u.cols());
+
+    for (index_t v = 0; v < u.cols(); ++v)
+    {
+        if ( u(0,v) < start || u(0,v) > end )
+        {
+            for (int k = 0; k <= n; ++k)
+                result[k].col(v).setZero();
+            continue;
+        }
+
+        gsKnotVector<>::iterator span = kv.iFind( u(0,v) );
+
+        ndu[0] = 1;
+        for (int j = 1; j <= p; ++j)
+        {
+            left[j]  = u(0,v) - *(span+1-j);
+            right[j] = *(span+j) - u(0,v);
+            real_t saved = 0;
+            for (int r = 0; r < j; ++r)
+            {
+                ndu[j*p1 + r] = right[r+1] + left[j-r];
+                const real_t temp = ndu[r*p1 + j-1] / ndu[j*p1 + r];
+                ndu[r*p1 + j] = saved + right[r+1] * temp;
+                saved = left[j-r] * temp;
+            }
+            ndu[j*p1 + j] = saved;
+        }
+
+        for (int j = 0; j <= p; ++j)
+            result[0](j,v) = ndu[j*p1 + p];
+
+        for (int r = 0; r <= p; ++r)
+        {
+            real_t * a1 = &a[0];
+            real_t * a2 = &a[p1];
+            a1[0] = 1;
+            for (int k = 1; k <= n; ++k)
+            {
+                real_t d = 0;
+                const int rk = r - k, pk = p - k;
+                if (r >= k)
+                {
+                    a2[0] = a1[0] / ndu[(pk+1)*p1 + rk];
+                    d = a2[0] * ndu[rk*p1 + pk];
+                }
+                const int j1 = ( rk >= -1  ? 1   : -rk   );
+                const int j2 = ( r-1 <= pk ? k-1 : p - r );
+                for (int j = j1; j <= j2; ++j)
+                {
+                    a2[j] = (a1[j] - a1[j-1]) / ndu[(pk+1)*p1 + rk+j];
+                    d += a2[j] * ndu[(rk+j)*p1 + pk];
+                }
+                if (r <= pk)
+                {
+                    a2[k] = -a1[k-1] / ndu[(pk+1)*p1 + r];
+                    d += a2[k] * ndu[r*p1 + pk];
+                }
+                result[k](r,v) = d;
+                std::swap(a1, a2);
+            }
+        }
+
+        real_t factor = p;
+        for (int k = 1; k <= n; ++k)
+        {
+            result[k].col(v) *= factor;
+            factor *= p - k;
+        }
+    }
+}
+
+// Returns the best wall time out of nRuns calls of f
+template <typename F>
+real_t bestTime(F f, index_t nRuns)
+{
+    gsStopwatch time;
+    real_t best = std::numeric_limits<real_t>::max();
+    for (index_t i = 0; i < nRuns; ++i)
+    {
+        time.restart();
+        f();
+        best = math::min(best, time.stop());
+    }
+    return best;
+}
+
+struct EvalReference
+{
+    const gsKnotVector<> & kv; int p; const gsMatrix<> & u; int n; std::vector<gsMatrix<> > & r;
+    void operator()() const { evalReference(kv, p, u, n, r); }
+};
+
+struct EvalBasis
+{
+    const gsBSplineBasis<> & b; const gsMatrix<> & u; int n; std::vector<gsMatrix<> > & r;
+    void operator()() const { b.evalAllDers_into(u, n, r); }
+};
+
+int main(int argc, char *argv[])
+{
+    index_t nRuns = 5;
+    index_t nPts  = 100000;
+    index_t nElem = 64;
+
+    gsCmdLine cmd("Benchmark of the fixed-degree B-spline evaluation kernels.");
+    cmd.addInt("n", "runs", "Number of runs per measurement (the best one is reported)", nRuns);
+    cmd.addInt("p", "points", "Number of evaluation points", nPts);
+    cmd.addInt("e", "elements", "Number of knot spans", nElem);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+#ifdef _OPENMP
+    gsInfo << "Number of threads: " << omp_get_max_threads() << "\n";
+#endif
+
+    gsMatrix<> u(1, nPts);
+    u.setRandom();
+    u.array() = (u.array() + 1) / 2;
+
+    gsInfo << "deg  ders   reference [s]   kernels [s]   speedup\n";
+    bool ok = true;
+    for (int p = 1; p <= bspline::kernelMaxDegree; ++p)
+    {
+        gsKnotVector<> kv(0, 1, nElem - 1, p + 1);
+        gsBSplineBasis<> basis(kv);
+        for (int n = 0; n <= bspline::kernelMaxDerivative; ++n)
+        {
+            std::vector<gsMatrix<> > r0, r1;
+            EvalReference f0 = { kv, p, u, n, r0 };
+            EvalBasis     f1 = { basis, u, n, r1 };
+            const real_t t0 = bestTime(f0, nRuns);
+            const real_t t1 = bestTime(f1, nRuns);
+            for (int k = 0; k <= n; ++k)
+                ok = ok && (r0[k] - r1[k]).norm() <= 1e-10 * (1 + r0[k].norm());
+
+            gsInfo << std::setw(3) << p << std::setw(6) << n
+                   << std::setw(16) << t0 << std::setw(14) << t1
+                   << std::setw(10) << t0 / t1 << "\n";
+        }
+    }
+
+    if (!ok)
+        gsInfo << "The results do not agree.\n";
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -105,7 +105,7 @@ int main(int argc, char *argv[])
         gsField<> sol = stationary.constructSolution(Sol);
         fileName = baseName + "0";
         gsWriteParaview<>(sol, fileName, 1000, true);
-        collection.addTimestep(fileName,0,"0.vts");
+        collection.addTimestep(fileName,0,".vtm");
     }
 
     for ( int i = 1; i<=numSteps; ++i) // for all timesteps
@@ -126,7 +126,7 @@ int main(int argc, char *argv[])
             // Plot the snapshot to paraview
             fileName = baseName + util::to_string(i);
             gsWriteParaview<>(sol, fileName, 1000, true);
-            collection.addTimestep(fileName,i,"0.vts");
+            collection.addTimestep(fileName,i,".vtm");
         }
     }
 
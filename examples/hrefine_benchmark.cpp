@@ -0,0 +1,84 @@
+/** @file hrefine_benchmark.cpp
+
+    @brief Measures the cost of a local refinement of a THB-spline
+    basis, which updates the basis structure only around the refined
+    region, against building the refined basis from scratch.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char *argv[])
+{
+    index_t nRuns = 5;
+    index_t nElem = 128;
+    index_t deg   = 2;
+
+    gsCmdLine cmd("Benchmark of the local refinement of THB-spline bases.");
+    cmd.addInt("n", "runs", "Number of runs per measurement (the best one is reported)", nRuns);
+    cmd.addInt("e", "elements", "Number of coarse elements in each direction", nElem);
+    cmd.addInt("p", "degree", "Spline degree", deg);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsKnotVector<> kv(0, 1, nElem - 1, deg + 1);
+    gsTensorBSplineBasis<2> tbasis(kv, kv);
+
+    // Start from a basis with the lower left quarter refined twice
+    std::vector<index_t> boxes(5);
+    boxes[0] = 2;
+    boxes[1] = boxes[2] = 0;
+    boxes[3] = boxes[4] = 2 * nElem;
+    gsTHBSplineBasis<2> basis(tbasis, boxes);
+    gsInfo << "Initial basis: " << basis.size() << " functions\n";
+
+    gsInfo << "refined elements   functions   local [s]   rebuild [s]   speedup\n";
+    gsStopwatch time;
+    bool ok = true;
+    for (index_t k = 1; k <= nElem; k *= 2)
+    {
+        // A block of k x k elements of level 1 in the upper right quarter
+        std::vector<index_t> box(5);
+        box[0] = 1;
+        box[1] = box[2] = nElem;
+        box[3] = box[4] = nElem + k;
+
+        std::vector<index_t> all(boxes);
+        all.insert(all.end(), box.begin(), box.end());
+
+        real_t t0 = std::numeric_limits<real_t>::max(), t1 = t0;
+        index_t size = 0;
+        for (index_t r = 0; r < nRuns; ++r)
+        {
+            gsTHBSplineBasis<2> local(basis);
+            time.restart();
+            local.refineElements(box);
+            t0 = math::min(t0, time.stop());
+
+            time.restart();
+            gsTHBSplineBasis<2> full(tbasis, all);
+            t1 = math::min(t1, time.stop());
+
+            if (0 == r)
+            {
+                size = local.size();
+                ok = ok && size == full.size() &&
+                    local.getXmatrix() == full.getXmatrix();
+            }
+        }
+
+        gsInfo << std::setw(16) << k * k << std::setw(12) << size
+               << std::setw(12) << t0 << std::setw(14) << t1
+               << std::setw(10) << t1 / t0 << "\n";
+    }
+
+    if (!ok)
+        gsInfo << "The refined bases do not agree.\n";
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -5,6 +5,9 @@
     Here, CG solves the Schur complement formulation. For solving
     the saddle point formulation with MINRES, see ieti2_example.cpp.
 
+    If G+Smo is compiled with MPI, the patches are distributed among
+    the processes, e.g., mpirun -np 4 ./bin/ieti_example
+
     This class uses the expression assembler, for a use of the
     gsPoisson Assembler, see ieti2_example.cpp.
 
@@ -24,6 +27,17 @@ using namespace gismo;
 
 int main(int argc, char *argv[])
 {
+    /******************* Initialize MPI *********************/
+
+    const gsMpi & mpi = gsMpi::init(argc, argv);
+    gsMpiComm comm = mpi.worldComm();
+    const int nProcs = comm.size();
+    const int rank   = comm.rank();
+
+    // Only the first process reports
+    if (rank > 0)
+        gsInfo.setstate(std::ios_base::badbit);
+
     /************** Define command line options *************/
 
     std::string geometry("domain2d/yeti_mp2.xml");
@@ -175,6 +189,21 @@ int main(int argc, char *argv[])
 
     const index_t nPatches = mp.nPatches();
 
+    if (nProcs > nPatches)
+    {
+        gsInfo << "\nThere are more processes than patches. Use --SplitPatches.\n";
+        return EXIT_FAILURE;
+    }
+
+    // Every process owns a contiguous range of patches
+    std::vector<index_t> owner(nPatches);
+    index_t nLocalPatches = 0;
+    for (index_t k=0; k<nPatches; ++k)
+    {
+        owner[k] = (k * nProcs) / nPatches;
+        if (owner[k] == rank) ++nLocalPatches;
+    }
+
     //! [Define IetiMapper]
     gsIetiMapper<> ietiMapper;
     //! [Define IetiMapper]
@@ -229,12 +258,14 @@ int main(int argc, char *argv[])
     // The ieti system does not have a special treatment for the
     // primal dofs. They are just one more subdomain
     gsIetiSystem<> ieti;
-    ieti.reserve(nPatches+1);
+    ieti.reserve(nLocalPatches+1);
+    ieti.setCommunicator(comm);
 
     // The scaled Dirichlet preconditioner is independent of the
     // primal dofs.
     gsScaledDirichletPrec<> prec;
-    prec.reserve(nPatches);
+    prec.reserve(nLocalPatches);
+    prec.setCommunicator(comm);
 
     // Setup the primal system, which needs to know the number of primal dofs.
     gsPrimalSystem<> primal(ietiMapper.nPrimalDofs());
@@ -245,6 +276,9 @@ int main(int argc, char *argv[])
     //! [Assemble]
     for (index_t k=0; k<nPatches; ++k)
     {
+        // Every process only handles its own patches
+        if (owner[k] != rank) continue;
+
         // We use the local variants of everything
         gsBoundaryConditions<> bc_local;
         bc.getConditionsForPatch(k,bc_local);
@@ -335,9 +369,13 @@ int main(int argc, char *argv[])
     } // end for
     //! [End of assembling loop]
 
+    // If the patches are distributed among several processes, the primal
+    // problem is collected on the first process.
+    primal.gatherContributions(comm);
+
     // Add the primal problem if there are primal constraints
     //! [Primal to system]
-    if (ietiMapper.nPrimalDofs()>0)
+    if (ietiMapper.nPrimalDofs()>0 && rank==0)
     {
         // It is not required to provide a local solver to .addSubdomain,
         // since a sparse LU solver would be set up on the fly if required.
@@ -369,9 +407,12 @@ int main(int argc, char *argv[])
 
     gsInfo << "done.\n    Setup rhs... " << std::flush;
     // Compute the Schur-complement contribution for the right-hand-side
+    // This also sets up the local solvers (if not provided)
+    gsStopwatch time;
     //! [Setup rhs]
     gsMatrix<> rhsForSchur = ieti.rhsForSchurComplement();
     //! [Setup rhs]
+    const real_t timeSetup = time.stop();
 
     gsInfo << "done.\n    Setup cg solver for Lagrange multipliers and solve... " << std::flush;
     // Initial guess
@@ -379,26 +420,64 @@ int main(int argc, char *argv[])
     gsMatrix<> lambda;
     lambda.setRandom( ieti.nLagrangeMultipliers(), 1 );
     //! [Define initial guess]
+    // All processes run the same iteration, so they need the same initial guess
+    comm.broadcast( lambda.data(), static_cast<int>(lambda.size()), 0 );
 
     gsMatrix<> errorHistory;
 
+    time.restart();
     // This is the main cg iteration
     //! [Solve]
     gsConjugateGradient<> PCG( ieti.schurComplement(), prec.preconditioner() );
     PCG.setOptions( opt.getGroup("Solver") ).solveDetailed( rhsForSchur, lambda, errorHistory );
     //! [Solve]
+    const real_t timeSolve = time.stop();
 
     gsInfo << "done.\n    Reconstruct solution from Lagrange multipliers... " << std::flush;
     // Now, we want to have the global solution for u
     //! [Recover]
-    gsMatrix<> uVec = ietiMapper.constructGlobalSolutionFromLocalSolutions(
-        primal.distributePrimalSolution(
-            ieti.constructSolutionFromLagrangeMultipliers(lambda)
-        )
+    std::vector< gsMatrix<> > localSolutions = primal.distributePrimalSolution(
+        ieti.constructSolutionFromLagrangeMultipliers(lambda), comm
     );
     //! [Recover]
+
+    // The first process collects the solutions for all patches
+    std::vector< gsMatrix<> > solutions(nPatches);
+    for (index_t k=0, j=0; k<nPatches; ++k)
+    {
+        if (owner[k] == rank && rank == 0)
+            solutions[k].swap(localSolutions[j++]);
+        else if (owner[k] == rank)
+        {
+            int sz[2] = { (int)localSolutions[j].rows(), (int)localSolutions[j].cols() };
+            comm.send( sz, 2, 0, k );
+            comm.send( localSolutions[j].data(), sz[0]*sz[1], 0, k );
+            ++j;
+        }
+        else if (rank == 0)
+        {
+            int sz[2] = { 0, 0 };
+            comm.recv( sz, 2, owner[k], k );
+            solutions[k].resize( sz[0], sz[1] );
+            comm.recv( solutions[k].data(), sz[0]*sz[1], owner[k], k );
+        }
+    }
+
+    gsMatrix<> uVec;
+    if (rank == 0)
+        uVec = ietiMapper.constructGlobalSolutionFromLocalSolutions(solutions);
     gsInfo << "done.\n\n";
 
+    gsInfo << "Number of processes: " << nProcs << "\n";
+
+    // The local problems are factorized and solved in parallel if G+Smo
+    // is compiled with OpenMP
+#ifdef _OPENMP
+    gsInfo << "Number of threads: " << omp_get_max_threads() << "\n";
+#endif
+    gsInfo << "Time for the local factorizations and the rhs: " << timeSetup << " s\n";
+    gsInfo << "Time for the conjugate gradient solver:        " << timeSolve << " s\n\n";
+
     /******************** Print end Exit ********************/
 
     const index_t iter = errorHistory.rows()-1;
@@ -416,7 +495,7 @@ int main(int argc, char *argv[])
     if (calcEigenvalues)
         gsInfo << "Estimated condition number: " << PCG.getConditionNumber() << "\n";
 
-    if (!out.empty())
+    if (!out.empty() && rank == 0)
     {
         gsFileData<> fd;
         std::time_t time = std::time(NULL);
@@ -427,7 +506,7 @@ int main(int argc, char *argv[])
         gsInfo << "Write solution to file " << out << "\n";
     }
 
-    if (plot)
+    if (plot && rank == 0)
     {
         gsInfo << "Write Paraview data to file ieti_result.pvd\n";
         // Construct the solution as a scalar field
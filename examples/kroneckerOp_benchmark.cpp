@@ -0,0 +1,131 @@
+/** @file kroneckerOp_benchmark.cpp
+
+    @brief Measures the application of Kronecker products of dense
+    operators as they appear in the fast diagonalization method, for
+    patch sizes in two and three dimensions.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Reference implementation, which reshapes and transposes into fresh
+// matrices for every factor
+void applyReference(const std::vector<gsLinearOperator<>::Ptr> & ops,
+                    const gsMatrix<> & input, gsMatrix<> & x)
+{
+    index_t sz = input.rows();
+    const index_t n = input.cols();
+    gsMatrix<> q0 = input, q1, temp;
+    for (index_t i = ops.size() - 1; i >= 0; --i)
+    {
+        const index_t cols_i = ops[i]->cols(), rows_i = ops[i]->rows();
+        const index_t r_i = sz / cols_i;
+        q0.resize(cols_i, n * r_i);
+        ops[i]->apply(q0, temp);
+        q1.resize(r_i, n * rows_i);
+        for (index_t k = 0; k != n; ++k)
+            q1.middleCols(k*rows_i, rows_i) = temp.middleCols(k*r_i, r_i).transpose();
+        q1.swap(q0);
+        sz = (sz / cols_i) * rows_i;
+    }
+    q0.resize(sz, n);
+    x.swap(q0);
+}
+
+// Returns the best wall time out of nRuns calls of f
+template <typename F>
+real_t bestTime(F f, index_t nRuns)
+{
+    gsStopwatch time;
+    real_t best = std::numeric_limits<real_t>::max();
+    for (index_t i = 0; i < nRuns; ++i)
+    {
+        time.restart();
+        f();
+        best = math::min(best, time.stop());
+    }
+    return best;
+}
+
+struct ApplyReference
+{
+    const std::vector<gsLinearOperator<>::Ptr> & ops; const gsMatrix<> & x; gsMatrix<> & y;
+    void operator()() const { applyReference(ops, x, y); }
+};
+
+struct ApplyStatic
+{
+    const std::vector<gsLinearOperator<>::Ptr> & ops; const gsMatrix<> & x; gsMatrix<> & y;
+    void operator()() const { gsKroneckerOp<>::apply(ops, x, y); }
+};
+
+struct ApplyOp
+{
+    const gsKroneckerOp<> & op; const gsMatrix<> & x; gsMatrix<> & y;
+    void operator()() const { op.apply(x, y); }
+};
+
+int main(int argc, char *argv[])
+{
+    index_t nRuns = 3;
+    index_t nRhs  = 1;
+    bool    large = false;
+
+    gsCmdLine cmd("Benchmark of the application of Kronecker products of operators.");
+    cmd.addInt   ("n", "runs", "Number of runs per measurement (the best one is reported)", nRuns);
+    cmd.addInt   ("c", "rhs", "Number of columns of the input", nRhs);
+    cmd.addSwitch("large", "Also measure larger patches", large);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+#ifdef _OPENMP
+    gsInfo << "Number of threads: " << omp_get_max_threads() << "\n";
+#endif
+
+    // Sizes of the univariate bases per dimension
+    std::vector< std::pair<index_t,index_t> > cases;
+    const index_t sizes2[] = { 64, 128, 256, 512, 1024 };
+    const index_t sizes3[] = { 16, 32, 48, 64, 96 };
+    for (index_t i = 0; i < (large ? 5 : 4); ++i)
+        cases.push_back(std::make_pair(2, sizes2[i]));
+    for (index_t i = 0; i < (large ? 5 : 4); ++i)
+        cases.push_back(std::make_pair(3, sizes3[i]));
+
+    gsInfo << "dim    size     dofs   reference [s]   static [s]   operator [s]\n";
+    bool ok = true;
+    for (size_t c = 0; c < cases.size(); ++c)
+    {
+        const index_t d = cases[c].first, m = cases[c].second;
+        std::vector<gsLinearOperator<>::Ptr> ops(d);
+        for (index_t i = 0; i < d; ++i)
+        {
+            gsMatrix<>::Ptr Q(new gsMatrix<>(m, m));
+            Q->setRandom();
+            ops[i] = makeMatrixOp(Q);
+        }
+        gsKroneckerOp<> op(ops);
+
+        gsMatrix<> x, y0, y1, y2;
+        x.setRandom(op.cols(), nRhs);
+        ApplyReference f0 = { ops, x, y0 };
+        ApplyStatic    f1 = { ops, x, y1 };
+        ApplyOp        f2 = { op,  x, y2 };
+        const real_t t0 = bestTime(f0, nRuns);
+        const real_t t1 = bestTime(f1, nRuns);
+        const real_t t2 = bestTime(f2, nRuns);
+        ok = ok && (y0 - y1).norm() <= 1e-10 * y0.norm() && (y0 - y2).norm() <= 1e-10 * y0.norm();
+
+        gsInfo << std::setw(3) << d << std::setw(8) << m << std::setw(9) << op.cols()
+               << std::setw(16) << t0 << std::setw(13) << t1 << std::setw(15) << t2 << "\n";
+    }
+
+    if (!ok)
+        gsInfo << "The results do not agree.\n";
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
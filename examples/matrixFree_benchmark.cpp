@@ -0,0 +1,114 @@
+/** @file matrixFree_benchmark.cpp
+
+    @brief Compares the matrix-free application of the stiffness
+    operator by sum factorization with the assembled sparse matrix, in
+    terms of set-up time, memory and time per application.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Returns the best wall time out of nRuns applications
+real_t timeApply(const gsLinearOperator<real_t> & op, const gsMatrix<real_t> & x,
+                 gsMatrix<real_t> & y, index_t nRuns)
+{
+    gsStopwatch time;
+    real_t best = std::numeric_limits<real_t>::max();
+    for (index_t i = 0; i < nRuns; ++i)
+    {
+        time.restart();
+        op.apply(x, y);
+        best = math::min(best, time.stop());
+    }
+    return best;
+}
+
+// Solves with the Jacobi preconditioned conjugate gradient method
+index_t solve(const gsLinearOperator<real_t>::Ptr & op, const gsMatrix<real_t> & diag,
+              const gsMatrix<real_t> & f, gsMatrix<real_t> & x)
+{
+    gsSparseMatrix<real_t> dinv(diag.rows(), diag.rows());
+    gsSparseEntries<real_t> entries;
+    for (index_t i = 0; i < diag.rows(); ++i)
+        entries.add(i, i, 1 / diag(i, 0));
+    dinv.setFrom(entries);
+
+    gsConjugateGradient<real_t> cg(op, makeMatrixOp(dinv.moveToPtr()));
+    cg.setTolerance(1e-8);
+    cg.setMaxIterations(1000);
+    x.setZero(f.rows(), 1);
+    cg.solve(f, x);
+    return cg.iterations();
+}
+
+int main(int argc, char *argv[])
+{
+    index_t dim        = 2;
+    index_t degree     = 3;
+    index_t numRefine  = 3;
+    index_t nRuns      = 5;
+
+    gsCmdLine cmd("Matrix-free versus assembled application of the stiffness operator.");
+    cmd.addInt("d", "dim", "Dimension, 2 or 3", dim);
+    cmd.addInt("p", "degree", "Spline degree", degree);
+    cmd.addInt("r", "refine", "Number of uniform h-refinement steps", numRefine);
+    cmd.addInt("n", "runs", "Number of runs per measurement (the best one is reported)", nRuns);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsMultiPatch<> patches = ( 3 == dim ? gsNurbsCreator<>::BSplineCubeGrid(2, 2, 2, 0.5)
+                                        : gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5) );
+    gsMultiBasis<> bases(patches);
+    bases.setDegree(degree);
+    for (index_t i = 0; i < numRefine; ++i)
+        bases.uniformRefine();
+
+    gsConstantFunction<> zero(0.0, dim);
+    gsBoundaryConditions<> bc;
+    for (gsMultiPatch<>::const_biterator bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+        bc.addCondition(*bit, condition_type::dirichlet, &zero);
+
+    gsStopwatch time;
+    gsGenericAssembler<> assembler(patches, bases, gsGenericAssembler<>::defaultOptions(), &bc);
+    gsSparseMatrix<> K = assembler.assembleStiffness();
+    K.makeCompressed();
+    const real_t tAssemble = time.stop();
+    const size_t memMatrix = K.nonZeros() * (sizeof(real_t) + sizeof(index_t))
+        + (K.cols() + 1) * sizeof(index_t);
+
+    gsDofMapper mapper;
+    bases.getMapper(dirichlet::elimination, iFace::glue, bc, mapper, 0);
+    time.restart();
+    gsMatrixFreeOp<real_t>::Ptr mfOp = gsMatrixFreeOp<real_t>::make(patches, bases, mapper);
+    const real_t tSetup = time.stop();
+
+    gsInfo << "Degrees of freedom: " << K.rows() << ", nonzeros per row: "
+           << (real_t)K.nonZeros() / K.rows() << "\n";
+
+    gsMatrix<> x, y1, y2;
+    x.setRandom(K.rows(), 1);
+    gsLinearOperator<>::Ptr matOp = makeMatrixOp(K);
+    const real_t t1 = timeApply(*matOp, x, y1, nRuns);
+    const real_t t2 = timeApply(*mfOp,  x, y2, nRuns);
+    gsInfo << "Difference of the results: " << (y1 - y2).norm() / y1.norm() << "\n";
+
+    gsMatrix<> diag1 = K.diagonal(), diag2, f, u1, u2;
+    mfOp->diagonal_into(diag2);
+    f.setOnes(K.rows(), 1);
+    const index_t it1 = solve(matOp, diag1, f, u1);
+    const index_t it2 = solve(mfOp,  diag2, f, u2);
+
+    gsInfo << "               set-up [s]   memory [MB]   apply [s]   CG iterations\n";
+    gsInfo << "assembled  " << std::setw(13) << tAssemble << std::setw(14) << memMatrix / 1048576.
+           << std::setw(12) << t1 << std::setw(16) << it1 << "\n";
+    gsInfo << "matrix-free" << std::setw(13) << tSetup << std::setw(14) << mfOp->memory() / 1048576.
+           << std::setw(12) << t2 << std::setw(16) << it2 << "\n";
+
+    return (y1 - y2).norm() <= 1e-10 * y1.norm() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -300,6 +300,10 @@ int main(int argc, char *argv[])
             smootherOp = makeJacobiOp(mg->matrix(i));
         else if ( smoother == "GaussSeidel" || smoother == "gs" )
             smootherOp = makeGaussSeidelOp(mg->matrix(i));
+        else if ( smoother == "MultiColorGaussSeidel" || smoother == "mcgs" )
+            smootherOp = makeMultiColorGaussSeidelOp(mg->matrix(i));
+        else if ( smoother == "Chebyshev" || smoother == "cheb" )
+            smootherOp = makeChebyshevOp(mg->matrix(i));
         else if ( smoother == "SubspaceCorrectedMassSmoother" || smoother == "scms" )
             smootherOp = setupSubspaceCorrectedMassSmoother( i, mg->numLevels(), mg->matrix(i),
                 multiBases[i], bc, opt, patchLocalDampingParameters );
@@ -313,7 +317,7 @@ int main(int argc, char *argv[])
         else
         {
             gsInfo << "\n\nThe chosen smoother is unknown.\n\nKnown are:\n  Richardson (r)\n  Jacobi (j)\n  GaussSeidel (gs)"
-                      "\n  SubspaceCorrectedMassSmoother (scms)\n  Hybrid (hyb)\n\n";
+                      "\n  MultiColorGaussSeidel (mcgs)\n  Chebyshev (cheb)\n  SubspaceCorrectedMassSmoother (scms)\n  Hybrid (hyb)\n\n";
             return EXIT_FAILURE;
         }
 
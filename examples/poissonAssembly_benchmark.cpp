@@ -0,0 +1,92 @@
+/** @file poissonAssembly_benchmark.cpp
+
+    @brief Measures the strong scaling of gsPoissonAssembler with
+    respect to the number of threads, with and without a fixed
+    sparsity pattern.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Returns the best wall time out of nRuns assemblies
+real_t timeAssembly(gsPoissonAssembler<real_t> & assembler, index_t nRuns)
+{
+    gsStopwatch time;
+    real_t best = std::numeric_limits<real_t>::max();
+    for (index_t i = 0; i < nRuns; ++i)
+    {
+        assembler.refresh();
+        time.restart();
+        assembler.assemble();
+        best = math::min(best, time.stop());
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    index_t numRefine  = 3;
+    index_t numElevate = 1;
+    index_t maxThreads = 0;
+    index_t nRuns      = 3;
+
+    gsCmdLine cmd("Thread scaling of the assembly of the Poisson problem.");
+    cmd.addInt("r", "refine", "Number of uniform h-refinement steps", numRefine);
+    cmd.addInt("e", "elevate", "Number of degree elevation steps", numElevate);
+    cmd.addInt("t", "threads", "Maximum number of threads (0: all available)", maxThreads);
+    cmd.addInt("n", "runs", "Number of runs per measurement (the best one is reported)", nRuns);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsMultiPatch<> patches = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5);
+    gsFunctionExpr<> f("2*pi^2*sin(pi*x)*sin(pi*y)", 2);
+    gsFunctionExpr<> g("sin(pi*x)*sin(pi*y)", 2);
+
+    gsBoundaryConditions<> bcInfo;
+    for (gsMultiPatch<>::const_biterator bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+        bcInfo.addCondition(*bit, condition_type::dirichlet, &g);
+
+    gsMultiBasis<> bases(patches);
+    bases.degreeElevate(numElevate);
+    for (index_t i = 0; i < numRefine; ++i)
+        bases.uniformRefine();
+
+    gsPoissonAssembler<real_t> assembler(patches, bases, bcInfo, f);
+    gsInfo << "Degrees of freedom: " << assembler.numDofs() << "\n";
+
+#ifdef _OPENMP
+    if (maxThreads <= 0)
+        maxThreads = omp_get_max_threads();
+#else
+    gsInfo << "Compiled without OpenMP, measuring a single thread.\n";
+    maxThreads = 1;
+#endif
+
+    gsInfo << "threads   critical   speedup   pattern   speedup\n";
+    real_t t1[2] = {0, 0};
+    for (index_t nt = 1; nt <= maxThreads; ++nt)
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(nt);
+#endif
+        real_t t[2];
+        for (index_t k = 0; k != 2; ++k)
+        {
+            assembler.options().setSwitch("FixedPattern", 1==k);
+            t[k] = timeAssembly(assembler, nRuns);
+            if (1 == nt)
+                t1[k] = t[k];
+        }
+        gsInfo << std::setw(7) << nt
+               << std::setw(11) << t[0] << std::setw(10) << t1[0] / t[0]
+               << std::setw(10) << t[1] << std::setw(10) << t1[1] / t[1] << "\n";
+    }
+
+    return EXIT_SUCCESS;
+}
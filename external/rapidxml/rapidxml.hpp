@@ -1368,6 +1368,7 @@ namespace rapidxml
     protected:
         int max_Id;
         unsigned m_float_precision;
+        bool m_binary_matrices;
 
     public:
         xml_node<Ch> * makeRoot()
@@ -1396,6 +1397,10 @@ namespace rapidxml
         inline unsigned getFloatPrecision() const {return m_float_precision;}
 
         inline void setFloatPrecision(const unsigned k) { m_float_precision = k; }
+
+        inline bool getBinaryMatrices() const {return m_binary_matrices;}
+
+        inline void setBinaryMatrices(const bool b) { m_binary_matrices = b; }
         //end G+Smo
     public:
 
@@ -1405,6 +1410,7 @@ namespace rapidxml
         //G+Smo
         , max_Id(-1)
         , m_float_precision(16)
+        , m_binary_matrices(false)
         //end G+Smo
         { }
 
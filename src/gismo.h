@@ -133,6 +133,7 @@ namespace internal
 /* ----------- MultiGrid ----------- */
 #include <gsMultiGrid/gsMultiGrid.h>
 #include <gsMultiGrid/gsGridHierarchy.h>
+#include <gsMultiGrid/gsAlgebraicMultiGrid.h>
 
 /* ----------- Quadrature ----------- */
 #include <gsAssembler/gsQuadRule.h>
@@ -148,6 +149,7 @@ namespace internal
 #include <gsAssembler/gsExprHelper.h>
 #include <gsAssembler/gsExprAssembler.h>
 #include <gsAssembler/gsExprEvaluator.h>
+#include <gsAssembler/gsMatrixFreeOp.h>
 
 /* ----------- Solver ----------- */
 #include <gsSolver/gsLinearOperator.h>
@@ -161,6 +163,8 @@ namespace internal
 #include <gsSolver/gsCompositePrecOp.h>
 #include <gsSolver/gsProductOp.h>
 #include <gsSolver/gsSimplePreconditioners.h>
+#include <gsSolver/gsChebyshevOp.h>
+#include <gsSolver/gsMixedPrecisionSolver.h>
 #include <gsSolver/gsSumOp.h>
 #include <gsSolver/gsKroneckerOp.h>
 #include <gsSolver/gsPatchPreconditionersCreator.h>
@@ -179,6 +183,7 @@ namespace internal
 #include <gsIO/gsFileManager.h>
 #include <gsIO/gsWriteParaview.h>
 #include <gsIO/gsParaviewCollection.h>
+#include <gsIO/gsParaviewFormat.h>
 #include <gsIO/gsReadFile.h>
 #include <gsUtils/gsPointGrid.h>
 #include <gsIO/gsXmlUtils.h>
@@ -191,6 +196,7 @@ namespace internal
 #include <gsUtils/gsStopwatch.h>
 #include <gsUtils/gsFunctionWithDerivatives.h>
 #include <gsUtils/gsQuasiInterpolate.h>
+#include <gsUtils/gsBoundingBoxTree.h>
 
 /* ----------- Extension ----------- */
 #ifdef GISMO_WITH_ADIFF
@@ -712,11 +712,17 @@ void gsAssembler<T>::apply(ElementVisitor & visitor,
         visitor_.assemble(*domIt, quWeights);
 
         // Push to global matrix and right-hand side vector
+        if ( m_system.fixedPattern() ) // atomic updates inside
+            visitor_.localToGlobal(patchIndex, m_ddof, m_system);
+        else
+        {
 #pragma omp critical(localToGlobal)
-        visitor_.localToGlobal(patchIndex, m_ddof, m_system); // omp_locks inside
+            visitor_.localToGlobal(patchIndex, m_ddof, m_system); // omp_locks inside
+        }
     }
 }//omp parallel
 
+    m_system.checkPattern();
 }
 
 
@@ -38,6 +38,7 @@ gsOptionList gsAssembler<T>::defaultOptions()
     opt.addReal("bdA", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 2.0  );
     opt.addInt ("bdB", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 1    );
     opt.addReal("bdO", "Overhead of sparse mem. allocation: (1+bdO)(bdA*deg + bdB) [0..1]", 0.333);
+    opt.addSwitch("FixedPattern", "Compute the exact sparsity pattern before the first assembly, reuse it afterwards and push the element contributions without locking", false);
     return opt;
 }
 
@@ -261,12 +261,28 @@ public:
         // computeDirichletDofs2(i);
     }
 
-    /// \brief Initializes the sparse matrix only
+    /// \brief Initializes the sparse matrix only.
+    ///
+    /// If the option "FixedPattern" is set, the pattern that was
+    /// built by a previous assembly is kept, provided that the
+    /// dimensions are unchanged. The following assembly then only
+    /// refills the values.
     void initMatrix(bool resetFirst = true)
     {
         if (resetFirst)
             resetSpaces();
         resetDimensions();
+
+        // Keep the sparsity pattern of the previous assembly
+        if ( m_options.askSwitch("FixedPattern", false) &&
+             m_matrix.isCompressed() && 0 != m_matrix.nonZeros() &&
+             m_matrix.rows() == numTestDofs() && m_matrix.cols() == numDofs() )
+        {
+            std::fill(m_matrix.valuePtr(),
+                      m_matrix.valuePtr() + m_matrix.nonZeros(), T(0));
+            return;
+        }
+
         m_matrix = gsSparseMatrix<T>(numTestDofs(), numDofs());
 
         if ( 0 == m_matrix.rows() || 0 == m_matrix.cols() )
@@ -446,11 +462,35 @@ private:
                                 space rvar, space cvar,
                                 const ifContainer & iFaces);
 
+    /// Accumulates the expressions over the (\a numEl many) elements
+    /// of patch \a patchInd, or of its side \a side. To be called by
+    /// all threads of a parallel region, the elements are then shared
+    /// among the threads.
+#if __cplusplus >= 201103L || _MSC_VER >= 1600 // c++11
+    template<class... expr>
+    void _elementLoop(const index_t patchInd, const boxSide side,
+                      const index_t numEl, expr... args);
+#else
+    template <class E1, class E2, class E3, class E4, class E5>
+    void _elementLoop(const index_t patchInd, const boxSide side,
+                      const index_t numEl, E1 a1, E2 a2, E3 a3, E4 a4, E5 a5);
+#endif
+
+    /// Returns the number of elements of \a basis on side \a side
+    /// (or all elements, for boundary::none)
+    static index_t _numElements(const gsBasis<T> & basis, const boxSide side)
+    {
+        index_t numEl = 0;
+        typename gsBasis<T>::domainIter domIt = basis.makeDomainIterator(side);
+        for (; domIt->good(); domIt->next() ) ++numEl;
+        return numEl;
+    }
+
 #if __cplusplus >= 201103L || _MSC_VER >= 1600 // c++11
     template <class op, class E1>
-    void _apply(op _op, const expr::_expr<E1> & firstArg) {_op(firstArg);}
+    void _apply(op & _op, const expr::_expr<E1> & firstArg) {_op(firstArg);}
     template <class op, class E1, class... Rest>
-    void _apply(op _op, const expr::_expr<E1> & firstArg, Rest... restArgs)
+    void _apply(op & _op, const expr::_expr<E1> & firstArg, Rest... restArgs)
     { _op(firstArg); _apply<op>(_op, restArgs...); }
 #endif
 
@@ -474,30 +514,46 @@ private:
         gsMatrix<T>       & m_rhs;
         const gsVector<T> & m_quWeights;
         index_t       m_patchInd;
-        gsMatrix<T>         localMat;
+
+        // Local matrix of one expression on the current element,
+        // kept until flush() accumulates it to the global system
+        struct _localBlock
+        {
+            gsMatrix<T> mat;
+            const expr::gsFeSpace<T> * rowVar;
+            const expr::gsFeSpace<T> * colVar;
+            bool isMatrix;
+        };
+        std::vector<_localBlock> m_blocks;
+        size_t                   m_nBlocks;
 
         _eval(gsSparseMatrix<T> & _matrix,
               gsMatrix<T>       & _rhs,
               const gsVector<>  & _quWeights)
         : m_matrix(_matrix), m_rhs(_rhs),
-          m_quWeights(_quWeights), m_patchInd(0)
+          m_quWeights(_quWeights), m_patchInd(0), m_nBlocks(0)
         { }
 
         void setPatch(const index_t p) { m_patchInd=p; }
 
         template <typename E> void operator() (const gismo::expr::_expr<E> & ee)
         {
+            if (m_nBlocks == m_blocks.size())
+                m_blocks.push_back(_localBlock());
+            _localBlock & lb = m_blocks[m_nBlocks++];
+
             // ------- Compute  -------
             const T * w = m_quWeights.data();
-            localMat.noalias() = (*w) * ee.eval(0);
+            lb.mat.noalias() = (*w) * ee.eval(0);
             for (index_t k = 1; k != m_quWeights.rows(); ++k)
-                localMat.noalias() += (*(++w)) * ee.eval(k);
+                lb.mat.noalias() += (*(++w)) * ee.eval(k);
 
-            //  ------- Accumulate  -------
+            lb.rowVar = &ee.rowVar();
+            lb.colVar = &ee.colVar();
             if (E::isMatrix())
-                push<true>(ee.rowVar(), ee.colVar(), m_patchInd);
+                lb.isMatrix = true;
             else if (E::isVector())
-                push<false>(ee.rowVar(), ee.colVar(), m_patchInd);
+                lb.isMatrix = false;
             else
             {
                 GISMO_ERROR("Something went wrong at this point (rowspan: "<< E::rowSpan<< ", colSpan: "<< E::colSpan <<")");
@@ -508,8 +564,24 @@ private:
 
         void operator() (const expr::_expr<expr::gsNullExpr<T> > &) {}
 
+        /// Accumulates the local matrices computed since the last
+        /// call, in the order of evaluation
+        void flush()
+        {
+            for (size_t b = 0; b != m_nBlocks; ++b)
+            {
+                const _localBlock & lb = m_blocks[b];
+                if (lb.isMatrix)
+                    push<true >(*lb.rowVar, *lb.colVar, lb.mat, m_patchInd);
+                else
+                    push<false>(*lb.rowVar, *lb.colVar, lb.mat, m_patchInd);
+            }
+            m_nBlocks = 0;
+        }
+
         template<bool isMatrix> void push(const expr::gsFeSpace<T> & v,
                                           const expr::gsFeSpace<T> & u,
+                                          const gsMatrix<T> & localMat,
                                           const index_t patchInd)
         {
             GISMO_ASSERT(v.isValid(), "The row space is not valid");
@@ -520,8 +592,9 @@ private:
             const index_t rd            = v.dim();
             const gsDofMapper  & colMap = u.mapper();
             const gsDofMapper  & rowMap = v.mapper();
-            gsMatrix<index_t> & colInd0 = const_cast<gsMatrix<index_t>&>(u.data().actives);
             gsMatrix<index_t> & rowInd0 = const_cast<gsMatrix<index_t>&>(v.data().actives);
+            gsMatrix<index_t> & colInd0 = isMatrix ?
+                const_cast<gsMatrix<index_t>&>(u.data().actives) : rowInd0;
             const gsMatrix<T>  & fixedDofs = u.fixedPart();
 
             gsMatrix<index_t> rowInd, colInd;
@@ -593,6 +666,8 @@ gsOptionList gsExprAssembler<T>::defaultOptions()
     opt.addReal("bdA", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 2.0  );
     opt.addInt ("bdB", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 1    );
     opt.addReal("bdO", "Overhead of sparse mem. allocation: (1+bdO)(bdA*deg + bdB) [0..1]", 0.333);
+    opt.addSwitch("Parallel", "Assemble the elements of each patch concurrently (requires OpenMP). The result does not depend on the number of threads.", false);
+    opt.addSwitch("FixedPattern", "Keep the sparsity pattern of the matrix in initMatrix() if the dimensions did not change; only the values are set to zero", false);
     return opt;
 }
 
@@ -743,51 +818,61 @@ template<class T> void gsExprAssembler<T>::resetDimensions()
 template<class T>
 #if(__cplusplus >= 201103L || _MSC_VER >= 1600 || defined(__DOXYGEN__)) // c++11
 template<class... expr>
-void gsExprAssembler<T>::assemble(expr... args)
+void gsExprAssembler<T>::_elementLoop(const index_t patchInd, const boxSide side,
+                                      const index_t numEl, expr... args)
 #else
-    template <class E1, class E2, class E3, class E4, class E5>
-    void gsExprAssembler<T>::assemble( const expr::_expr<E1> & a1, const expr::_expr<E2> & a2,
-    const expr::_expr<E3> & a3, const expr::_expr<E4> & a4, const expr::_expr<E5> & a5)
+template <class E1, class E2, class E3, class E4, class E5>
+void gsExprAssembler<T>::_elementLoop(const index_t patchInd, const boxSide side,
+                                      const index_t numEl, E1 a1, E2 a2, E3 a3, E4 a4, E5 a5)
 #endif
 {
-    GISMO_ASSERT(matrix().cols()==numDofs(), "System not initialized");
+    // Note: this is executed by every thread of the enclosing
+    // parallel region, the arguments are thread-private copies of the
+    // expressions and the evaluation data in m_exprdata is
+    // thread-private as well
 
     // initialize flags
     m_exprdata->initFlags(SAME_ELEMENT|NEED_ACTIVE, SAME_ELEMENT);
 #   if __cplusplus >= 201103L || _MSC_VER >= 1600
     _apply(_setFlag, args...);
-    //_apply(_printExpr, args...);
 #   else
-    _setFlag(a1);_setFlag(a1);_setFlag(a2);_setFlag(a4);_setFlag(a5);
+    _setFlag(a1);_setFlag(a2);_setFlag(a3);_setFlag(a4);_setFlag(a5);
 #   endif
-    typename gsQuadRule<T>::uPtr QuRule;
+    m_exprdata->mapData.mine().side = side;
+
+    const gsBasis<T> & basis = m_exprdata->multiBasis().basis(patchInd);
+    typename gsQuadRule<T>::uPtr QuRule = ( boundary::none == side ?
+        gsQuadrature::getPtr(basis, m_options) :
+        gsQuadrature::getPtr(basis, m_options, side.direction()) );
     gsVector<T> quWeights; // quadrature weights
 
     _eval ee(m_matrix, m_rhs, quWeights);
+    ee.setPatch(patchInd);
 
-    for (unsigned patchInd = 0; patchInd < m_exprdata->multiBasis().nBases(); ++patchInd)
-    {
-        ee.setPatch(patchInd);
-        QuRule = gsQuadrature::getPtr(m_exprdata->multiBasis().basis(patchInd), m_options);
+    // Initialize domain element iterator
+    typename gsBasis<T>::domainIter domIt = basis.makeDomainIterator(side);
+    m_element.set(*domIt);
 
-        // Initialize domain element iterator for current patch
-        typename gsBasis<T>::domainIter domIt =  // add patchInd to domainiter ?
-            m_exprdata->multiBasis().basis(patchInd).makeDomainIterator();
-        m_element.set(*domIt);
-
-        // Start iteration over elements of patchInd
-        for (; domIt->good(); domIt->next() )
-        {
-            // Map the Quadrature rule to the element
-            QuRule->mapTo( domIt->lowerCorner(), domIt->upperCorner(),
-                           m_exprdata->points(), quWeights);
+#   ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+    const int nt  = omp_get_num_threads();
+    domIt->next(tid);
+#   endif
 
-            if (m_exprdata->points().cols()==0)
-                continue;
+    // Element el is handled by thread el%nt, and the local matrices
+    // are added to the system in the element order, therefore the
+    // result is the same as the one of the sequential loop
+#   pragma omp for ordered schedule(static,1)
+    for (index_t el = 0; el < numEl; ++el)
+    {
+        // Map the Quadrature rule to the element
+        QuRule->mapTo( domIt->lowerCorner(), domIt->upperCorner(),
+                       m_exprdata->points(), quWeights);
 
+        if (0!=m_exprdata->points().cols())
+        {
             // Perform required pre-computations on the quadrature nodes
             m_exprdata->precompute(patchInd);
-            //m_exprdata->precompute(QuRule, *domIt); // todo
 
             // Assemble contributions of the element
 #           if __cplusplus >= 201103L || _MSC_VER >= 1600
@@ -796,6 +881,44 @@ void gsExprAssembler<T>::assemble(expr... args)
             ee(a1);ee(a2);ee(a3);ee(a4);ee(a5);
 #           endif
         }
+
+        // Push to global matrix and right-hand side vector
+#       pragma omp ordered
+        ee.flush();
+
+#       ifdef _OPENMP
+        domIt->next(nt);
+#       else
+        domIt->next();
+#       endif
+    }
+}
+
+template<class T>
+#if(__cplusplus >= 201103L || _MSC_VER >= 1600 || defined(__DOXYGEN__)) // c++11
+template<class... expr>
+void gsExprAssembler<T>::assemble(expr... args)
+#else
+    template <class E1, class E2, class E3, class E4, class E5>
+    void gsExprAssembler<T>::assemble( const expr::_expr<E1> & a1, const expr::_expr<E2> & a2,
+    const expr::_expr<E3> & a3, const expr::_expr<E4> & a4, const expr::_expr<E5> & a5)
+#endif
+{
+    GISMO_ASSERT(matrix().cols()==numDofs(), "System not initialized");
+
+    for (unsigned patchInd = 0; patchInd < m_exprdata->multiBasis().nBases(); ++patchInd)
+    {
+        const index_t numEl = _numElements(m_exprdata->multiBasis().basis(patchInd),
+                                           boundary::none);
+#       if __cplusplus >= 201103L || _MSC_VER >= 1600
+#       pragma omp parallel if(m_options.askSwitch("Parallel", false))
+        _elementLoop(patchInd, boundary::none, numEl, args...);
+#       else
+#       pragma omp parallel if(m_options.askSwitch("Parallel", false))
+        _elementLoop(patchInd, boundary::none, numEl, static_cast<const E1&>(a1),
+                     static_cast<const E2&>(a2), static_cast<const E3&>(a3),
+                     static_cast<const E4&>(a4), static_cast<const E5&>(a5));
+#       endif
     }
 
     m_matrix.makeCompressed();
@@ -810,54 +933,24 @@ template <class E1>
 void gsExprAssembler<T>::assemble(const bcRefList & BCs, const expr::_expr<E1> & a1)
 #endif
 {
-    // initialize flags
-    m_exprdata->initFlags(SAME_ELEMENT|NEED_ACTIVE, SAME_ELEMENT);
-#   if __cplusplus >= 201103L || _MSC_VER >= 1600
-    _apply(_setFlag, args...);
-#   else
-    _setFlag(a1);
-#   endif
-
-    gsVector<T> quWeights;// quadrature weights
-    typename gsQuadRule<T>::uPtr QuRule;
-
-    _eval ee(m_matrix, m_rhs, quWeights);
-
     for (typename bcRefList::const_iterator iit = BCs.begin(); iit!= BCs.end(); ++iit)
     {
         const boundary_condition<T> * it = &iit->get();
 
-        QuRule = gsQuadrature::getPtr(m_exprdata->multiBasis().basis(it->patch()), m_options, it->side().direction());
-        m_exprdata->mapData.side = it->side();
-
         // Update boundary function source
         m_exprdata->setMutSource(*it->function(), it->parametric());
         //mutVar.registerVariable(func, mutData);
 
-        typename gsBasis<T>::domainIter domIt =
-            m_exprdata->multiBasis().basis(it->patch()).makeDomainIterator(it->side());
-        m_element.set(*domIt);
-
-        // Start iteration over elements
-        for (; domIt->good(); domIt->next() )
-        {
-            // Map the Quadrature rule to the element
-            QuRule->mapTo( domIt->lowerCorner(), domIt->upperCorner(),
-                           m_exprdata->points(), quWeights);
-
-            if (m_exprdata->points().cols()==0)
-                continue;
-
-            // Perform required pre-computations on the quadrature nodes
-            m_exprdata->precompute(it->patch());
-
-            // Assemble contributions of the element
-#           if __cplusplus >= 201103L || _MSC_VER >= 1600
-            _apply(ee, args...);
-#           else
-            ee(a1);
-#           endif
-        }
+        const index_t numEl = _numElements(m_exprdata->multiBasis().basis(it->patch()),
+                                           it->side());
+#       if __cplusplus >= 201103L || _MSC_VER >= 1600
+#       pragma omp parallel if(m_options.askSwitch("Parallel", false))
+        _elementLoop(it->patch(), it->side(), numEl, args...);
+#       else
+#       pragma omp parallel if(m_options.askSwitch("Parallel", false))
+        _elementLoop(it->patch(), it->side(), numEl, static_cast<const E1&>(a1),
+                     nullExpr(), nullExpr(), nullExpr(), nullExpr());
+#       endif
     }
 
     //this->finalize();
@@ -876,46 +969,24 @@ void gsExprAssembler<T>::assembleLhsRhsBc_impl(const expr::_expr<E1> & exprLhs,
 {
     //GISMO_ASSERT( exprRhs.isVector(), "Expecting vector expression");
 
-    // initialize flags
-    m_exprdata->initFlags(SAME_ELEMENT|NEED_ACTIVE, SAME_ELEMENT);
-    if (left ) exprLhs.setFlag();
-    if (right) exprRhs.setFlag();
-
-    gsVector<T> quWeights;// quadrature weights
-    typename gsQuadRule<T>::uPtr QuRule;
-    _eval ee(m_matrix, m_rhs, quWeights);
-
     for (typename bcContainer::const_iterator it = BCs.begin(); it!= BCs.end(); ++it)
     {
-        QuRule = gsQuadrature::getPtr(m_exprdata->multiBasis().basis(it->patch()), m_options, it->side().direction());
-
-        m_exprdata->mapData.side = it->side();
-
         // Update boundary function source
         m_exprdata->setMutSource(*it->function(), it->parametric());
         //mutVar.registerVariable(func, mutData);
 
-        typename gsBasis<T>::domainIter domIt =
-            m_exprdata->multiBasis().basis(it->patch()).makeDomainIterator(it->side());
-        m_element.set(*domIt);
-
-        // Start iteration over elements
-        for (; domIt->good(); domIt->next() )
-        {
-            // Map the Quadrature rule to the element
-            QuRule->mapTo( domIt->lowerCorner(), domIt->upperCorner(),
-                           m_exprdata->points(), quWeights);
-
-            if (m_exprdata->points().cols()==0)
-                continue;
-
-            // Perform required pre-computations on the quadrature nodes
-            m_exprdata->precompute(it->patch());
-
-            ee.setPatch(it->patch());
-    	    ee(exprLhs);
-	        ee(exprRhs);
-        }
+        const index_t numEl = _numElements(m_exprdata->multiBasis().basis(it->patch()),
+                                           it->side());
+#       if __cplusplus >= 201103L || _MSC_VER >= 1600
+#       pragma omp parallel if(m_options.askSwitch("Parallel", false))
+        _elementLoop(it->patch(), it->side(), numEl,
+                     static_cast<const E1&>(exprLhs), static_cast<const E2&>(exprRhs));
+#       else
+#       pragma omp parallel if(m_options.askSwitch("Parallel", false))
+        _elementLoop(it->patch(), it->side(), numEl,
+                     static_cast<const E1&>(exprLhs), static_cast<const E2&>(exprRhs),
+                     nullExpr(), nullExpr(), nullExpr());
+#       endif
     }
 
     //this->finalize();
@@ -933,20 +1004,9 @@ void gsExprAssembler<T>::assembleInterface_impl(const expr::_expr<E1> & exprLhs,
 {
     //GISMO_ASSERT( exprRhs.isVector(), "Expecting vector expression");
 
-    // initialize flags
-
-    m_exprdata->initFlags(SAME_ELEMENT|NEED_ACTIVE, SAME_ELEMENT);
-    if (left ) exprLhs.setFlag();
-    if (right) exprRhs.setFlag();
     //m_exprdata->parse(exprLhs,exprRhs);
     //m_exprdata->parse(exprRhs);
 
-    gsVector<T> quWeights;// quadrature weights
-    typename gsQuadRule<T>::uPtr QuRule;
-    _eval ee(m_matrix, m_rhs, quWeights);
-
-    //gsMatrix<T> tmp;
-
     for (gsBoxTopology::const_iiterator it = iFaces.begin();
          it != iFaces.end(); ++it )
     {
@@ -955,39 +1015,21 @@ void gsExprAssembler<T>::assembleInterface_impl(const expr::_expr<E1> & exprLhs,
         //const index_t patch2 = iFace.second().patch;
         //const gsAffineFunction<T> interfaceMap(m_pde_ptr->patches().getMapForInterface(bi));
 
-        QuRule = gsQuadrature::getPtr(m_exprdata->multiBasis().basis(patch1),
-                                   m_options, iFace.first().side().direction());
-
-        m_exprdata->mapData.side = iFace.first().side(); // (!)
-
-        typename gsBasis<T>::domainIter domIt =
-            m_exprdata->multiBasis().basis(patch1).makeDomainIterator(iFace.first().side());
-        m_element.set(*domIt);
-
-        // Start iteration over elements
-        for (; domIt->good(); domIt->next() )
-        {
-            // Map the Quadrature rule to the element
-            QuRule->mapTo( domIt->lowerCorner(), domIt->upperCorner(),
-                           m_exprdata->points(), quWeights);
-
-            if (m_exprdata->points().cols()==0)
-                continue;
-
-            // Perform required pre-computations on the quadrature nodes
-            m_exprdata->precompute(patch1);
-
-            // DG: need data1, data2
-            // coupling: need to know patch1/patch2
-
-//            interfaceMap.eval_into(m_exprdata->points(), tmp);
-//            m_exprdata->points().swap(tmp);
-//            m_exprdata->precompute(patch2);
-
-        ee.setPatch(patch1);
-	    ee(exprLhs);
-	    ee(exprRhs);
-        }
+        // DG: need data1, data2
+        // coupling: need to know patch1/patch2
+
+        const index_t numEl = _numElements(m_exprdata->multiBasis().basis(patch1),
+                                           iFace.first().side());
+#       if __cplusplus >= 201103L || _MSC_VER >= 1600
+#       pragma omp parallel if(m_options.askSwitch("Parallel", false))
+        _elementLoop(patch1, iFace.first().side(), numEl,
+                     static_cast<const E1&>(exprLhs), static_cast<const E2&>(exprRhs));
+#       else
+#       pragma omp parallel if(m_options.askSwitch("Parallel", false))
+        _elementLoop(patch1, iFace.first().side(), numEl,
+                     static_cast<const E1&>(exprLhs), static_cast<const E2&>(exprRhs),
+                     nullExpr(), nullExpr(), nullExpr());
+#       endif
     }
 
     m_matrix.makeCompressed();
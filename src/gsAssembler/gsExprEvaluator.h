@@ -399,7 +399,7 @@ T gsExprEvaluator<T>::computeBdr_impl(const expr::_expr<E> & expr)
     {
         // Quadrature rule
         QuRule = gsQuadrature::get(m_exprdata->multiBasis().basis(bit->patch), m_options,bit->direction());
-        m_exprdata->mapData.side = bit->side();
+        m_exprdata->mapData.mine().side = bit->side();
 
         // Initialize domain element iterator
         typename gsBasis<T>::domainIter domIt =
@@ -460,7 +460,7 @@ T gsExprEvaluator<T>::computeInterface_impl(const expr::_expr<E> & expr, const i
         QuRule = gsQuadrature::get(m_exprdata->multiBasis().basis(patch1),
                                    m_options, iFace.first().side().direction());
 
-        m_exprdata->mapData.side = iFace.first().side();
+        m_exprdata->mapData.mine().side = iFace.first().side();
 
         // Initialize domain element iterator
         typename gsBasis<T>::domainIter domIt =
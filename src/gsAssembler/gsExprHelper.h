@@ -19,6 +19,11 @@ namespace gismo
 {
 /**
    Class holding an expression environment
+
+   All evaluation data (function data, mapping data) is kept once per
+   thread, so that several threads can precompute and evaluate the
+   same expressions on different elements concurrently. Each thread
+   only sees (and sets flags on) its own copy.
  */
 template<class T>
 class gsExprHelper
@@ -30,7 +35,9 @@ private:
     { mutVar.setData(mutData); }
 
 private:
-    typedef std::map<const gsFunctionSet<T>*,gsFuncData<T> > FunctionTable;
+    typedef util::gsThreaded<gsFuncData<T> > thFuncData;
+    typedef util::gsThreaded<gsMapData<T> >  thMapData;
+    typedef std::map<const gsFunctionSet<T>*,thFuncData> FunctionTable;
     typedef typename FunctionTable::iterator ftIterator;
     typedef typename FunctionTable::const_iterator const_ftIterator;
     typedef std::deque<gsDofMapper>    DofMappers;
@@ -50,13 +57,13 @@ private:
     // geometry map
     expr::gsGeometryMap<T> mapVar, mapVar2;
 public:
-    gsMapData<T> mapData, mapData2;
+    thMapData mapData, mapData2;
 private:
 
     // mutable pair of variable and data,
     // ie. not uniquely assigned to a gsFunctionSet
     expr::gsFeVariable<T> mutVar ;
-    gsFuncData<T>         mutData;
+    thFuncData            mutData;
     bool mutParametric;
 
     gsSortedVector<const gsFunctionSet<T>*> evList;
@@ -77,7 +84,8 @@ public:
     typedef memory::shared_ptr<gsExprHelper>  Ptr;
 public:
 
-    gsMatrix<T> & points() { return mapData.points; }
+    /// Returns the evaluation points of the calling thread
+    gsMatrix<T> & points() { return mapData.mine().points; }
 
     static uPtr make() { return uPtr(new gsExprHelper()); }
 
@@ -104,7 +112,7 @@ public:
             gsInfo << "mapVar2: "<< &mapData2 <<"\n";
         }
 
-        if ( mutVar.isValid() && 0!=mutData.flags)
+        if ( mutVar.isValid() && 0!=mutData.mine().flags)
         {
             gsInfo << "mutVar: "<< &mutVar <<"\n";
         }
@@ -130,15 +138,15 @@ public:
 
     void cleanUp()
     {
-        mapData.clear();
-        mapData2.clear();
-        mutData.clear();
+        mapData.mine().clear();
+        mapData2.mine().clear();
+        mutData.mine().clear();
         for (ftIterator it = m_ptable.begin(); it != m_ptable.end(); ++it)
-            it->second.clear();
+            it->second.mine().clear();
         for (ftIterator it = m_itable.begin(); it != m_itable.end(); ++it)
-            it->second.clear();
+            it->second.mine().clear();
         for (ftIterator it = m_stable.begin(); it != m_stable.end(); ++it)
-            it->second.clear();
+            it->second.mine().clear();
     }
 
     void clean(bool space=false)
@@ -210,7 +218,7 @@ public:
         // todo: static dispatch for ScalarValued
         m_vlist.push_back( expr::gsFeVariable<T>() );
         expr::gsFeVariable<T> & var = m_vlist.back();
-        gsFuncData<T> & fd = m_ptable[&mp];
+        thFuncData & fd = m_ptable[&mp];
         //fd.dim = mp.dimensions();
         //gsDebugVar(&fd);
         var.registerData(mp, fd, dim);
@@ -223,7 +231,7 @@ public:
         GISMO_ASSERT(&G==&mapVar, "geometry map not known");
         m_vlist.push_back( expr::gsFeVariable<T>() );
         expr::gsFeVariable<T> & var = m_vlist.back();
-        gsFuncData<T> & fd = m_itable[&mp];
+        thFuncData & fd = m_itable[&mp];
         //fd.dim = mp.dimensions();
         //gsDebugVar(&fd);
         var.registerData(mp, fd, 1, mapData);
@@ -251,7 +259,7 @@ public:
     {
         m_slist.push_back( expr::gsFeSpace<T>() );
         expr::gsFeSpace<T> & var = m_slist.back();
-        gsFuncData<T> & fd = m_stable[&mp];
+        thFuncData & fd = m_stable[&mp];
         //fd.dim = mp.dimensions();
         var.registerData(mp, fd, dim);
         return var;
@@ -296,18 +304,19 @@ public:
         // todo: varlist ?
     }
 
+    /// Resets the evaluation flags of the calling thread
     void initFlags(const unsigned fflag = 0,
                    const unsigned mflag = 0)
     {
-        mapData.flags = mflag | NEED_ACTIVE;
-        mapData2.flags = mflag | NEED_ACTIVE;
-        mutData.flags = fflag | NEED_ACTIVE;
+        mapData.mine().flags = mflag | NEED_ACTIVE;
+        mapData2.mine().flags = mflag | NEED_ACTIVE;
+        mutData.mine().flags = fflag | NEED_ACTIVE;
         for (ftIterator it = m_ptable.begin(); it != m_ptable.end(); ++it)
-            it->second.flags = fflag | NEED_ACTIVE;
+            it->second.mine().flags = fflag | NEED_ACTIVE;
         for (ftIterator it = m_itable.begin(); it != m_itable.end(); ++it)
-            it->second.flags = fflag | NEED_ACTIVE;
+            it->second.mine().flags = fflag | NEED_ACTIVE;
         for (ftIterator it = m_stable.begin(); it != m_stable.end(); ++it)
-            it->second.flags = fflag | NEED_ACTIVE;
+            it->second.mine().flags = fflag | NEED_ACTIVE;
     }
 
     template<class Expr> // to remove
@@ -325,10 +334,16 @@ public:
 
     //void precompute(const gsMatrix<T> & points, const index_t patchIndex = 0)
 
+    /// Computes the evaluation data of the calling thread on its
+    /// current points()
     void precompute(const index_t patchIndex = 0)
     {
         GISMO_ASSERT(0!=points().size(), "No points");
 
+        gsMapData<T> & mapData  = this->mapData.mine();
+        gsMapData<T> & mapData2 = this->mapData2.mine();
+        gsFuncData<T> & mutData = this->mutData.mine();
+
         //mapData.side
         if ( mapVar.isValid() ) // list ?
         {
@@ -358,14 +373,14 @@ public:
         // Parametric Variables
         for (ftIterator it = m_ptable.begin(); it != m_ptable.end(); ++it)
         {
-            it->first->piece(patchIndex).compute(mapData.points, it->second); // ! piece(.) ?
-            it->second.patchId = patchIndex;
+            it->first->piece(patchIndex).compute(mapData.points, it->second.mine()); // ! piece(.) ?
+            it->second.mine().patchId = patchIndex;
         }
         // Spaces
         for (ftIterator it = m_stable.begin(); it != m_stable.end(); ++it)
         {
-            it->first->piece(patchIndex).compute(mapData.points, it->second); // ! piece(.) ?
-            it->second.patchId = patchIndex;
+            it->first->piece(patchIndex).compute(mapData.points, it->second.mine()); // ! piece(.) ?
+            it->second.mine().patchId = patchIndex;
         }
 
         GISMO_ASSERT( m_itable.empty() || 0!=mapData.values.size(), "Map values not computed");
@@ -375,9 +390,9 @@ public:
         {
             //gsDebugVar(&it->second);
             //gsDebugVar(it->second.dim.first);
-            it->first->piece(patchIndex).compute(mapData.values[0], it->second);
+            it->first->piece(patchIndex).compute(mapData.values[0], it->second.mine());
             //gsDebugVar(it->second.dim.first);
-            it->second.patchId = patchIndex;
+            it->second.mine().patchId = patchIndex;
         }
     }
 
@@ -15,6 +15,7 @@
 
 #include <gsCore/gsFuncData.h>
 #include <gsUtils/gsSortedVector.h>
+#include <gsUtils/gsThreaded.h>
 #include <gsAssembler/gsDirichletValues.h>
 
 namespace gismo
@@ -349,9 +350,9 @@ public:
 protected:
     //const gsFuncData<Scalar>    * m_fd2; // more data when needed
     const gsFunctionSet<Scalar> * m_fs; ///< Evaluation source for this FE variable
-    const gsFuncData<Scalar>    * m_fd; ///< Temporary variable storing flags and evaluation data
+    const util::gsThreaded<gsFuncData<Scalar> > * m_fd; ///< Temporary variable storing flags and evaluation data (one per thread)
     index_t m_d;                   ///< Dimension of this (scalar or vector) variable
-    const gsMapData<Scalar>     * m_md; ///< If set, the variable is composed with a geometry map
+    const util::gsThreaded<gsMapData<Scalar> >  * m_md; ///< If set, the variable is composed with a geometry map
     // comp(u,G)
 
 public:
@@ -361,21 +362,21 @@ public:
     /// Returns the function source
     const gsFunctionSet<Scalar> & source() const {return *m_fs;}
 
-    /// Returns the function data
-    const gsFuncData<Scalar> & data() const {return *m_fd;}
+    /// Returns the function data of the calling thread
+    const gsFuncData<Scalar> & data() const {return m_fd->mine();}
 
-    /// Returns the mapping data (precondition: composed()==true)
-    const gsMapData<Scalar> & mapData() const {return *m_md;}
+    /// Returns the mapping data of the calling thread (precondition: composed()==true)
+    const gsMapData<Scalar> & mapData() const {return m_md->mine();}
 
     /// Returns true if the variable is a composition
     bool composed() const {return NULL!=m_md;}
 
-    index_t cardinality_impl() const { return m_d * m_fd->actives.rows(); }
+    index_t cardinality_impl() const { return m_d * data().actives.rows(); }
 
 private:
 
     void setSource(const gsFunctionSet<Scalar> & fs) { m_fs = &fs;}
-    void setData(const gsFuncData<Scalar> & val) { m_fd = &val;}
+    void setData(const util::gsThreaded<gsFuncData<Scalar> > & val) { m_fd = &val;}
     void clear() { m_fs = NULL; }
     // gsFuncData<Scalar> & data() {return *m_fd;}
     // gsMapData<Scalar> & mapData() {return *m_md;}
@@ -384,7 +385,8 @@ protected:
 
     explicit symbol_expr(index_t _d) : m_fs(NULL), m_fd(NULL), m_d(_d), m_md(NULL) { }
 
-    void registerData(const gsFunctionSet<Scalar> & fs, const gsFuncData<Scalar> & val, index_t d)
+    void registerData(const gsFunctionSet<Scalar> & fs,
+                      const util::gsThreaded<gsFuncData<Scalar> > & val, index_t d)
     {
         GISMO_ASSERT(NULL==m_fs, "gsFeVariable: already registered");
         m_fs = &fs ;
@@ -393,8 +395,9 @@ protected:
         m_md = NULL;
     }
 
-    void registerData(const gsFunctionSet<Scalar> & fs, const gsFuncData<Scalar> & val, index_t d,
-                      const gsMapData<Scalar> & md)
+    void registerData(const gsFunctionSet<Scalar> & fs,
+                      const util::gsThreaded<gsFuncData<Scalar> > & val, index_t d,
+                      const util::gsThreaded<gsMapData<Scalar> > & md)
     {
         registerData(fs,val,d);
         m_md  = &md;
@@ -412,7 +415,7 @@ public:
     // The evaluation return rows for (basis) functions and columns
     // for (coordinate) components
     MatExprType eval(const index_t k) const
-    { return m_fd->values[0].col(k).blockDiag(m_d); } //!!
+    { return data().values[0].col(k).blockDiag(m_d); } //!!
     //{ return m_fd->values[0].col(k); }
 
     const gsFeSpace<Scalar> & rowVar() const {return gsNullExpr<Scalar>::get();}
@@ -450,16 +453,16 @@ public:
     void setFlag() const
     {
         GISMO_ASSERT(NULL!=m_fd, "FeVariable: FuncData member not registered");
-        m_fd->flags |= NEED_VALUE | NEED_ACTIVE;
-        if (NULL!=m_md) m_md->flags |= NEED_VALUE;
+        data().flags |= NEED_VALUE | NEED_ACTIVE;
+        if (NULL!=m_md) mapData().flags |= NEED_VALUE;
     }
 
     void parse(gsSortedVector<const gsFunctionSet<Scalar>*> & evList) const
     {
         GISMO_ASSERT(NULL!=m_fd, "FeVariable: FuncData member not registered");
         evList.push_sorted_unique(m_fs);
-        m_fd->flags |= NEED_VALUE;
-        if (NULL!=m_md) m_md->flags |= NEED_VALUE;
+        data().flags |= NEED_VALUE;
+        if (NULL!=m_md) mapData().flags |= NEED_VALUE;
     }
 
     void print(std::ostream &os) const { os << "u"; }
@@ -481,8 +484,8 @@ public:
 
     index_t cSize()  const
     {
-        GISMO_ASSERT(0!=m_fd->values[0].size(),"Probable error.");
-        return m_fd->values[0].rows();
+        GISMO_ASSERT(0!=data().values[0].size(),"Probable error.");
+        return data().values[0].rows();
     } // coordinate size
 };
 
@@ -557,7 +560,7 @@ template<class T>
 class gsGeometryMap : public _expr<gsGeometryMap<T> >
 {
     const gsFunctionSet<T> * m_fs; ///< Evaluation source for this geometry map
-    const gsMapData<T> *  m_fd;    ///< Temporary variable storing flags and evaluation data
+    const util::gsThreaded<gsMapData<T> > * m_fd; ///< Temporary variable storing flags and evaluation data (one per thread)
     //index_t d, n;
 
 public:
@@ -567,8 +570,8 @@ public:
     /// Returns the function source
     const gsFunctionSet<T> & source() const {return *m_fs;}
 
-    /// Returns the function data
-    const gsMapData<T> & data() const  { return *m_fd; }
+    /// Returns the function data of the calling thread
+    const gsMapData<T> & data() const  { return m_fd->mine(); }
 
     index_t targetDim() const { return m_fs->targetDim();}
 public:
@@ -578,12 +581,12 @@ public:
 
     void print(std::ostream &os) const { os << "G"; }
 
-    MatExprType eval(const index_t k) const { return m_fd->values[0].col(k); }
+    MatExprType eval(const index_t k) const { return data().values[0].col(k); }
 
     void setFlag() const
     {
         GISMO_ASSERT(NULL!=m_fd, "GeometryMap not registered");
-        m_fd->flags |= NEED_VALUE;
+        data().flags |= NEED_VALUE;
     }
 
 protected:
@@ -591,7 +594,7 @@ protected:
     gsGeometryMap() : m_fs(NULL), m_fd(NULL) { }
 
     /// Registers the source function and evaluation data
-    void registerData(const gsFunctionSet<T> & fs, const gsMapData<T> & val)
+    void registerData(const gsFunctionSet<T> & fs, const util::gsThreaded<gsMapData<T> > & val)
     {
         m_fs = &fs;
         m_fd = &val;
@@ -602,7 +605,7 @@ public:
     /// Returns true iff the source function has been set
     bool isValid() const { return NULL!=m_fs; }
 
-    index_t rows() const { return m_fd->dim.second; }
+    index_t rows() const { return data().dim.second; }
     index_t cols() const { return 1; }
 
     enum{rowSpan = 0, colSpan = 0};
@@ -614,7 +617,7 @@ public:
     {
         GISMO_ASSERT(NULL!=m_fd, "GeometryMap not registered");
         evList.push_unique(m_fs);
-        m_fd->flags |= NEED_VALUE;
+        data().flags |= NEED_VALUE;
     }
 };
 
@@ -633,16 +636,17 @@ class gsFeElement
 {
     friend class cdiam_expr<T>;
 
-    const gsDomainIterator<T> * m_di; ///< Pointer to the domain iterator
+    util::gsThreaded<const gsDomainIterator<T> *> m_di; ///< Pointer to the domain iterator (one per thread)
 
     cdiam_expr<T> cd;
 public:
     typedef T Scalar;
 
-    gsFeElement() : m_di(NULL), cd(*this) { }
+    gsFeElement() : cd(*this) { m_di.mine() = NULL; }
 
+    /// Sets the domain iterator of the calling thread
     void set(const gsDomainIterator<T> & di)
-    { m_di = &di; }
+    { m_di.mine() = &di; }
 
     /// The diameter of the element
     const cdiam_expr<T> & diam() const
@@ -669,7 +673,7 @@ public:
 
     explicit cdiam_expr(const gsFeElement<T> & el) : _e(el) { }
 
-    T eval(const index_t ) const { return _e.m_di->getCellSize(); }
+    T eval(const index_t ) const { return _e.m_di.mine()->getCellSize(); }
 
     inline cdiam_expr<T> val() const { return *this; }
     inline index_t rows() const { return 0; }
@@ -1156,8 +1160,8 @@ public:
     inline const gsMatrix<T> & fixedPart() const {return _u.m_fixedDofs;}
     gsMatrix<T> & fixedPart() {return _u.m_fixedDofs;}
 
-    gsFuncData<T> & data() {return *_u.m_fd;}
-    const gsFuncData<T> & data() const {return *_u.m_fd;}
+    gsFuncData<T> & data() {return _u.m_fd->mine();}
+    const gsFuncData<T> & data() const {return _u.data();}
 
     void setSolutionVector(gsMatrix<T>& solVector)
     { _Sv = & solVector; }
@@ -0,0 +1,123 @@
+/** @file gsMatrixFreeOp.h
+
+    @brief Matrix-free application of mass and stiffness operators on
+    tensor-product B-spline patches by sum factorization.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#pragma once
+
+#include <gsCore/gsMultiPatch.h>
+#include <gsCore/gsMultiBasis.h>
+#include <gsCore/gsDofMapper.h>
+#include <gsSolver/gsLinearOperator.h>
+
+namespace gismo
+{
+
+/// @brief Matrix-free representation of the operator
+///
+/// \f$ a(u,v) = \int_\Omega \beta \nabla u \cdot \nabla v + \alpha u v \, dx \f$
+///
+/// on a multipatch domain discretized with tensor-product B-spline
+/// bases. The operator acts on the degrees of freedom of the given
+/// \a gsDofMapper, so the patches are coupled as in the mapper and
+/// eliminated (Dirichlet) degrees of freedom are left out; this gives
+/// the same matrix as an assembler which uses the same mapper.
+///
+/// On construction, the univariate basis functions and derivatives
+/// are evaluated at the Gauss nodes of every knot span, and the
+/// geometric factors are computed at the quadrature points of every
+/// element. The application of the operator evaluates the function at
+/// the quadrature points and integrates back by sum factorization,
+/// applying the univariate matrices one direction after the other.
+/// This costs \f$ \mathcal{O}(d\,p^{d+1}) \f$ operations per element
+/// and no matrix is stored.
+///
+/// \ingroup Assembler
+template<class T>
+class gsMatrixFreeOp : public gsLinearOperator<T>
+{
+public:
+
+    /// Shared pointer for gsMatrixFreeOp
+    typedef memory::shared_ptr<gsMatrixFreeOp> Ptr;
+
+    /// Unique pointer for gsMatrixFreeOp
+    typedef memory::unique_ptr<gsMatrixFreeOp> uPtr;
+
+    /// @brief Constructor
+    ///
+    /// @param mp      The geometry
+    /// @param mb      The tensor-product B-spline bases
+    /// @param mapper  The dof mapper of the bases
+    /// @param alpha   Coefficient of the mass term
+    /// @param beta    Coefficient of the stiffness term
+    /// @param numQuadNodes Number of Gauss nodes per direction, defaulted to the degree plus one
+    gsMatrixFreeOp(const gsMultiPatch<T> & mp, const gsMultiBasis<T> & mb,
+                   const gsDofMapper & mapper, T alpha = 0, T beta = 1,
+                   index_t numQuadNodes = -1);
+
+    /// Make function returning a smart pointer, see the constructor
+    static uPtr make(const gsMultiPatch<T> & mp, const gsMultiBasis<T> & mb,
+                     const gsDofMapper & mapper, T alpha = 0, T beta = 1,
+                     index_t numQuadNodes = -1)
+    { return uPtr( new gsMatrixFreeOp(mp, mb, mapper, alpha, beta, numQuadNodes) ); }
+
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const;
+
+    index_t rows() const { return m_size; }
+
+    index_t cols() const { return m_size; }
+
+    /// Computes the diagonal of the operator, eg. for Jacobi smoothing
+    void diagonal_into(gsMatrix<T> & result) const;
+
+    /// Returns the number of bytes of the data stored in the object
+    size_t memory() const;
+
+private:
+
+    // The data of one patch
+    struct PatchData
+    {
+        std::vector<index_t> numElements;               // per direction
+        std::vector<index_t> strides;                   // of the basis indices
+        std::vector< std::vector<gsMatrix<T> > > B, D;  // values and derivatives per direction and knot span
+        std::vector< std::vector<index_t> > first;      // first active function per direction and knot span
+        gsMatrix<T> factors;                            // geometric factors at the quadrature points
+        std::vector<index_t> dofs;                      // global dofs of the basis functions, -1 if eliminated
+    };
+
+    // Buffers of the element operator, reused for all elements
+    struct Workspace
+    {
+        std::vector<index_t> sizes, qsizes;
+        std::vector<const gsMatrix<T>*> mats;
+        std::vector< gsMatrix<T> > grad;
+        gsMatrix<T> flux, val, tmp;
+    };
+
+    void initPatch(const gsGeometry<T> & geo, const gsBasis<T> & basis,
+                   const gsDofMapper & mapper, index_t k, index_t numQuadNodes);
+
+    // Applies the element operator to the local coefficients
+    void applyElement(const PatchData & pd, index_t el, const std::vector<index_t> & span,
+                      const gsMatrix<T> & in, gsMatrix<T> & out, Workspace & ws) const;
+
+private:
+
+    std::vector<PatchData> m_patches;
+    index_t m_dim, m_size;
+    T m_alpha, m_beta;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsMatrixFreeOp.hpp)
+#endif
@@ -0,0 +1,384 @@
+/** @file gsMatrixFreeOp.hpp
+
+    @brief Matrix-free application of mass and stiffness operators on
+    tensor-product B-spline patches by sum factorization.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#pragma once
+
+#include <gsAssembler/gsGaussRule.h>
+#include <gsNurbs/gsBSplineBasis.h>
+
+namespace gismo
+{
+
+namespace internal
+{
+
+// Applies the matrix M (or its transpose) in direction dir to the
+// tensor in, with direction 0 running fastest; sizes holds the sizes
+// of the tensor and is updated.
+template<class T>
+void applyInDirection(const gsMatrix<T> & M, bool transpose, index_t dir,
+                      std::vector<index_t> & sizes, const gsMatrix<T> & in, gsMatrix<T> & out)
+{
+    index_t stride = 1, outer = 1;
+    for (index_t k = 0; k < dir; ++k)
+        stride *= sizes[k];
+    for (size_t k = dir + 1; k < sizes.size(); ++k)
+        outer *= sizes[k];
+    const index_t n = sizes[dir];
+    const index_t m = transpose ? M.cols() : M.rows();
+
+    out.resize(stride * m * outer, 1);
+    if ( 1 == stride )
+    {
+        // Direction 0 is a single matrix product
+        gsAsConstMatrix<T> src(in.data(), n, outer);
+        gsAsMatrix<T>      dst(out.data(), m, outer);
+        if (transpose)
+            dst.noalias() = M.transpose() * src;
+        else
+            dst.noalias() = M * src;
+        sizes[dir] = m;
+        return;
+    }
+    for (index_t o = 0; o < outer; ++o)
+    {
+        gsAsConstMatrix<T> src(in.data() + o * n * stride, stride, n);
+        gsAsMatrix<T>      dst(out.data() + o * m * stride, stride, m);
+        if (transpose)
+            dst.noalias() = src * M;
+        else
+            dst.noalias() = src * M.transpose();
+    }
+    sizes[dir] = m;
+}
+
+// Applies the tensor product of the matrices (or their transposes),
+// one per direction
+template<class T>
+void applyTensor(const std::vector<const gsMatrix<T>*> & mats, bool transpose,
+                 std::vector<index_t> sizes, const gsMatrix<T> & in,
+                 gsMatrix<T> & out, gsMatrix<T> & tmp)
+{
+    const index_t d = mats.size();
+    // Ping-pong between the buffers such that the result ends up in out
+    gsMatrix<T> * buf[2] = { (d % 2) ? &out : &tmp, (d % 2) ? &tmp : &out };
+    applyInDirection(*mats[0], transpose, 0, sizes, in, *buf[0]);
+    for (index_t k = 1; k < d; ++k)
+        applyInDirection(*mats[k], transpose, k, sizes, *buf[(k+1)%2], *buf[k%2]);
+}
+
+// Row of the coefficient (a,b) of the symmetric stiffness tensor in
+// the geometric factors; row 0 holds the mass factor
+inline index_t symIndex(index_t a, index_t b, index_t d)
+{
+    if (a > b) std::swap(a, b);
+    return 1 + a * d - a * (a - 1) / 2 + (b - a);
+}
+
+} // namespace internal
+
+template<class T>
+gsMatrixFreeOp<T>::gsMatrixFreeOp(const gsMultiPatch<T> & mp, const gsMultiBasis<T> & mb,
+                                  const gsDofMapper & mapper, T alpha, T beta,
+                                  index_t numQuadNodes)
+: m_patches(mp.nPatches()), m_dim(mp.parDim()), m_size(mapper.freeSize()),
+  m_alpha(alpha), m_beta(beta)
+{
+    GISMO_ASSERT( mp.nPatches() == mb.nBases(), "Number of patches and bases do not match." );
+    for (size_t k = 0; k != mp.nPatches(); ++k)
+        initPatch(mp.patch(k), mb[k], mapper, k, numQuadNodes);
+}
+
+template<class T>
+void gsMatrixFreeOp<T>::initPatch(const gsGeometry<T> & geo, const gsBasis<T> & basis,
+                                  const gsDofMapper & mapper, index_t k, index_t numQuadNodes)
+{
+    GISMO_ENSURE( geo.parDim() == geo.geoDim(), "gsMatrixFreeOp requires parDim == geoDim." );
+    const index_t d = m_dim;
+    PatchData & pd = m_patches[k];
+
+    // Univariate evaluations on every knot span
+    std::vector< std::vector< gsMatrix<T> > > nodes(d);
+    std::vector< std::vector< gsVector<T> > > weights(d);
+    std::vector< gsMatrix<T> > ev;
+    pd.numElements.resize(d);
+    pd.strides.resize(d);
+    pd.B.resize(d);
+    pd.D.resize(d);
+    pd.first.resize(d);
+    for (index_t i = 0; i != d; ++i)
+    {
+        const gsBSplineBasis<T> * comp = dynamic_cast<const gsBSplineBasis<T>*>(&basis.component(i));
+        GISMO_ENSURE( comp, "gsMatrixFreeOp requires tensor-product B-spline bases." );
+        pd.strides[i] = ( 0 == i ? 1 : pd.strides[i-1] * basis.component(i-1).size() );
+
+        const gsGaussRule<T> rule( numQuadNodes > 0 ? numQuadNodes : comp->degree() + 1 );
+        const typename gsKnotVector<T>::knotContainer breaks = comp->knots().unique();
+        const index_t nel = breaks.size() - 1;
+        pd.numElements[i] = nel;
+        nodes[i].resize(nel);
+        weights[i].resize(nel);
+        pd.B[i].resize(nel);
+        pd.D[i].resize(nel);
+        pd.first[i].resize(nel);
+        for (index_t s = 0; s != nel; ++s)
+        {
+            rule.mapTo(breaks[s], breaks[s+1], nodes[i][s], weights[i][s]);
+            comp->evalAllDers_into(nodes[i][s], 1, ev);
+            pd.B[i][s] = ev[0].transpose();
+            pd.D[i][s] = ev[1].transpose();
+            pd.first[i][s] = comp->firstActive( (breaks[s] + breaks[s+1]) / 2 );
+        }
+    }
+
+    // Geometric factors at the quadrature points of every element
+    index_t nel = 1, nqd = 1;
+    for (index_t i = 0; i != d; ++i)
+    {
+        nel *= pd.numElements[i];
+        nqd *= nodes[i][0].cols();
+    }
+    pd.factors.resize(1 + d * (d + 1) / 2, nel * nqd);
+    gsMatrix<T> pts(d, nqd), der, K;
+    gsVector<T> w(nqd);
+    std::vector<index_t> span(d), q(d);
+    for (index_t el = 0; el != nel; ++el)
+    {
+        for (index_t i = 0, r = el; i != d; ++i)
+        {
+            span[i] = r % pd.numElements[i];
+            r /= pd.numElements[i];
+        }
+        for (index_t j = 0; j != nqd; ++j)
+        {
+            w[j] = 1;
+            for (index_t i = 0, r = j; i != d; ++i)
+            {
+                const index_t nq = nodes[i][span[i]].cols();
+                pts(i, j) = nodes[i][span[i]](0, r % nq);
+                w[j] *= weights[i][span[i]][r % nq];
+                r /= nq;
+            }
+        }
+        geo.deriv_into(pts, der);
+
+        for (index_t j = 0; j != nqd; ++j)
+        {
+            // The column holds the transposed Jacobian
+            gsAsConstMatrix<T> Jt(der.col(j).data(), d, d);
+            const T meas = w[j] * math::abs( Jt.determinant() );
+            K = ( Jt * Jt.transpose() ).inverse();
+            const index_t c = el * nqd + j;
+            pd.factors(0, c) = m_alpha * meas;
+            for (index_t a = 0; a != d; ++a)
+                for (index_t b = a; b != d; ++b)
+                    pd.factors(internal::symIndex(a, b, d), c) = m_beta * meas * K(a, b);
+        }
+    }
+
+    // Global indices
+    const index_t nb = basis.size();
+    pd.dofs.resize(nb);
+    for (index_t i = 0; i != nb; ++i)
+        pd.dofs[i] = mapper.is_free(i, k) ? mapper.index(i, k) : -1;
+}
+
+template<class T>
+void gsMatrixFreeOp<T>::applyElement(const PatchData & pd, index_t el,
+                                     const std::vector<index_t> & span,
+                                     const gsMatrix<T> & in, gsMatrix<T> & out,
+                                     Workspace & ws) const
+{
+    const index_t d = m_dim;
+    ws.sizes.resize(d);
+    ws.qsizes.resize(d);
+    ws.mats.resize(d);
+    ws.grad.resize(d);
+    index_t nqd = 1;
+    for (index_t i = 0; i != d; ++i)
+    {
+        ws.sizes[i]  = pd.B[i][span[i]].cols();
+        ws.qsizes[i] = pd.B[i][span[i]].rows();
+        nqd *= ws.qsizes[i];
+    }
+    const index_t col = el * nqd;
+
+    // Evaluate the gradient at the quadrature points
+    for (index_t a = 0; a != d; ++a)
+    {
+        for (index_t i = 0; i != d; ++i)
+            ws.mats[i] = ( i == a ? &pd.D[i][span[i]] : &pd.B[i][span[i]] );
+        internal::applyTensor(ws.mats, false, ws.sizes, in, ws.grad[a], ws.tmp);
+    }
+
+    // Integrate against the gradients of the test functions
+    out.setZero(in.rows(), 1);
+    for (index_t a = 0; a != d; ++a)
+    {
+        ws.flux.noalias() = ws.grad[0].cwiseProduct(
+            pd.factors.row(internal::symIndex(a, 0, d)).segment(col, nqd).transpose() );
+        for (index_t b = 1; b != d; ++b)
+            ws.flux.array() += pd.factors.row(internal::symIndex(a, b, d)).segment(col, nqd).transpose().array()
+                * ws.grad[b].array();
+        for (index_t i = 0; i != d; ++i)
+            ws.mats[i] = ( i == a ? &pd.D[i][span[i]] : &pd.B[i][span[i]] );
+        internal::applyTensor(ws.mats, true, ws.qsizes, ws.flux, ws.val, ws.tmp);
+        out += ws.val;
+    }
+
+    // Mass term
+    if ( 0 != m_alpha )
+    {
+        for (index_t i = 0; i != d; ++i)
+            ws.mats[i] = &pd.B[i][span[i]];
+        internal::applyTensor(ws.mats, false, ws.sizes, in, ws.flux, ws.tmp);
+        ws.flux.array() *= pd.factors.row(0).segment(col, nqd).transpose().array();
+        internal::applyTensor(ws.mats, true, ws.qsizes, ws.flux, ws.val, ws.tmp);
+        out += ws.val;
+    }
+}
+
+template<class T>
+void gsMatrixFreeOp<T>::apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+{
+    GISMO_ASSERT( input.rows() == m_size, "Dimensions do not match." );
+    const index_t d = m_dim;
+    x.setZero(m_size, input.cols());
+
+    std::vector<index_t> span(d), ind;
+    gsMatrix<T> in, out;
+    Workspace ws;
+    for (size_t k = 0; k != m_patches.size(); ++k)
+    {
+        const PatchData & pd = m_patches[k];
+        index_t nel = 1;
+        for (index_t i = 0; i != d; ++i)
+            nel *= pd.numElements[i];
+
+        for (index_t el = 0; el != nel; ++el)
+        {
+            // Global indices of the active functions on the element
+            index_t nloc = 1;
+            for (index_t i = 0, r = el; i != d; ++i)
+            {
+                span[i] = r % pd.numElements[i];
+                r /= pd.numElements[i];
+                nloc *= pd.B[i][span[i]].cols();
+            }
+            ind.resize(nloc);
+            for (index_t l = 0; l != nloc; ++l)
+            {
+                index_t g = 0;
+                for (index_t i = 0, r = l; i != d; ++i)
+                {
+                    const index_t n = pd.B[i][span[i]].cols();
+                    g += ( pd.first[i][span[i]] + r % n ) * pd.strides[i];
+                    r /= n;
+                }
+                ind[l] = pd.dofs[g];
+            }
+
+            for (index_t c = 0; c != input.cols(); ++c)
+            {
+                in.resize(nloc, 1);
+                for (index_t l = 0; l != nloc; ++l)
+                    in(l, 0) = ( ind[l] != -1 ? input(ind[l], c) : 0 );
+                applyElement(pd, el, span, in, out, ws);
+                for (index_t l = 0; l != nloc; ++l)
+                    if ( ind[l] != -1 )
+                        x(ind[l], c) += out(l, 0);
+            }
+        }
+    }
+}
+
+template<class T>
+void gsMatrixFreeOp<T>::diagonal_into(gsMatrix<T> & result) const
+{
+    const index_t d = m_dim;
+    result.setZero(m_size, 1);
+
+    std::vector<index_t> span(d), sizes(d), qsizes(d);
+    std::vector< gsMatrix<T> > prods(d);
+    std::vector<const gsMatrix<T>*> mats(d);
+    gsMatrix<T> coef, val, tmp, diag;
+    for (size_t k = 0; k != m_patches.size(); ++k)
+    {
+        const PatchData & pd = m_patches[k];
+        index_t nel = 1;
+        for (index_t i = 0; i != d; ++i)
+            nel *= pd.numElements[i];
+
+        for (index_t el = 0; el != nel; ++el)
+        {
+            index_t nloc = 1, nqd = 1;
+            for (index_t i = 0, r = el; i != d; ++i)
+            {
+                span[i] = r % pd.numElements[i];
+                r /= pd.numElements[i];
+                sizes[i]  = pd.B[i][span[i]].cols();
+                qsizes[i] = pd.B[i][span[i]].rows();
+                nloc *= sizes[i];
+                nqd  *= qsizes[i];
+            }
+
+            // The diagonal entries are integrals of products of the
+            // univariate functions with themselves, so they are
+            // obtained by applying the squared evaluations
+            diag.setZero(nloc, 1);
+            for (index_t a = -1; a != d; ++a)
+                for (index_t b = (a == -1 ? -1 : 0); b != (a == -1 ? 0 : d); ++b)
+                {
+                    if ( -1 == a && 0 == m_alpha ) continue;
+                    for (index_t i = 0; i != d; ++i)
+                    {
+                        const gsMatrix<T> & X = ( i == a ? pd.D[i][span[i]] : pd.B[i][span[i]] );
+                        const gsMatrix<T> & Y = ( i == b ? pd.D[i][span[i]] : pd.B[i][span[i]] );
+                        prods[i] = X.cwiseProduct(Y);
+                        mats[i] = &prods[i];
+                    }
+                    const index_t row = ( -1 == a ? 0 : internal::symIndex(a, b, d) );
+                    coef = pd.factors.row(row).segment(el * nqd, nqd).transpose();
+                    internal::applyTensor(mats, true, qsizes, coef, val, tmp);
+                    diag += val;
+                }
+
+            for (index_t l = 0; l != nloc; ++l)
+            {
+                index_t g = 0;
+                for (index_t i = 0, r = l; i != d; ++i)
+                {
+                    g += ( pd.first[i][span[i]] + r % sizes[i] ) * pd.strides[i];
+                    r /= sizes[i];
+                }
+                if ( pd.dofs[g] != -1 )
+                    result(pd.dofs[g], 0) += diag(l, 0);
+            }
+        }
+    }
+}
+
+template<class T>
+size_t gsMatrixFreeOp<T>::memory() const
+{
+    size_t result = 0;
+    for (size_t k = 0; k != m_patches.size(); ++k)
+    {
+        const PatchData & pd = m_patches[k];
+        result += pd.factors.size() * sizeof(T) + pd.dofs.size() * sizeof(index_t);
+        for (size_t i = 0; i != pd.B.size(); ++i)
+            for (size_t s = 0; s != pd.B[i].size(); ++s)
+                result += ( pd.B[i][s].size() + pd.D[i][s].size() ) * sizeof(T);
+    }
+    return result;
+}
+
+} // namespace gismo
@@ -0,0 +1,11 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsAssembler/gsMatrixFreeOp.h>
+#include <gsAssembler/gsMatrixFreeOp.hpp>
+
+namespace gismo
+{
+
+    CLASS_TEMPLATE_INST gsMatrixFreeOp<real_t> ;
+
+}
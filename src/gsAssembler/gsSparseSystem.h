@@ -78,9 +78,17 @@ protected:
 
     gsVector<index_t> m_dims;
 
+    /// @brief true if the sparsity pattern of \a m_matrix is fixed,
+    /// see computePattern()
+    bool m_fixedPattern;
+
+    /// @brief true if an entry outside the fixed sparsity pattern was
+    /// pushed from within a parallel region, see checkPattern()
+    bool m_patternMiss;
+
 public:
 
-    gsSparseSystem()
+    gsSparseSystem() : m_fixedPattern(false), m_patternMiss(false)
     { }
 
     /**
@@ -95,7 +103,9 @@ public:
           m_rstr   (1),
           m_cstr   (1),
           m_cvar   (1),
-          m_dims   (1)
+          m_dims   (1),
+          m_fixedPattern(false),
+          m_patternMiss(false)
     {
         m_row [0] =  m_col [0] =
                 m_rstr[0] =  m_cstr[0] =
@@ -142,7 +152,9 @@ public:
           m_col(dims.sum()),
           m_rstr(dims.sum()),
           m_cstr(dims.sum()),
-          m_dims(dims.cast<index_t>())
+          m_dims(dims.cast<index_t>()),
+          m_fixedPattern(false),
+          m_patternMiss(false)
     {
         const index_t d = dims.size();
         const index_t s = dims.sum();
@@ -209,7 +221,9 @@ public:
           m_col (gsVector<index_t>::LinSpaced(cols,0,cols-1)),
           m_rstr(rows),
           m_cstr(cols),
-          m_dims(cols)
+          m_dims(cols),
+          m_fixedPattern(false),
+          m_patternMiss(false)
     {
         GISMO_ASSERT( rows > 0 && cols > 0, "Block dimensions must be positive");
 
@@ -280,7 +294,9 @@ public:
           m_col (colInd),
           m_rstr((index_t)rowInd.size()),
           m_cstr((index_t)colInd.size()),
-          m_dims(colInd.size())
+          m_dims(colInd.size()),
+          m_fixedPattern(false),
+          m_patternMiss(false)
         // ,m_cvar(colvar) //<< Bug
     {
         m_dims.setOnes();
@@ -317,6 +333,8 @@ public:
         m_cstr   .swap(other.m_cstr   );
         m_cvar   .swap(other.m_cvar   );
         m_dims   .swap(other.m_dims   );
+        std::swap(m_fixedPattern, other.m_fixedPattern);
+        std::swap(m_patternMiss , other.m_patternMiss );
     }
 
     /**
@@ -327,6 +345,7 @@ public:
     void reserve(const index_t nz, const index_t numRhs)
     {
         GISMO_ASSERT( 0 != m_mappers.size(), "Sparse system was not initialized");
+        m_fixedPattern = false;
         if ( 0 != m_matrix.cols() )
         {
             m_matrix.reservePerColumn(nz);
@@ -343,6 +362,13 @@ public:
      * At each column approximately bdA * deg + dbB non-zero entries
      * are expected. An extra amount of memory of bdO percent is
      * allocated, in order to speedup the process.
+     *
+     * If the switch "FixedPattern" is set in \em opt, the exact
+     * sparsity pattern is computed instead, see computePattern().
+     * If the pattern has already been computed by a previous call,
+     * it is kept and only its values are set to zero, so that
+     * repeated assemblies (e.g. in Newton iterations) perform no
+     * insertions into the matrix.
      * @param mb
      * @param opt
      * @param [in] numRhs number of columns
@@ -350,7 +376,69 @@ public:
     void reserve(const gsMultiBasis<T> & mb, const gsOptionList & opt,
                  const index_t numRhs)
     {
-        reserve(numColNz(mb,opt), numRhs);
+        if ( opt.askSwitch("FixedPattern", false) )
+        {
+            if ( m_fixedPattern && 0 != m_matrix.nonZeros() )
+            {
+                setZero();
+                if ( 0 != numRhs )
+                    m_rhs.setZero(m_matrix.cols(), numRhs);
+            }
+            else
+                computePattern(mb, numRhs);
+        }
+        else
+            reserve(numColNz(mb,opt), numRhs);
+    }
+
+    /**
+     * @brief Computes the exact sparsity pattern of the matrix by a
+     * symbolic pass over the elements of \em mb and allocates the rhs.
+     *
+     * All row and column blocks are assumed to be discretized by \em mb.
+     * After this call the pattern is fixed: the push functions add
+     * into the existing entries by atomic updates, therefore several
+     * threads may push element contributions concurrently.
+     * Entries outside the pattern (e.g. couplings between patches
+     * due to interface terms) can only be pushed by a single thread.
+     * @param mb the multibasis of the unknowns
+     * @param [in] numRhs number of columns of the right-hand side
+     */
+    void computePattern(const gsMultiBasis<T> & mb, const index_t numRhs)
+    {
+        std::vector<const gsMultiBasis<T>*> bases(1, &mb);
+        computePattern_impl(bases, numRhs);
+    }
+
+    /**
+     * @brief Computes the exact sparsity pattern of the matrix,
+     * where column block \a c (and row block \a c) is discretized
+     * by the multibasis \em bases[colBasis(c)].
+     * @param bases the multibases of the unknowns
+     * @param [in] numRhs number of columns of the right-hand side
+     */
+    void computePattern(const std::vector<gsMultiBasis<T> > & bases,
+                        const index_t numRhs)
+    {
+        std::vector<const gsMultiBasis<T>*> b(bases.size());
+        for (size_t i = 0; i != bases.size(); ++i)
+            b[i] = &bases[i];
+        computePattern_impl(b, numRhs);
+    }
+
+    /// @brief Returns true if the sparsity pattern of the matrix is
+    /// fixed, see computePattern()
+    bool fixedPattern() const { return m_fixedPattern; }
+
+    /// @brief Throws if an entry outside the fixed sparsity pattern
+    /// was pushed from within a parallel region since the last
+    /// call. Such entries are skipped, since an exception must not
+    /// leave the parallel region; call this after the region.
+    void checkPattern()
+    {
+        const bool miss = m_patternMiss;
+        m_patternMiss = false;
+        GISMO_ENSURE( !miss, "An element contribution is not part of the fixed sparsity pattern.");
     }
 
     /// @brief Provides an estimation of the number of non-zero matrix
@@ -369,10 +457,18 @@ public:
         return cast<T,short_t>(nz*(1.0+bdO));
     }
 
-    /// @brief set everything to zero
+    /// @brief set everything to zero. A fixed sparsity pattern is
+    /// kept, only its values are set to zero.
     void setZero()
     {
-        m_matrix.setZero();
+        if ( m_fixedPattern )
+        {
+            m_matrix.makeCompressed();
+            std::fill(m_matrix.valuePtr(),
+                      m_matrix.valuePtr() + m_matrix.nonZeros(), T(0));
+        }
+        else
+            m_matrix.setZero();
         m_rhs   .setZero();
     }
 
@@ -659,12 +755,11 @@ public: /* Add local contributions to system matrix */
                         // If matrix is symmetric, we store only lower
                         // triangular part
                         if ( (!symm) || jj <= ii )
-                            m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                            addToMatrix(ii, jj, localMat(i, j));
                     }
                     else if(0!=eliminatedDofs.size())
                     {
-                        m_rhs.row(ii).noalias() -= localMat(i, j) *
-                            eliminatedDofs.row( rowMap.global_to_bindex(actives.at(j)) );
+                        addToRhs(ii, -localMat(i, j) * eliminatedDofs.row( rowMap.global_to_bindex(actives.at(j)) ));
                     }
                 }
             }
@@ -713,12 +808,11 @@ public: /* Add local contributions to system matrix */
                         // If matrix is symmetric, we store only lower
                         // triangular part
                         if ( (!symm) || jj <= ii )
-                            m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                            addToMatrix(ii, jj, localMat(i, j));
                     }
                     else
                     {
-                        m_rhs.row(ii).noalias() -= localMat(i, j) *
-                                eliminatedDofs_j.row( colMap.global_to_bindex(actives_j.at(j)) );
+                        addToRhs(ii, -localMat(i, j) * eliminatedDofs_j.row( colMap.global_to_bindex(actives_j.at(j)) ));
                     }
                 }
             }
@@ -755,7 +849,7 @@ public: /* Add local contributions to system matrix */
                 // If matrix is symmetric, we store only lower
                 // triangular part
                 if ( (!symm) || jj <= ii )
-                    m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                    addToMatrix(ii, jj, localMat(i, j));
 
 
             }
@@ -794,7 +888,7 @@ public: /* Add local contributions to system matrix */
                 // If matrix is symmetric, we store only lower
                 // triangular part
                 if ( (!symm) || jj <= ii )
-                    m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                    addToMatrix(ii, jj, localMat(i, j));
             }
         }
     }
@@ -853,11 +947,11 @@ public: /* Add local contributions to system matrix */
                                 // If matrix is symmetric, we store only lower
                                 // triangular part
                                 if ( (!symm) || jj <= ii )
-                                    m_matrix.coeffRef(ii, jj) += localMat(iiLocal, jjLocal);
+                                    addToMatrix(ii, jj, localMat(iiLocal, jjLocal));
                             }
                             else // Fixed DoF
                             {
-                                m_rhs.row(ii).noalias() -= localMat(iiLocal, jjLocal) * eliminatedDofs_j.row( colMap.global_to_bindex(actives_vec[c].at(j)));
+                                addToRhs(ii, -localMat(iiLocal, jjLocal) * eliminatedDofs_j.row( colMap.global_to_bindex(actives_vec[c].at(j))));
                             }
                         }
                     }
@@ -893,7 +987,7 @@ public: /* Add local contributions to system right-hand side */
             const index_t ii =  m_rstr.at(r) + actives.at(i);
             if ( mapper.is_free_index(actives.at(i)) )
             {
-                m_rhs.row(ii) += localRhs.row(i);
+                addToRhs(ii, localRhs.row(i));
             }
         }
     }
@@ -914,7 +1008,7 @@ public: /* Add local contributions to system right-hand side */
         for (index_t i = 0; i != numActive; ++i)
         {
             const index_t ii =  m_rstr.at(r) + actives.at(i);
-            m_rhs.row(ii) += localRhs.row(i);
+            addToRhs(ii, localRhs.row(i));
         }
     }
 
@@ -947,7 +1041,7 @@ public: /* Add local contributions to system right-hand side */
 
                 if ( rowMap.is_free_index(actives_vec[r].at(i)) )
                 {
-                    m_rhs.row(ii) += localRhs.row(iiLocal);
+                    addToRhs(ii, localRhs.row(iiLocal));
                 }
             }
             rstrLocal += numActive_i;
@@ -987,7 +1081,7 @@ public: /* Add local contributions to system matrix and right-hand side */
             const int ii =  m_rstr.at(r) + actives(i);
             if ( rowMap.is_free_index(actives.at(i)) )
             {
-                m_rhs.row(ii) += localRhs.row(i);
+                addToRhs(ii, localRhs.row(i));
 
                 for (index_t j = 0; j < numActive; ++j)
                 {
@@ -997,12 +1091,11 @@ public: /* Add local contributions to system matrix and right-hand side */
                         // If matrix is symmetric, we store only lower
                         // triangular part
                         if ( (!symm) || jj <= ii )
-                            m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                            addToMatrix(ii, jj, localMat(i, j));
                     }
                     else // if ( mapper.is_boundary_index(jj) ) // Fixed DoF?
                     {
-                        m_rhs.row(ii).noalias() -= localMat(i, j) *
-                                eliminatedDofs.row( rowMap.global_to_bindex(actives.at(j)) );
+                        addToRhs(ii, -localMat(i, j) * eliminatedDofs.row( rowMap.global_to_bindex(actives.at(j)) ));
                     }
                 }
             }
@@ -1043,7 +1136,7 @@ public: /* Add local contributions to system matrix and right-hand side */
             const int ii =  m_rstr.at(r) + actives_i.at(i);
             if ( rowMap.is_free_index(actives_i.at(i)) )
             {
-                m_rhs.row(ii) += localRhs.row(i);
+                addToRhs(ii, localRhs.row(i));
 
                 for (index_t j = 0; j < numActive_j; ++j)
                 {
@@ -1053,12 +1146,11 @@ public: /* Add local contributions to system matrix and right-hand side */
                         // If matrix is symmetric, we store only lower
                         // triangular part
                         if ( (!symm) || jj <= ii )
-                            m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                            addToMatrix(ii, jj, localMat(i, j));
                     }
                     else // if ( mapper.is_boundary_index(jj) ) // Fixed DoF?
                     {
-                        m_rhs.row(ii).noalias() -= localMat(i, j) *
-                                eliminatedDofs_j.row( colMap.global_to_bindex(actives_j.at(j)) );
+                        addToRhs(ii, -localMat(i, j) * eliminatedDofs_j.row( colMap.global_to_bindex(actives_j.at(j)) ));
                     }
                 }
             }
@@ -1090,14 +1182,14 @@ public: /* Add local contributions to system matrix and right-hand side */
         for (index_t j=0; j!=numActive; ++j)
         {
             const unsigned jj = m_cstr.at(c) + actives(j);
-            m_rhs.row(jj) += localRhs.row(j);
+            addToRhs(jj, localRhs.row(j));
             for (index_t i=0; i!=numActive; ++i)
             {
                 const unsigned ii = m_rstr.at(r) + actives(i);
                 // If matrix is symmetric, we store only lower
                 // triangular part
                 if ( (!symm) || jj <= ii )
-                    m_matrix( ii, jj ) += localMat(i,j);
+                    addToMatrix(ii, jj, localMat(i,j));
             }
         }
     }
@@ -1151,7 +1243,7 @@ public: /* Add local contributions to system matrix and right-hand side */
                     {
                         // rhs should not be pushed for each col-block (but only once)
                         if(c_ind == 0)
-                            m_rhs.row(ii) += localRhs.row(iiLocal);
+                            addToRhs(ii, localRhs.row(iiLocal));
 
                         for (index_t j = 0; j != numActive_j; ++j) // N_j
                         {
@@ -1163,11 +1255,11 @@ public: /* Add local contributions to system matrix and right-hand side */
                                 // If matrix is symmetric, we store only lower
                                 // triangular part
                                 if ( (!symm) || jj <= ii )
-                                    m_matrix.coeffRef(ii, jj) += localMat(iiLocal, jjLocal);
+                                    addToMatrix(ii, jj, localMat(iiLocal, jjLocal));
                             }
                             else // Fixed DoF
                             {
-                                m_rhs.row(ii).noalias() -= localMat(iiLocal, jjLocal) * eliminatedDofs_j.row( colMap.global_to_bindex(actives_vec[c].at(j)));
+                                addToRhs(ii, -localMat(iiLocal, jjLocal) * eliminatedDofs_j.row( colMap.global_to_bindex(actives_vec[c].at(j))));
                             }
                         }
                     }
@@ -1219,7 +1311,7 @@ public: /* Add local contributions to system matrix and right-hand side */
                     const int ii =  m_rstr.at(r) + actives[r].at(i);
                     if ( rowMap.is_free_index(actives[r].at(i)) )
                     {
-                        m_rhs.row(ii) += localRhs.row(i + r * numRowActive); //  + c *
+                        addToRhs(ii, localRhs.row(i + r * numRowActive)); //  + c *
                         const index_t numColActive = actives[c].rows();
 
                         for (index_t j = 0; j < numColActive; ++j)
@@ -1230,8 +1322,7 @@ public: /* Add local contributions to system matrix and right-hand side */
                                 // If matrix is symmetric, we store only lower
                                 // triangular part
                                 if ( (!symm) || jj <= ii )
-                                    m_matrix.coeffRef(ii, jj) += localMat(i + r * numRowActive,
-                                                                          j + c * numRowActive); //  + c * ..
+                                    addToMatrix(ii, jj, localMat(i + r * numRowActive, j + c * numRowActive)); //  + c * ..
                             }
                             else // if ( mapper.is_boundary_index(jj) ) // Fixed DoF?
                             {
@@ -1306,7 +1397,7 @@ public: /* Add local contributions to system matrix and right-hand side */
                         // If matrix is symmetric, we store only lower
                         // triangular part
                         if ( (!symm) || jj <= ii )
-                            m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                            addToMatrix(ii, jj, localMat(i, j));
                 }
             }
         }
@@ -1351,7 +1442,7 @@ public: /* Add local contributions to system matrix and right-hand side */
                         // If matrix is symmetric, we store only lower
                         // triangular part
                         if ( (!symm) || jj <= ii )
-                            m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                            addToMatrix(ii, jj, localMat(i, j));
                 }
             }
         }
@@ -1386,7 +1477,7 @@ public: /* Add local contributions to system matrix and right-hand side */
             const int ii =  m_rstr.at(r) + actives(i);
             if ( rowMap.is_free_index(actives(i)) )
             {
-                m_rhs.row(ii) += localRhs.row(i);
+                addToRhs(ii, localRhs.row(i));
 
                 for (index_t j = 0; j != numActive; ++j)
                 {
@@ -1396,7 +1487,7 @@ public: /* Add local contributions to system matrix and right-hand side */
                         // If matrix is symmetric, we store only lower
                         // triangular part
                         if ( (!symm) || jj <= ii )
-                            m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                            addToMatrix(ii, jj, localMat(i, j));
                     }
                 }
             }
@@ -1430,12 +1521,11 @@ public:
                         // If matrix is symmetric, we store only lower
                         // triangular part
                         if ( (!symm) || jj <= ii )
-                            m_matrix.coeffRef(ii, jj) += it.value();
+                            addToMatrix(ii, jj, it.value());
                     }
                     else // if ( mapper.is_boundary_index(jj) ) // Fixed DoF?
                     {
-                        m_rhs.row(ii).noalias() -= it.value() *
-                                eliminatedDofs_j.row( colMap.global_to_bindex(jj) );
+                        addToRhs(ii, -it.value() * eliminatedDofs_j.row( colMap.global_to_bindex(jj) ));
                     }
                 }
             }
@@ -1444,8 +1534,138 @@ public:
         {
             const int ii =  m_rstr.at(r) + actives_i.at(i);
             if ( rowMap.is_free_index(actives_i.at(i)) )
-                m_rhs.row(ii) += localRhs.row(i);
+                addToRhs(ii, localRhs.row(i));
+        }
+    }
+
+private:
+
+    /// @brief Adds \a val to the matrix entry (\a ii, \a jj). If the
+    /// pattern is fixed the existing entry is updated atomically.
+    void addToMatrix(const index_t ii, const index_t jj, const T val)
+    {
+        if ( m_fixedPattern )
+        {
+            if ( T * a = patternCoeffPtr(ii, jj) )
+            {
+#               pragma omp atomic
+                *a += val;
+                return;
+            }
+#           ifdef _OPENMP
+            if ( omp_in_parallel() ) // reported by checkPattern()
+            {
+#               pragma omp atomic write
+                m_patternMiss = true;
+                return;
+            }
+#           endif
         }
+        m_matrix.coeffRef(ii, jj) += val;
+    }
+
+    /// @brief Adds the row \a val to the row \a ii of the right-hand
+    /// side. If the pattern is fixed the entries are updated atomically.
+    template<class Row>
+    void addToRhs(const index_t ii, const Row & val)
+    {
+        if ( m_fixedPattern )
+        {
+            for (index_t k = 0; k != m_rhs.cols(); ++k)
+            {
+                T & a = m_rhs(ii, k);
+                const T v = val(k);
+#               pragma omp atomic
+                a += v;
+            }
+        }
+        else
+            m_rhs.row(ii) += val;
+    }
+
+    /// @brief Returns a pointer to the stored matrix entry (\a i, \a
+    /// j), or NULL if the entry is not stored
+    T * patternCoeffPtr(const index_t i, const index_t j)
+    {
+        const index_t outer = gsSparseMatrix<T>::IsRowMajor ? i : j;
+        const index_t inner = gsSparseMatrix<T>::IsRowMajor ? j : i;
+        const index_t * ind = m_matrix.innerIndexPtr();
+        const index_t * beg = ind + m_matrix.outerIndexPtr()[outer];
+        const index_t * end = m_matrix.isCompressed() ?
+            ind + m_matrix.outerIndexPtr()[outer+1] :
+            beg + m_matrix.innerNonZeroPtr()[outer];
+        const index_t * pos = std::lower_bound(beg, end, inner);
+        return (pos != end && *pos == inner) ?
+            m_matrix.valuePtr() + (pos - ind) : NULL;
+    }
+
+    void computePattern_impl(const std::vector<const gsMultiBasis<T>*> & bases,
+                             const index_t numRhs)
+    {
+        GISMO_ASSERT( 0 != m_mappers.size(), "Sparse system was not initialized");
+        GISMO_ENSURE( m_row.size() == m_col.size(),
+                      "The pattern can only be computed for square block structures");
+        const index_t nb = m_col.size();
+
+        // Multibasis of block b
+        std::vector<const gsMultiBasis<T>*> mb(nb);
+        for (index_t b = 0; b != nb; ++b)
+            mb[b] = bases[ 1 == bases.size() || b >= m_cvar.size() ? 0 : m_cvar[b] ];
+
+        // Initial guess for the number of non-zeros per column
+        const gsBasis<T> & b0 = mb[0]->basis(0);
+        index_t nz = 1;
+        for (short_t i = 0; i != b0.dim(); ++i)
+            nz *= 2 * b0.degree(i) + 1;
+
+        m_fixedPattern = false;
+        m_matrix.setZero();
+        m_matrix.reservePerColumn(nb * nz);
+
+        std::vector<gsMatrix<index_t> > rowAct(nb), colAct(nb);
+        gsMatrix<index_t> act;
+        for (size_t k = 0; k != mb[0]->nBases(); ++k)
+        {
+            typename gsBasis<T>::domainIter domIt = (*mb[0])[k].makeDomainIterator();
+            for (; domIt->good(); domIt->next() )
+            {
+                // The actives of an element are the ones at its center
+                for (index_t b = 0; b != nb; ++b)
+                {
+                    (*mb[b])[k].active_into(domIt->centerPoint(), act);
+                    mapRowIndices(act, k, rowAct[b], b);
+                    mapColIndices(act, k, colAct[b], b);
+                }
+
+                for (index_t r = 0; r != nb; ++r)
+                {
+                    const gsDofMapper & rowMap = m_mappers[m_row.at(r)];
+                    for (index_t c = 0; c != nb; ++c)
+                    {
+                        const gsDofMapper & colMap = m_mappers[m_col.at(c)];
+                        for (index_t i = 0; i != rowAct[r].rows(); ++i)
+                        {
+                            if ( !rowMap.is_free_index(rowAct[r].at(i)) ) continue;
+                            const index_t ii = m_rstr.at(r) + rowAct[r].at(i);
+                            for (index_t j = 0; j != colAct[c].rows(); ++j)
+                            {
+                                if ( !colMap.is_free_index(colAct[c].at(j)) ) continue;
+                                const index_t jj = m_cstr.at(c) + colAct[c].at(j);
+                                // If matrix is symmetric, we store only lower
+                                // triangular part
+                                if ( (!symm) || jj <= ii )
+                                    m_matrix.coeffRef(ii, jj);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        m_matrix.makeCompressed();
+        if ( 0 != numRhs )
+            m_rhs.setZero(m_matrix.cols(), numRhs);
+        m_fixedPattern = true;
     }
 
 };  // class gsSparseSystem
@@ -186,6 +186,7 @@ template <int d, class T=real_t>         class gsLineSegment;
 
 template <class T=real_t>                class gsFileData;
 class gsFileManager;
+struct gsJITCompilerConfig;
 
 template <class T=real_t>                class gsSolid;
 template <class T=real_t>                class gsSolidVertex;
@@ -273,6 +274,7 @@ template <class T=real_t>                class gsPatchPreconditionersCreator;
 
 template <class T=real_t>                class gsMultiGridOp;
 template <class T=real_t>                class gsGridHierarchy;
+template <class T=real_t>                class gsAlgebraicMultiGrid;
 
 // gsIeti
 
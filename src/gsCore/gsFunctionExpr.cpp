@@ -0,0 +1,442 @@
+/** @file gsFunctionExpr.cpp
+
+    @brief Translation of the expressions of gsFunctionExpr to C++
+    kernels, see gsFunctionExpr::compile().
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsCore/gsFunctionExpr.h>
+
+namespace gismo
+{
+
+namespace internal
+{
+
+namespace
+{
+
+// Node of an expression tree which is translated to C++ by
+// gsFunctionExpr::compile()
+struct jitNode;
+typedef memory::shared_ptr<jitNode> jitPtr;
+
+struct jitNode
+{
+    char op;                 // 'n': number, 'v': variable, 'f': function,
+                             // '~': negation, or one of + - * / ^
+    std::string name;        // digits of a number, name of a function
+    double val;              // value of a number
+    int var;                 // index of a variable
+    std::vector<jitPtr> arg; // operands
+};
+
+inline bool jitIsNum(const jitPtr & e, const double v)
+{ return 'n' == e->op && v == e->val; }
+
+inline jitPtr jitNum(const std::string & digits)
+{
+    jitPtr e(new jitNode);
+    e->op   = 'n';
+    e->name = digits;
+    e->val  = atof(digits.c_str());
+    return e;
+}
+
+inline jitPtr jitVar(const int k)
+{
+    jitPtr e(new jitNode);
+    e->op  = 'v';
+    e->var = k;
+    return e;
+}
+
+inline jitPtr jitNeg(const jitPtr & a)
+{
+    if ( jitIsNum(a, 0) ) return a;
+    if ( '~' == a->op ) return a->arg[0];
+    jitPtr e(new jitNode);
+    e->op = '~';
+    e->arg.push_back(a);
+    return e;
+}
+
+// Binary operation, dropping the trivial terms that appear in derivatives
+inline jitPtr jitBin(const char op, const jitPtr & a, const jitPtr & b)
+{
+    switch (op)
+    {
+    case '+':
+        if ( jitIsNum(a, 0) ) return b;
+        if ( jitIsNum(b, 0) ) return a;
+        break;
+    case '-':
+        if ( jitIsNum(b, 0) ) return a;
+        if ( jitIsNum(a, 0) ) return jitNeg(b);
+        break;
+    case '*':
+        if ( jitIsNum(a, 0) || jitIsNum(b, 1) ) return a;
+        if ( jitIsNum(b, 0) || jitIsNum(a, 1) ) return b;
+        break;
+    case '/':
+        if ( jitIsNum(a, 0) || jitIsNum(b, 1) ) return a;
+        break;
+    case '^':
+        if ( jitIsNum(b, 0) ) return jitNum("1");
+        if ( jitIsNum(b, 1) ) return a;
+        break;
+    }
+    jitPtr e(new jitNode);
+    e->op = op;
+    e->arg.push_back(a);
+    e->arg.push_back(b);
+    return e;
+}
+
+inline jitPtr jitFun(const std::string & name, const jitPtr & a)
+{
+    jitPtr e(new jitNode);
+    e->op   = 'f';
+    e->name = name;
+    e->arg.push_back(a);
+    return e;
+}
+
+inline jitPtr jitFun(const std::string & name, const std::vector<jitPtr> & args)
+{
+    jitPtr e(new jitNode);
+    e->op   = 'f';
+    e->name = name;
+    e->arg  = args;
+    return e;
+}
+
+// Recursive descent parser for the subset of the ExprTk syntax which
+// can be translated to C++ (see gsFunctionExpr::compile)
+class jitParser
+{
+public:
+    explicit jitParser(const std::string & str) : s(str), i(0) { }
+
+    // Returns false if the string is not in the supported subset
+    bool operator()(jitPtr & res) { return sum(res) && i == s.size(); }
+
+private:
+    bool peek(const char c) const { return i < s.size() && c == s[i]; }
+
+    bool sum(jitPtr & res)
+    {
+        if ( !prod(res) ) return false;
+        while ( peek('+') || peek('-') )
+        {
+            const char op = s[i++];
+            jitPtr rhs;
+            if ( !prod(rhs) ) return false;
+            res = jitBin(op, res, rhs);
+        }
+        return true;
+    }
+
+    bool prod(jitPtr & res)
+    {
+        if ( !unary(res) ) return false;
+        while ( peek('*') || peek('/') )
+        {
+            const char op = s[i++];
+            jitPtr rhs;
+            if ( !unary(rhs) ) return false;
+            res = jitBin(op, res, rhs);
+        }
+        return true;
+    }
+
+    // as in ExprTk, -a^b is -(a^b) and a^b^c is a^(b^c)
+    bool unary(jitPtr & res)
+    {
+        if ( peek('+') ) { ++i; return unary(res); }
+        if ( peek('-') )
+        {
+            ++i;
+            if ( !unary(res) ) return false;
+            res = jitNeg(res);
+            return true;
+        }
+        if ( !primary(res) ) return false;
+        if ( peek('^') )
+        {
+            ++i;
+            jitPtr ex;
+            if ( !unary(ex) ) return false;
+            res = jitBin('^', res, ex);
+        }
+        return true;
+    }
+
+    bool primary(jitPtr & res)
+    {
+        if ( i == s.size() ) return false;
+
+        if ( peek('(') )
+        {
+            ++i;
+            if ( !sum(res) || !peek(')') ) return false;
+            ++i;
+            return true;
+        }
+
+        if ( isdigit(s[i]) || peek('.') )
+        {
+            const size_t b = i;
+            while ( i < s.size() && isdigit(s[i]) ) ++i;
+            if ( peek('.') ) ++i;
+            while ( i < s.size() && isdigit(s[i]) ) ++i;
+            if ( peek('e') || peek('E') )
+            {
+                size_t j = i + 1;
+                if ( j < s.size() && ('+' == s[j] || '-' == s[j]) ) ++j;
+                if ( j < s.size() && isdigit(s[j]) )
+                {
+                    i = j;
+                    while ( i < s.size() && isdigit(s[i]) ) ++i;
+                }
+            }
+            if ( 1 == i - b && '.' == s[b] ) return false;
+            res = jitNum(s.substr(b, i - b));
+            return true;
+        }
+
+        if ( !isalpha(s[i]) ) return false;
+        std::string id;
+        while ( i < s.size() && (isalnum(s[i]) || '_' == s[i]) )
+            id.push_back( static_cast<char>(tolower(s[i++])) );
+
+        if ( "pi" == id )
+        {
+            res = jitNum("3.141592653589793238462643383279502884");
+            return true;
+        }
+
+        const size_t k = std::string("xyzwuvt").find(id);
+        if ( 1 == id.size() && std::string::npos != k )
+        {
+            res = jitVar(static_cast<int>(k));
+            return true;
+        }
+
+        // function call
+        if ( !peek('(') ) return false;
+        std::vector<jitPtr> args;
+        do
+        {
+            ++i;
+            args.push_back(jitPtr());
+            if ( !sum(args.back()) ) return false;
+        }
+        while ( peek(',') );
+        if ( !peek(')') ) return false;
+        ++i;
+
+        static const char * unaryFun[] = {"sin", "cos", "tan", "asin", "acos",
+            "atan", "sinh", "cosh", "tanh", "exp", "log", "log10", "sqrt", "abs"};
+        if ( 1 == args.size() && unaryFun + 14 !=
+             std::find(unaryFun, unaryFun + 14, id) )
+        {
+            res = jitFun(id, args[0]);
+            return true;
+        }
+        if ( 2 == args.size() )
+        {
+            if ( "pow" == id )
+            {
+                res = jitBin('^', args[0], args[1]);
+                return true;
+            }
+            if ( "atan2" == id || "min" == id || "max" == id )
+            {
+                res = jitFun(id, args);
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const std::string & s;
+    size_t i;
+};
+
+// Partial derivative of the expression tree \a f wrt variable \a k
+jitPtr jitDiff(const jitPtr & f, const int k)
+{
+    const jitNode & e = *f;
+    const jitPtr zero = jitNum("0"), one = jitNum("1"), two = jitNum("2");
+
+    if ( 'n' == e.op ) return zero;
+    if ( 'v' == e.op ) return e.var == k ? one : zero;
+    if ( '~' == e.op ) return jitNeg( jitDiff(e.arg[0], k) );
+
+    const jitPtr & a  = e.arg[0];
+    const jitPtr   da = jitDiff(a, k);
+    if ( 'f' == e.op && 1 == e.arg.size() ) // elementary functions
+    {
+        if ( jitIsNum(da, 0) ) return zero;
+        const std::string & fn = e.name;
+        jitPtr d;
+        if      ( "sin"   == fn ) d = jitFun("cos", a);
+        else if ( "cos"   == fn ) d = jitNeg(jitFun("sin", a));
+        else if ( "tan"   == fn )
+            return jitBin('/', da, jitBin('^', jitFun("cos", a), two));
+        else if ( "asin"  == fn || "acos" == fn )
+        {
+            d = jitBin('/', one, jitFun("sqrt", jitBin('-', one, jitBin('^', a, two))));
+            if ( "acos" == fn ) d = jitNeg(d);
+        }
+        else if ( "atan"  == fn )
+            return jitBin('/', da, jitBin('+', one, jitBin('^', a, two)));
+        else if ( "sinh"  == fn ) d = jitFun("cosh", a);
+        else if ( "cosh"  == fn ) d = jitFun("sinh", a);
+        else if ( "tanh"  == fn ) d = jitBin('-', one, jitBin('^', f, two));
+        else if ( "exp"   == fn ) d = f;
+        else if ( "log"   == fn ) return jitBin('/', da, a);
+        else if ( "log10" == fn )
+            return jitBin('/', da, jitBin('*', a, jitFun("log", jitNum("10"))));
+        else if ( "sqrt"  == fn ) return jitBin('/', da, jitBin('*', two, f));
+        else if ( "abs"   == fn ) d = jitFun("sgn", a);
+        else if ( "sgn"   == fn ) return zero;
+        else GISMO_ERROR("Unknown function "<< fn);
+        return jitBin('*', d, da);
+    }
+
+    const jitPtr & b  = e.arg[1];
+    const jitPtr   db = jitDiff(b, k);
+    switch (e.op)
+    {
+    case '+':
+    case '-':
+        return jitBin(e.op, da, db);
+    case '*':
+        return jitBin('+', jitBin('*', da, b), jitBin('*', a, db));
+    case '/':
+        if ( jitIsNum(db, 0) ) return jitBin('/', da, b);
+        return jitBin('/', jitBin('-', jitBin('*', da, b), jitBin('*', a, db)),
+                      jitBin('^', b, two));
+    case '^':
+        if ( jitIsNum(db, 0) ) // constant exponent
+            return jitBin('*', jitBin('*', b, jitBin('^', a, jitBin('-', b, one))), da);
+        return jitBin('*', f, jitBin('+', jitBin('*', db, jitFun("log", a)),
+                                      jitBin('/', jitBin('*', b, da), a)));
+    }
+
+    // functions of two arguments
+    std::vector<jitPtr> args(e.arg);
+    if ( "atan2" == e.name )
+        return jitBin('/', jitBin('-', jitBin('*', b, da), jitBin('*', a, db)),
+                      jitBin('+', jitBin('^', a, two), jitBin('^', b, two)));
+    if ( "min" == e.name || "max" == e.name )
+    {
+        args.push_back(da);
+        args.push_back(db);
+        return jitFun("d" + e.name, args);
+    }
+    if ( "dmin" == e.name || "dmax" == e.name ) // derivative of min/max
+    {
+        args[2] = jitDiff(args[2], k);
+        args[3] = jitDiff(args[3], k);
+        return jitFun(e.name, args);
+    }
+    GISMO_ERROR("Unknown function "<< e.name);
+}
+
+// Writes the C++ code of the expression tree \a f
+std::string jitEmit(const jitPtr & f)
+{
+    const jitNode & e = *f;
+    switch (e.op)
+    {
+    case 'n':
+        return "S(" + e.name + "L)";
+    case 'v':
+        return "v" + util::to_string(e.var);
+    case '~':
+        return "(-" + jitEmit(e.arg[0]) + ")";
+    case '^':
+        return "std::pow(" + jitEmit(e.arg[0]) + "," + jitEmit(e.arg[1]) + ")";
+    case 'f':
+    {
+        // sgn, dmin and dmax are defined in the kernel source
+        std::string res = ( 'd' == e.name[0] || "sgn" == e.name ? "" : "std::" )
+            + e.name + "(" + jitEmit(e.arg[0]);
+        for (size_t i = 1; i != e.arg.size(); ++i)
+            res += "," + jitEmit(e.arg[i]);
+        return res + ")";
+    }
+    default:
+        return "(" + jitEmit(e.arg[0]) + e.op + jitEmit(e.arg[1]) + ")";
+    }
+}
+
+// Writes a kernel that evaluates the expression trees \a f at np
+// points of dimension \a d, stored column-wise in pts, the values of
+// the parameters (variables beyond \a d) are read from par
+void jitWriteKernel(std::ostream & os, const std::string & name,
+                    const std::vector<jitPtr> & f, const int d, const int nv)
+{
+    os << "EXPORT void " << name
+       << "(const S * pts, const int np, const S * par, S * res)\n{\n"
+       << "    for (int p = 0; p < np; ++p, pts += " << d
+       << ", res += " << f.size() << ")\n    {\n";
+    for (int k = 0; k != nv; ++k)
+        os << "        const S v" << k << " = "
+           << (k < d ? "pts[" : "par[") << k << "];\n";
+    for (size_t i = 0; i != f.size(); ++i)
+        os << "        res[" << i << "] = " << jitEmit(f[i]) << ";\n";
+    os << "    }\n}\n\n";
+}
+
+} // anonymous namespace
+
+int writeFunctionExprKernels(std::ostream & os,
+                             const std::vector<std::string> & expr,
+                             const char * scalar, const int d, const int nv)
+{
+    const int n = static_cast<int>(expr.size());
+    const int stride = d + d*(d-1)/2;
+    std::vector<jitPtr> f(n), df(n*d), ddf(n*stride);
+    for (int c = 0; c != n; ++c)
+    {
+        jitParser parse(expr[c]);
+        if ( !parse(f[c]) )
+            return c;
+
+        int m = c*stride + d;
+        for (int k = 0; k != d; ++k)
+        {
+            df[c*d+k] = jitDiff(f[c], k);
+            ddf[c*stride+k] = jitDiff(df[c*d+k], k);
+            for (int l = k+1; l < d; ++l)
+                ddf[m++] = jitDiff(df[c*d+k], l);
+        }
+    }
+
+    os << "#include <cmath>\n#include <algorithm>\n\n"
+       << "typedef " << scalar << " S;\n\n"
+       << "static inline S sgn(const S a)\n"
+       << "{ return S( (S(0) < a) - (a < S(0)) ); }\n"
+       << "static inline S dmin(const S a, const S b, const S da, const S db)\n"
+       << "{ return b < a ? db : da; }\n"
+       << "static inline S dmax(const S a, const S b, const S da, const S db)\n"
+       << "{ return a < b ? db : da; }\n\n";
+    jitWriteKernel(os, "gsFunctionExpr_eval"  , f  , d, nv);
+    jitWriteKernel(os, "gsFunctionExpr_deriv" , df , d, nv);
+    jitWriteKernel(os, "gsFunctionExpr_deriv2", ddf, d, nv);
+    return -1;
+}
+
+} // namespace internal
+
+} // namespace gismo
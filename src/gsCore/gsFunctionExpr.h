@@ -135,6 +135,33 @@ public:
     /// \brief Adds another component to this (vector) function
     void addComponent(const std::string & strExpression);
 
+    /**
+       \brief Generates native code for the components and their
+       (exact) first and second derivatives, and loads it using
+       gsJITCompiler with configuration \a config.
+
+       After a successful call, eval_into, deriv_into and deriv2_into
+       evaluate whole point matrices by the compiled kernels, which
+       are reentrant and can be called concurrently.
+
+       The supported expressions consist of numbers, the variables
+       x,y,z,w,u,v,t, the constant pi, the operators + - * / ^ and the
+       functions sin, cos, tan, asin, acos, atan, sinh, cosh, tanh,
+       exp, log, log10, sqrt, abs, pow, atan2, min and max.
+
+       \returns false if an expression is not supported or the
+       compilation fails; the function is then still evaluated by the
+       interpreter.
+    */
+    bool compile(const gsJITCompilerConfig & config);
+
+    /// \brief Same as compile(config), using the compiler guessed
+    /// by gsJITCompilerConfig::guess()
+    bool compile();
+
+    /// \brief Returns true if the kernels generated by compile() are used
+    bool isCompiled() const;
+
 private:
 
     // initializes the symbol table
@@ -213,6 +240,22 @@ private:
 
 }; // class gsFunctionExpr
 
+/// @cond
+namespace internal
+{
+
+// Writes to \a os the source of the kernels gsFunctionExpr_eval,
+// gsFunctionExpr_deriv and gsFunctionExpr_deriv2 of gsFunctionExpr::compile(),
+// which evaluate the expressions \a expr, their gradients and second
+// derivatives wrt the first \a d of the \a nv variables, in the scalar
+// type \a scalar. Returns the index of the first expression which is
+// not in the supported subset of the syntax, or -1 on success.
+GISMO_EXPORT int writeFunctionExprKernels(std::ostream & os,
+                                          const std::vector<std::string> & expr,
+                                          const char * scalar, int d, int nv);
+
+} // namespace internal
+/// @endcond
 
 } // namespace gismo
 
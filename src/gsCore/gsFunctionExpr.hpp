@@ -109,6 +109,11 @@
 
 #include <gsIO/gsXml.h>
 
+#if defined(_WIN32) && !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <gsCore/gsJITCompiler.h>
+
 namespace
 {
 
@@ -177,6 +182,19 @@ T mixed_derivative(const exprtk::expression<T>& e,
 namespace gismo
 {
 
+/// @cond
+namespace internal
+{
+
+// Name of the scalar type used in the kernels, NULL if not supported
+template <typename T> struct jitScalar { static const char * name() { return NULL; } };
+template <> struct jitScalar<float>  { static const char * name() { return "float"; } };
+template <> struct jitScalar<double> { static const char * name() { return "double"; } };
+template <> struct jitScalar<long double> { static const char * name() { return "long double"; } };
+
+} // namespace internal
+/// @endcond
+
 template<typename T> class gsFunctionExpr<T>::gsFunctionExprPrivate
 {
 public:
@@ -191,6 +209,9 @@ public:
     typedef exprtk::expression<Numeric_t>    Expression_t;
     typedef exprtk::parser<Numeric_t>        Parser_t;
 
+    // Kernel generated by gsFunctionExpr::compile()
+    typedef void (Kernel_t)(const T *, const int, const T *, T *);
+
 public:
 
     gsFunctionExprPrivate(const short_t _dim)
@@ -198,10 +219,13 @@ public:
     {
         GISMO_ENSURE( dim <= N_VARS, "The number of variables can be at most 7 (x,y,z,w,u,v,t)." );
         init();
+        clearKernels();
+        clearThreadData();
     }
 
     gsFunctionExprPrivate(const gsFunctionExprPrivate & other)
-    : vars(), dim(other.dim)
+    : vars(), dim(other.dim), jitLib(other.jitLib), jitEval(other.jitEval),
+      jitDeriv(other.jitDeriv), jitDeriv2(other.jitDeriv2)
     {
         GISMO_ASSERT ( string.size() == expression.size(), "Corrupted FunctionExpr");
         init();
@@ -210,6 +234,80 @@ public:
         expression.reserve(string.size());
         for (size_t i = 0; i!= other.string.size(); ++i)
             addComponent(other.string[i]);
+        clearThreadData();
+    }
+
+    ~gsFunctionExprPrivate()
+    {
+        clearThreadData();
+    }
+
+    // Returns the data to be used by the calling thread. In a parallel
+    // region every thread evaluates its own copy of the parsed
+    // expressions, which is created on first use and kept for the
+    // subsequent calls. The shared data is used only outside of any
+    // active region and by the master thread of a single active
+    // team. With nested active parallelism, or more threads than at
+    // construction, a temporary copy is stored in \a tmp.
+    const gsFunctionExprPrivate &
+    local(memory::unique_ptr<gsFunctionExprPrivate> & tmp) const
+    {
+#       ifdef _OPENMP
+        const int active = omp_get_active_level();
+        if ( 0 == active ) // no concurrent threads
+            return *this;
+
+        gsFunctionExprPrivate * res = NULL;
+        if ( 1 == active )
+        {
+            // Thread number in the active team: in nested inactive
+            // regions omp_get_thread_num() is zero in every thread
+            int tid = 0;
+            for (int l = omp_get_level(); l > 0; --l)
+                if ( omp_get_team_size(l) > 1 )
+                {
+                    tid = omp_get_ancestor_thread_num(l);
+                    break;
+                }
+            if ( 0 == tid )
+                return *this;
+
+            if ( tid < static_cast<int>(threadData.size()) )
+            {
+                if ( NULL == threadData[tid] )
+                    threadData[tid] = new gsFunctionExprPrivate(*this);
+                res = threadData[tid];
+            }
+        }
+        if ( NULL == res )
+        {
+            tmp.reset(new gsFunctionExprPrivate(*this));
+            res = tmp.get();
+        }
+        // The parameters (eg. time) might have been changed by set_t etc.
+        copy_n(vars + dim, N_VARS - dim, res->vars + dim);
+        return *res;
+#       else
+        GISMO_UNUSED(tmp);
+        return *this;
+#       endif
+    }
+
+    // Deletes the copies created by local()
+    void clearThreadData()
+    {
+#       ifdef _OPENMP
+        freeAll(threadData);
+        threadData.resize(omp_get_max_threads(), NULL);
+#       endif
+    }
+
+    void clearKernels()
+    {
+        jitLib    = gsDynamicLibrary();
+        jitEval   = NULL;
+        jitDeriv  = NULL;
+        jitDeriv2 = NULL;
     }
 
     void addComponent(const std::string & strExpression)
@@ -269,6 +367,13 @@ public:
     std::vector<std::string>  string;
     short_t dim;
 
+    gsDynamicLibrary          jitLib;
+    Kernel_t                * jitEval, * jitDeriv, * jitDeriv2;
+
+#ifdef _OPENMP
+    mutable std::vector<gsFunctionExprPrivate*> threadData;
+#endif
+
 private:
     gsFunctionExprPrivate();
     gsFunctionExprPrivate operator= (const gsFunctionExprPrivate & other);
@@ -482,6 +587,84 @@ template<typename T>
 void gsFunctionExpr<T>::addComponent(const std::string & strExpression)
 {
     my->addComponent(strExpression);
+    my->clearKernels();
+    my->clearThreadData();
+}
+
+template<typename T>
+bool gsFunctionExpr<T>::compile()
+{
+    return compile(gsJITCompilerConfig::guess());
+}
+
+template<typename T>
+bool gsFunctionExpr<T>::compile(const gsJITCompilerConfig & config)
+{
+    my->clearKernels();
+    my->clearThreadData();
+#   ifdef GISMO_WITH_ADIFF
+    GISMO_UNUSED(config);
+    return false;
+#   else
+    const char * scalar = internal::jitScalar<T>::name();
+    if ( NULL == scalar )
+        return false;
+
+    // Translate the expressions and differentiate them symbolically
+    const short_t d = domainDim();
+    gsJITCompiler jit(config);
+    const int failed = internal::writeFunctionExprKernels(jit.getKernel(), my->string,
+                                                          scalar, d, N_VARS);
+    if ( -1 != failed )
+    {
+        gsWarn<<"gsFunctionExpr: cannot compile "<< my->string[failed]
+              <<", using the interpreter.\n";
+        return false;
+    }
+
+    // Reference values of the interpreter at some points
+    gsMatrix<T> pts(d, 5), ref, val;
+    for (index_t i = 0; i!=pts.size(); ++i)
+        pts.at(i) = T(i+1) / T(pts.size()+1);
+    eval_into(pts, ref);
+
+    typedef typename PrivateData_t::Kernel_t Kernel_t;
+    try
+    {
+        my->jitLib    = jit.build();
+        my->jitEval   = my->jitLib.template getSymbol<Kernel_t>("gsFunctionExpr_eval");
+        my->jitDeriv  = my->jitLib.template getSymbol<Kernel_t>("gsFunctionExpr_deriv");
+        my->jitDeriv2 = my->jitLib.template getSymbol<Kernel_t>("gsFunctionExpr_deriv2");
+    }
+    catch (std::runtime_error & e)
+    {
+        gsWarn<<"gsFunctionExpr: "<< e.what() <<", using the interpreter.\n";
+        my->clearKernels();
+        return false;
+    }
+
+    // Safety check, eg. for syntax that is read differently by ExprTk
+    eval_into(pts, val);
+    const T tol = math::sqrt(std::numeric_limits<T>::epsilon());
+    for (index_t i = 0; i!=ref.size(); ++i)
+    {
+        if ( ref.at(i) == val.at(i) ||  // (includes infinite values)
+             (ref.at(i) != ref.at(i) && val.at(i) != val.at(i)) || // both NaN
+             math::abs(ref.at(i) - val.at(i)) <= tol * (1 + math::abs(ref.at(i))) )
+            continue;
+        gsWarn<<"gsFunctionExpr: the compiled kernel for "<< *this
+              <<" does not match the interpreter, using the interpreter.\n";
+        my->clearKernels();
+        return false;
+    }
+    return true;
+#   endif
+}
+
+template<typename T>
+bool gsFunctionExpr<T>::isCompiled() const
+{
+    return NULL != my->jitEval;
 }
 
 template<typename T>
@@ -520,11 +703,16 @@ void gsFunctionExpr<T>::eval_into(const gsMatrix<T>& u, gsMatrix<T>& result) con
     const short_t n = targetDim();
     result.resize(n, u.cols());
 
-    const PrivateData_t & expr =
-#   ifdef _OPENMP
-        omp_in_parallel() ? PrivateData_t(*my) :
+#   ifndef GISMO_WITH_ADIFF
+    if ( my->jitEval )
+    {
+        my->jitEval(u.data(), static_cast<int>(u.cols()), my->vars, result.data());
+        return;
+    }
 #   endif
-        *my;
+
+    memory::unique_ptr<PrivateData_t> tmp;
+    const PrivateData_t & expr = my->local(tmp);
 
     for ( index_t p = 0; p!=u.cols(); p++ ) // for all evaluation points
     {
@@ -549,14 +737,18 @@ void gsFunctionExpr<T>::eval_component_into(const gsMatrix<T>& u, const index_t
                   "Given component number is higher then number of components");
 
     result.resize(1, u.cols());
+
+    memory::unique_ptr<PrivateData_t> tmp;
+    const PrivateData_t & expr = my->local(tmp);
+
     for ( index_t p = 0; p!=u.cols(); ++p )
     {
-        copy_n(u.col(p).data(), my->dim, my->vars);
+        copy_n(u.col(p).data(), expr.dim, expr.vars);
 
 #           ifdef GISMO_WITH_ADIFF
-            result(0,p) = my->expression[comp].value().getValue();
+            result(0,p) = expr.expression[comp].value().getValue();
 #           else
-            result(0,p) = my->expression[comp].value();
+            result(0,p) = expr.expression[comp].value();
 #           endif
     }
 }
@@ -572,11 +764,16 @@ void gsFunctionExpr<T>::deriv_into(const gsMatrix<T>& u, gsMatrix<T>& result) co
     const short_t n = targetDim();
     result.resize(d*n, u.cols());
 
-    const PrivateData_t & expr =
-#   ifdef _OPENMP
-        omp_in_parallel() ? PrivateData_t(*my) :
+#   ifndef GISMO_WITH_ADIFF
+    if ( my->jitDeriv )
+    {
+        my->jitDeriv(u.data(), static_cast<int>(u.cols()), my->vars, result.data());
+        return;
+    }
 #   endif
-        *my;
+
+    memory::unique_ptr<PrivateData_t> tmp;
+    const PrivateData_t & expr = my->local(tmp);
 
     for ( index_t p = 0; p!=u.cols(); p++ ) // for all evaluation points
     {
@@ -607,11 +804,16 @@ void gsFunctionExpr<T>::deriv2_into(const gsMatrix<T>& u, gsMatrix<T>& result) c
     const index_t stride = d + d*(d-1)/2;
     result.resize(stride*n, u.cols() );
 
-    const PrivateData_t & expr =
-#   ifdef _OPENMP
-        omp_in_parallel() ? PrivateData_t(*my) :
+#   ifndef GISMO_WITH_ADIFF
+    if ( my->jitDeriv2 )
+    {
+        my->jitDeriv2(u.data(), static_cast<int>(u.cols()), my->vars, result.data());
+        return;
+    }
 #   endif
-        *my;
+
+    memory::unique_ptr<PrivateData_t> tmp;
+    const PrivateData_t & expr = my->local(tmp);
 
     for ( index_t p = 0; p!=u.cols(); p++ ) // for all evaluation points
     {
@@ -627,21 +829,21 @@ void gsFunctionExpr<T>::deriv2_into(const gsMatrix<T>& u, gsMatrix<T>& result) c
             const DScalar &            ads  = expr.expression[c].value();
             const DScalar::Hessian_t & Hmat = ads.getHessian(); // note: can fail
 
+            index_t m = c*stride + d;
             for ( index_t k=0; k!=d; ++k)
             {
-                result(k,p) = Hmat(k,k);
-                index_t m = d;
+                result(c*stride+k,p) = Hmat(k,k);
                 for ( index_t l=k+1; l<d; ++l)
                     result(m++,p) = Hmat(k,l);
             }
 #           else
+            index_t m = c*stride + d;
             for (short_t k = 0; k!=d; ++k)
             {
                 // H_{k,k}
-                result(k,p) = exprtk::
+                result(c*stride+k,p) = exprtk::
                     second_derivative<T>(expr.expression[c], expr.vars[k], 0.00001);
 
-                short_t m = d;
                 for (short_t l=k+1; l<d; ++l)
                 {
                     // H_{k,l}
@@ -668,11 +870,8 @@ gsFunctionExpr<T>::hess(const gsMatrix<T>& u, unsigned coord) const
 
     gsMatrix<T> res(d, d);
 
-    const PrivateData_t & expr =
-#   ifdef _OPENMP
-        omp_in_parallel() ? PrivateData_t(*my) :
-#   endif
-        *my;
+    memory::unique_ptr<PrivateData_t> tmp;
+    const PrivateData_t & expr = my->local(tmp);
 
 #   ifdef GISMO_WITH_ADIFF
     for (index_t v = 0; v!=d; ++v)
@@ -704,11 +903,8 @@ gsMatrix<T> * gsFunctionExpr<T>::mderiv(const gsMatrix<T> & u,
     const short_t n = targetDim();
     gsMatrix<T> * res= new gsMatrix<T>(n,u.cols()) ;
 
-    const PrivateData_t & expr =
-#   ifdef _OPENMP
-        omp_in_parallel() ? PrivateData_t(*my) :
-#   endif
-        *my;
+    memory::unique_ptr<PrivateData_t> tmp;
+    const PrivateData_t & expr = my->local(tmp);
 
     for( index_t p=0; p!=res->cols(); ++p )
     {
@@ -739,11 +935,8 @@ gsMatrix<T> gsFunctionExpr<T>::laplacian(const gsMatrix<T>& u) const
     const short_t n = targetDim();
     gsMatrix<T> res(n,u.cols());
 
-    const PrivateData_t & expr =
-#   ifdef _OPENMP
-        omp_in_parallel() ? PrivateData_t(*my) :
-#   endif
-        *my;
+    memory::unique_ptr<PrivateData_t> tmp;
+    const PrivateData_t & expr = my->local(tmp);
 
     for( index_t p = 0; p != res.cols(); ++p )
     {
@@ -16,7 +16,9 @@
  
 #pragma once
 
-#include <gsIO/gsXml.h>
+#include <fstream>
+
+#include <gsIO/gsFileData.h>
 #include <gsIO/gsFileManager.h>
 
 #if defined(_WIN32)
@@ -298,6 +298,11 @@ public:
     void repairInterfaces();
 
     /// @brief For each point in \a points, locates the parametric coordinates of the point
+    ///
+    /// The candidate patches of each point are found with a bounding
+    /// box tree over the control points of the elements of all
+    /// patches, and Newton's method starts at the center of the
+    /// candidate element.
     /// \param points
     /// \param pids vector containing for each point the patch id where it belongs (or -1 if not found)
     /// \param preim in each column,  the parametric coordinates of the corresponding point in the patch
@@ -321,6 +326,11 @@ private:
 private:
     // implementation functions
 
+    // Locates the points using a bounding box tree of the elements of
+    // all patches, except the patch \a skip
+    void locatePoints_impl(const gsMatrix<T> & points, index_t skip,
+                           gsVector<index_t> & pids, gsMatrix<T> & preim) const;
+
     // match the vertices in ci1 starting from start to the end with the vertices
     // in ci2 that are still non matched
     // cc1 and cc2 are the physical coordinates of the vertices
@@ -16,9 +16,11 @@
 #include <gsCore/gsBasis.h>
 #include <gsCore/gsGeometry.h>
 #include <gsCore/gsDofMapper.h>
+#include <gsCore/gsDomainIterator.h>
 #include <gsCore/gsAffineFunction.h>
 
 #include <gsUtils/gsCombinatorics.h>
+#include <gsUtils/gsBoundingBoxTree.h>
 
 namespace gismo
 {
@@ -658,57 +660,97 @@ template<class T>
 void gsMultiPatch<T>::locatePoints(const gsMatrix<T> & points,
                                    gsVector<index_t> & pids,
                                    gsMatrix<T> & preim) const
+{
+    locatePoints_impl(points, -1, pids, preim);
+}
+
+template<class T>
+void gsMultiPatch<T>::locatePoints(const gsMatrix<T> & points, index_t pid1,
+                                   gsVector<index_t> & pid2, gsMatrix<T> & preim) const
+{
+    // Assumes points are found on pid1 and possibly on one more patch
+    locatePoints_impl(points, pid1, pid2, preim);
+}
+
+template<class T>
+void gsMultiPatch<T>::locatePoints_impl(const gsMatrix<T> & points, index_t skip,
+                                        gsVector<index_t> & pids, gsMatrix<T> & preim) const
 {
     pids.resize(points.cols());
     pids.setConstant(-1); // -1 implies not in the domain
     preim.resize(parDim(), points.cols());//uninitialized by default
-    gsMatrix<T> pt, pr, tmp;
-
-    for (index_t i = 0; i!=pids.size(); ++i)
+    if ( m_patches.empty() ) return;
+
+    const T tol = 1e-6; // accuracy of invertPoints
+
+    // Bounding boxes of the control points acting on each element
+    index_t nel = 0;
+    for (size_t k = 0; k!= m_patches.size(); ++k)
+        nel += m_patches[k]->basis().numElements();
+    gsMatrix<T> lower(geoDim(), nel), upper(geoDim(), nel), center(parDim(), nel);
+    std::vector<index_t> elPatch(nel);
+    gsMatrix<index_t> act;
+    index_t e = 0;
+    for (size_t k = 0; k!= m_patches.size(); ++k)
     {
-        pt = points.col(i);
-
-        for (size_t k = 0; k!= m_patches.size(); ++k)
+        const gsGeometry<T> & geo = *m_patches[k];
+        typename gsBasis<T>::domainIter domIt = geo.basis().makeDomainIterator();
+        for (; domIt->good(); domIt->next(), ++e)
         {
-            pr = m_patches[k]->parameterRange();
-            m_patches[k]->invertPoints(pt, tmp);
-            if ( (tmp.array() >= pr.col(0).array()).all()
-                 && (tmp.array() <= pr.col(1).array()).all() )
+            GISMO_ASSERT(e < nel, "Number of elements does not match the domain iterator");
+            center.col(e) = domIt->centerPoint();
+            geo.basis().active_into(center.col(e), act);
+            lower.col(e) = upper.col(e) = geo.coef(act(0)).transpose();
+            for (index_t j = 1; j < act.rows(); ++j)
             {
-                pids[i] = k;
-                preim.col(i) = tmp;
-                break;
+                lower.col(e) = lower.col(e).cwiseMin( geo.coef(act(j)).transpose() );
+                upper.col(e) = upper.col(e).cwiseMax( geo.coef(act(j)).transpose() );
             }
+            elPatch[e] = k;
         }
     }
-}
+    lower.array() -= tol;
+    upper.array() += tol;
+    const gsBoundingBoxTree<T> tree(lower, upper);
 
-template<class T>
-void gsMultiPatch<T>::locatePoints(const gsMatrix<T> & points, index_t pid1,
-                                   gsVector<index_t> & pid2, gsMatrix<T> & preim) const
-{
-    // Assumes points are found on pid1 and possibly on one more patch
-    pid2.resize(points.cols());
-    pid2.setConstant(-1); // -1 implies not in the domain
-    preim.resize(parDim(), points.cols());//uninitialized by default
-    gsMatrix<T> pt, pr, tmp;
-
-    for (index_t i = 0; i!=pid2.size(); ++i)
+#pragma omp parallel
     {
-        pt = points.col(i);
+        std::vector<index_t> cand;
+        std::vector<std::pair<T,index_t> > order;
+        gsMatrix<T> pt, pr, tmp;
 
-        for (size_t k = 0; k!= m_patches.size(); ++k)
+#pragma omp for schedule(dynamic, 64)
+        for (index_t i = 0; i < points.cols(); ++i)
         {
-            if (pid1==(index_t)k) continue; // skip pid1
-
-            pr = m_patches[k]->parameterRange();
-            m_patches[k]->invertPoints(pt, tmp);
-            if ( (tmp.array() >= pr.col(0).array()).all()
-                 && (tmp.array() <= pr.col(1).array()).all() )
+            pt = points.col(i);
+            cand.clear();
+            tree.query(pt, cand);
+
+            // Try the elements with the nearest box centers first,
+            // starting Newton's method at the element center
+            order.clear();
+            for (size_t c = 0; c != cand.size(); ++c)
+                order.push_back( std::make_pair(
+                    (lower.col(cand[c]) + upper.col(cand[c]) - 2 * pt).squaredNorm(),
+                    cand[c]) );
+            std::sort(order.begin(), order.end());
+
+            for (size_t c = 0; c != order.size(); ++c)
             {
-                pid2[i] = k;
-                preim.col(i) = tmp;
-                break;
+                const index_t el = order[c].second;
+                const index_t k  = elPatch[el];
+                if (skip==k) continue; // skip pid1
+
+                pr  = m_patches[k]->parameterRange();
+                tmp = center.col(el);
+                m_patches[k]->invertPoints(pt, tmp, tol, true);
+                if ( (tmp.array() >= pr.col(0).array()).all()
+                     && (tmp.array() <= pr.col(1).array()).all() )
+                {
+                    pids[i] = k;
+                    preim.col(i) = tmp;
+                    break;
+                }
             }
         }
     }
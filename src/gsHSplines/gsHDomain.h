@@ -103,6 +103,26 @@ private:
 
     unsigned m_maxPath;
 
+    /// \brief Packed copy of the tree in contiguous arrays, built by
+    /// makeCompressed() and discarded by any modification of the tree.
+    ///
+    /// The nodes are stored in depth-first order, so that the left
+    /// child of the split node \a i is the node <em>i+1</em>. For a
+    /// split node, m_flatAxis, m_flatPos and m_flatNext hold the split
+    /// dimension, the split coordinate and the index of the right
+    /// child. For a leaf, m_flatAxis is -1 and m_flatNext holds the
+    /// number of the leaf.
+    std::vector<int> m_flatAxis;
+    std::vector<T>   m_flatPos;
+    std::vector<int> m_flatNext;
+
+    /// The levels of the leaves of the packed tree
+    std::vector<int> m_flatLevel;
+
+    /// The lower and upper corners of the leaves of the packed tree
+    /// (one per column), at level gsHDomain::m_indexLevel
+    gsMatrix<T> m_flatLow, m_flatUpp;
+
 public:
 
     gsHDomain() : m_indexLevel(0)
@@ -133,7 +153,10 @@ public:
         m_upperIndex(o.m_upperIndex),
         m_indexLevel(o.m_indexLevel),
         m_maxInsLevel(o.m_maxInsLevel),
-        m_maxPath(o.m_maxPath)
+        m_maxPath(o.m_maxPath),
+        m_flatAxis(o.m_flatAxis), m_flatPos(o.m_flatPos),
+        m_flatNext(o.m_flatNext), m_flatLevel(o.m_flatLevel),
+        m_flatLow(o.m_flatLow), m_flatUpp(o.m_flatUpp)
     {
         m_root = new node(*o.m_root);
     }
@@ -151,6 +174,13 @@ public:
         m_maxInsLevel = o.m_maxInsLevel;
         m_maxPath    = o.m_maxPath;
 
+        m_flatAxis  = o.m_flatAxis;
+        m_flatPos   = o.m_flatPos;
+        m_flatNext  = o.m_flatNext;
+        m_flatLevel = o.m_flatLevel;
+        m_flatLow   = o.m_flatLow;
+        m_flatUpp   = o.m_flatUpp;
+
         return *this;
     }
 
@@ -160,7 +190,10 @@ public:
     m_upperIndex(std::move(o.m_upperIndex)),
     m_indexLevel(o.m_indexLevel),
     m_maxInsLevel(o.m_maxInsLevel),
-    m_maxPath(o.m_maxPath)
+    m_maxPath(o.m_maxPath),
+    m_flatAxis(std::move(o.m_flatAxis)), m_flatPos(std::move(o.m_flatPos)),
+    m_flatNext(std::move(o.m_flatNext)), m_flatLevel(std::move(o.m_flatLevel)),
+    m_flatLow(std::move(o.m_flatLow)), m_flatUpp(std::move(o.m_flatUpp))
     {
         o.m_root = nullptr;
     }
@@ -172,6 +205,12 @@ public:
         m_indexLevel  = o.m_indexLevel;
         m_maxInsLevel = o.m_maxInsLevel;
         m_maxPath     = o.m_maxPath;
+        m_flatAxis    = std::move(o.m_flatAxis);
+        m_flatPos     = std::move(o.m_flatPos);
+        m_flatNext    = std::move(o.m_flatNext);
+        m_flatLevel   = std::move(o.m_flatLevel);
+        m_flatLow     = std::move(o.m_flatLow);
+        m_flatUpp     = std::move(o.m_flatUpp);
         return *this;
     }
 #endif
@@ -190,6 +229,7 @@ public:
 
         m_root = new node(m_upperIndex);
         m_maxPath = 1;
+        clearPacked();
     }
 
     /// Destructor deletes the whole tree
@@ -417,8 +457,58 @@ public:
                                           int level) const;
 
     /// Returns the level of the point \a p
-    int levelOf(point const & p, int level) const
-    { return pointSearch(p,level,m_root)->level;}
+    int levelOf(point const & p, int level) const;
+
+    /** \brief Returns the levels of the points given by the columns
+     * of \a p.
+     *
+     * Consecutive points in the same leaf are resolved without
+     * searching the tree, so this is fastest for sorted points,
+     * e.g. in lexicographic order, or for the nodes of one element.
+     *
+     * \param p the points, one per column
+     * \param level specifies which level the coordinates of \a p refer to
+     * \param[out] result the level of each point
+     */
+    void levelOf(gsMatrix<T> const & p, int level,
+                 gsVector<index_t> & result) const;
+
+    /** \brief Calls \a op(lower, upper, level) for every leaf of the
+     * tree, with the corners given in the indices of the leaf's
+     * level (as gsHDomainLeafIter::lowerCorner()).
+     *
+     * For a packed tree (see isPacked()) the leaves are visited in
+     * parallel when OpenMP is enabled, so \a op must be thread-safe.
+     */
+    template<class Op>
+    void forEachLeaf(Op op) const
+    {
+        if ( isPacked() )
+        {
+            const index_t nl = m_flatLow.cols();
+#           pragma omp parallel for if ( nl > 1024 )
+            for ( index_t i = 0; i < nl; ++i )
+            {
+                const int lvl = m_flatLevel[i];
+                point lower, upper;
+                for ( short_t k = 0; k != d; ++k )
+                {
+                    lower[k] = m_flatLow(k,i) >> (m_indexLevel-lvl);
+                    upper[k] = m_flatUpp(k,i) >> (m_indexLevel-lvl);
+                }
+                op(lower, upper, lvl);
+            }
+        }
+        else
+        {
+            for ( const_literator it = beginLeafIterator(); it.good(); it.next() )
+                op(it.lowerCorner(), it.upperCorner(), it.level());
+        }
+    }
+
+    /// Returns true if the packed copy of the tree, which speeds up
+    /// the queries, is up to date. It is built by makeCompressed().
+    bool isPacked() const { return !m_flatAxis.empty(); }
 
     /// Increment the level index globally
     void incrementLevel();
@@ -431,6 +521,8 @@ public:
 
     literator beginLeafIterator()
     {
+        // The leaves can be modified through the iterator
+        clearPacked();
         return literator(m_root, m_indexLevel);
     }
 
@@ -439,6 +531,8 @@ public:
         return const_literator(m_root, m_indexLevel);
     }
 
+    /// Merges sibling leaves of the same level and builds the
+    /// packed copy of the tree, see isPacked()
     void makeCompressed();
     
     /// Returns the number of nodes in the tree
@@ -538,6 +632,26 @@ public:
 
 private:
     
+    /// Builds the packed copy of the tree
+    void pack();
+
+    /// Discards the packed copy of the tree
+    void clearPacked()
+    {
+        m_flatAxis.clear();
+        m_flatPos.clear();
+        m_flatNext.clear();
+        m_flatLevel.clear();
+        m_flatLow.resize(d,0);
+        m_flatUpp.resize(d,0);
+    }
+
+    /// Iterates on the leafs of the packed tree that overlap the box
+    /// [\a k1, \a k2] and applies \a visitor to their levels
+    template<typename visitor>
+    typename visitor::return_type
+    packedBoxSearch(point const & k1, point const & k2, int level) const;
+
     /// Returns true if the boxes overlap
     /// \param box1
     /// \param box2
@@ -69,7 +69,12 @@ namespace
         static void visitLeaf(gismo::kdnode<d,T> * leafNode , int level, return_type & res)
         {
             //if ( (!isDegenerate(*leafNode->box)) && leafNode->level <= level )
-            if ( leafNode->level <= level )
+            visitLevel(leafNode->level, level, res);
+        }
+
+        static void visitLevel(int leafLevel, int level, return_type & res)
+        {
+            if ( leafLevel <= level )
                 res = false;
         }
     };
@@ -87,8 +92,13 @@ namespace
         static void visitLeaf(gismo::kdnode<d,T> * leafNode , int , return_type & res)
         {
             //if ( (!isDegenerate(*leafNode->box)) && leafNode->level < res )
-            if ( leafNode->level < res )
-                res = leafNode->level;
+            visitLevel(leafNode->level, 0, res);
+        }
+
+        static void visitLevel(int leafLevel, int , return_type & res)
+        {
+            if ( leafLevel < res )
+                res = leafLevel;
         }
     };
 
@@ -105,8 +115,13 @@ namespace
         static void visitLeaf(gismo::kdnode<d,T> * leafNode , int , return_type & res)
         {
             //if ( (!isDegenerate(*leafNode->box)) && leafNode->level > res )
-            if ( leafNode->level > res )
-                res = leafNode->level;
+            visitLevel(leafNode->level, 0, res);
+        }
+
+        static void visitLevel(int leafLevel, int , return_type & res)
+        {
+            if ( leafLevel > res )
+                res = leafLevel;
         }
     };
 
@@ -197,6 +212,7 @@ gsHDomain<d,T>::insertBox ( point const & k1, point const & k2,
                             node *_node, int lvl) // CONSTRAINT: lvl is "minimum level"
 {
     GISMO_ENSURE( lvl <= static_cast<int>(m_indexLevel), "Max index level reached..");
+    clearPacked();
 
     // Make a box
     box iBox(k1,k2);
@@ -297,6 +313,7 @@ template<short_t d, class T > void
 gsHDomain<d,T>::sinkBox ( point const & k1,
                           point const & k2, int lvl)
 {
+    clearPacked();
     GISMO_ENSURE( m_maxInsLevel+1 <= m_indexLevel,
                   "Max index level might be reached..");
 
@@ -408,6 +425,107 @@ gsHDomain<d,T>::makeCompressed()
 
     // Store the max path length
     m_maxPath = minMaxPath().second;
+
+    // Third step: pack the tree for the queries
+    pack();
+}
+
+template<short_t d, class T > void
+gsHDomain<d,T>::pack()
+{
+    clearPacked();
+    const int nl = leafSize();
+    m_flatLevel.reserve(nl);
+    m_flatLow.resize(d, nl);
+    m_flatUpp.resize(d, nl);
+
+    // Depth-first traversal, visiting the left child first
+    std::vector<std::pair<const node*,int> > stack; // node and index of its parent
+    stack.reserve( 2 * m_maxPath );
+    stack.push_back( std::make_pair(m_root, -1) );
+    while ( ! stack.empty() )
+    {
+        const node * curNode = stack.back().first;
+        const int parent     = stack.back().second;
+        stack.pop_back();
+
+        const int i = m_flatAxis.size();
+        if ( -1 != parent && i != parent + 1 ) // right child
+            m_flatNext[parent] = i;
+
+        m_flatAxis.push_back( curNode->axis );
+        if ( curNode->isLeaf() )
+        {
+            const int leaf = m_flatLevel.size();
+            m_flatPos .push_back( 0 );
+            m_flatNext.push_back( leaf );
+            m_flatLevel.push_back( curNode->level );
+            m_flatLow.col(leaf) = curNode->lowCorner();
+            m_flatUpp.col(leaf) = curNode->uppCorner();
+        }
+        else
+        {
+            m_flatPos .push_back( curNode->pos );
+            m_flatNext.push_back( -1 ); // set when the right child is reached
+            stack.push_back( std::make_pair(curNode->right, i) );
+            stack.push_back( std::make_pair(curNode->left , i) );
+        }
+    }
+}
+
+template<short_t d, class T > int
+gsHDomain<d,T>::levelOf(point const & p, int level) const
+{
+    if ( ! isPacked() )
+        return pointSearch(p,level,m_root)->level;
+
+    point pp;
+    local2globalIndex(p, static_cast<unsigned>(level), pp);
+
+    GISMO_ASSERT( ( pp.array() <= m_upperIndex.array() ).all(),
+        "levelOf: Wrong input: "<< p.transpose()<<", level "<<level<<".\n" );
+
+    int i = 0;
+    while ( -1 != m_flatAxis[i] )
+        i = ( pp[m_flatAxis[i]] < m_flatPos[i] ? i + 1 : m_flatNext[i] );
+    return m_flatLevel[m_flatNext[i]];
+}
+
+template<short_t d, class T > void
+gsHDomain<d,T>::levelOf(gsMatrix<T> const & p, int level,
+                        gsVector<index_t> & result) const
+{
+    GISMO_ASSERT( p.rows() == d, "Wrong dimension of the points");
+    result.resize( p.cols() );
+
+    if ( ! isPacked() )
+    {
+        for ( index_t c = 0; c != p.cols(); ++c )
+            result[c] = pointSearch(p.col(c),level,m_root)->level;
+        return;
+    }
+
+    point pp;
+    int leaf = -1;
+    for ( index_t c = 0; c != p.cols(); ++c )
+    {
+        local2globalIndex(p.col(c), static_cast<unsigned>(level), pp);
+
+        // Still in the leaf of the previous point ?
+        if ( -1 == leaf ||
+             ( pp.array() <  m_flatLow.col(leaf).array() ).any() ||
+             ( pp.array() >= m_flatUpp.col(leaf).array() ).any() )
+        {
+            GISMO_ASSERT( ( pp.array() <= m_upperIndex.array() ).all(),
+                "levelOf: Wrong input: "<< p.col(c).transpose()<<", level "<<level<<".\n" );
+
+            int i = 0;
+            while ( -1 != m_flatAxis[i] )
+                i = ( pp[m_flatAxis[i]] < m_flatPos[i] ? i + 1 : m_flatNext[i] );
+            leaf = m_flatNext[i];
+        }
+        result[c] = m_flatLevel[leaf];
+    }
 }
 
 template<short_t d, class T >
@@ -428,7 +546,10 @@ bool gsHDomain<d,T>::query2(point const & lower, point const & upper,
 template<short_t d, class T >
 bool gsHDomain<d,T>::query2 (point const & lower, point const & upper,
                  int level) const
-{ return boxSearch< query2_visitor >(lower,upper,level,m_root); }
+{
+    return isPacked() ? packedBoxSearch< query2_visitor >(lower,upper,level)
+                      : boxSearch< query2_visitor >(lower,upper,level,m_root);
+}
 
 template<short_t d, class T >
 int gsHDomain<d,T>::query3(point const & lower, point const & upper,
@@ -438,7 +559,10 @@ int gsHDomain<d,T>::query3(point const & lower, point const & upper,
 template<short_t d, class T >
 int gsHDomain<d,T>::query3(point const & lower, point const & upper,
                int level) const
-{ return boxSearch< query3_visitor >(lower,upper,level,m_root); }
+{
+    return isPacked() ? packedBoxSearch< query3_visitor >(lower,upper,level)
+                      : boxSearch< query3_visitor >(lower,upper,level,m_root);
+}
 
 template<short_t d, class T >
 int gsHDomain<d,T>::query4(point const & lower, point const & upper,
@@ -448,7 +572,10 @@ int gsHDomain<d,T>::query4(point const & lower, point const & upper,
 template<short_t d, class T >
 int gsHDomain<d,T>::query4(point const & lower, point const & upper,
                int level) const
-{ return boxSearch< query4_visitor >(lower,upper,level,m_root); }
+{
+    return isPacked() ? packedBoxSearch< query4_visitor >(lower,upper,level)
+                      : boxSearch< query4_visitor >(lower,upper,level,m_root);
+}
 
 template<short_t d, class T >
 std::pair<typename gsHDomain<d,T>::point, typename gsHDomain<d,T>::point>
@@ -615,6 +742,58 @@ gsHDomain<d,T>::boxSearch(point const & k1, point const & k2,
 
 
 
+template<short_t d, class T>
+template<typename visitor>
+typename visitor::return_type
+gsHDomain<d,T>::packedBoxSearch(point const & k1, point const & k2,
+                                int level) const
+{
+    // Make a box
+    box qBox(k1,k2);
+    local2globalIndex( qBox.first , static_cast<unsigned>(level), qBox.first );
+    local2globalIndex( qBox.second, static_cast<unsigned>(level), qBox.second);
+
+    GISMO_ASSERT( !isDegenerate(qBox),
+                  "boxSearch: Wrong order of points defining the box (or empty box): "
+                  << qBox.first.transpose() <<", "<< qBox.second.transpose() <<".\n" );
+
+    typename visitor::return_type res = visitor::init();
+
+    // The stack holds at most m_maxPath+1 nodes, usually few enough
+    // to avoid a heap allocation
+    int buf[64];
+    std::vector<int> heapBuf;
+    int * stack = buf;
+    if ( m_maxPath >= 64 )
+    {
+        heapBuf.resize(m_maxPath + 1);
+        stack = &heapBuf[0];
+    }
+    int top = 0;
+    stack[top++] = 0;
+    while ( top != 0 )
+    {
+        const int i = stack[--top];
+        const int axis = m_flatAxis[i];
+
+        if ( -1 == axis )
+            visitor::visitLevel(m_flatLevel[m_flatNext[i]], level, res);
+        else if ( qBox.second[axis] <= m_flatPos[i] )
+            // qBox overlaps only left child of this split-node
+            stack[top++] = i + 1;
+        else if ( qBox.first[axis] >= m_flatPos[i] )
+            // qBox overlaps only right child of this split-node
+            stack[top++] = m_flatNext[i];
+        else
+        {
+            // qBox overlaps both children of this split-node
+            stack[top++] = i + 1;
+            stack[top++] = m_flatNext[i];
+        }
+    }
+    return res;
+}
+
 template<short_t d, class T>
 typename gsHDomain<d,T>::node *
 gsHDomain<d,T>::pointSearch(const point & p, int level, node  *_node ) const
@@ -1561,6 +1740,7 @@ gsHDomain<d,T>::global2localIndex( gsVector<index_t,d> const & index,
 template<short_t d, class T> inline void
 gsHDomain<d,T>::incrementLevel()
 {
+    clearPacked();
     m_maxInsLevel++;
 
     GISMO_ASSERT( m_maxInsLevel <= m_indexLevel,
@@ -1572,6 +1752,7 @@ gsHDomain<d,T>::incrementLevel()
 template<short_t d, class T> inline void
 gsHDomain<d,T>::multiplyByTwo()
     {
+        clearPacked();
         m_upperIndex *= 2;
         nodeSearch< liftCoordsOneLevel_visitor >();
     }
@@ -1579,6 +1760,7 @@ gsHDomain<d,T>::multiplyByTwo()
 template<short_t d, class T> inline void
 gsHDomain<d,T>::decrementLevel()
     {
+        clearPacked();
         m_maxInsLevel--;
         leafSearch< levelDown_visitor >();
     }
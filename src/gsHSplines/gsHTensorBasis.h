@@ -25,6 +25,7 @@
 #include <gsNurbs/gsBSplineBasis.h> // for gsBasis::component(short_t)
 
 #include <gsUtils/gsSortedVector.h>
+#include <gsUtils/gsThreaded.h>
 
 namespace gismo
 {
@@ -242,6 +243,7 @@ public:
             m_deg            = o.m_deg;
             m_tree           = o.m_tree;
             m_xmatrix        = o.m_xmatrix;
+            clearActiveCache();
 
             freeAll( m_bases );
             m_bases.resize( o.m_bases.size() );
@@ -264,6 +266,7 @@ public:
         m_xmatrix = std::move(other.m_xmatrix);
         m_tree    = std::move(other.m_tree);
         m_xmatrix_offset = std::move(other.m_xmatrix_offset);
+        clearActiveCache();
         return *this;
     }
 #endif
@@ -335,6 +338,42 @@ public:
     /// level \em k (i.e., those taken from \f$ B^k \f$) start.
     std::vector<index_t> m_xmatrix_offset;
 
+    /// \brief Active functions on one element of the hierarchical mesh
+    struct activeCacheEntry
+    {
+        activeCacheEntry() : level(-1), cell(0) { }
+
+        /// The level of the element, -1 if the entry is empty
+        int level;
+        /// The flat index of the element in the tensor grid of its level
+        size_t cell;
+        /// The parameter box of the element, empty if parts of it
+        /// are refined further
+        T lower[d], upper[d];
+        /// The indices of the active functions
+        std::vector<index_t> actives;
+    };
+
+    /// \brief Direct-mapped cache of the active functions of the
+    /// elements, one per thread (see elementActives())
+    struct activeCache
+    {
+        activeCache() : last(-1) { }
+
+        /// The entries, allocated on first use
+        std::vector<activeCacheEntry> entries;
+        /// The entry used last, -1 if none
+        index_t last;
+    };
+
+    /// \brief Number of elements kept in the cache of each thread
+    static const index_t activeCacheSize = 2048;
+
+    /// \brief The caches of the active functions, filled by
+    /// active_into() and numActive_into() and cleared by
+    /// update_structure().
+    mutable util::gsThreaded<activeCache> m_activeCache;
+
     //------------------------------------
 
 public:
@@ -890,6 +929,30 @@ protected:
     /// be called after any modifications.
     virtual void update_structure(); // to do: rename as updateCharMatrices
 
+    /// @brief Updates the basis structure after the domains \a boxes
+    /// (in the format of refineElements()) have been inserted.
+    ///
+    /// Only the functions whose support is near one of the boxes
+    /// can change their status (see functionsOnBoxes()), therefore
+    /// the characteristic matrices are updated only there.
+    ///
+    /// refine() and refineElements() call this function instead of
+    /// update_structure(). A derived class which updates its own data
+    /// in update_structure() has to override this function as well
+    /// (see gsTHBSplineBasis), otherwise its data is not updated after
+    /// these refinements. Calling update_structure() from the override
+    /// is always correct.
+    virtual void update_structure(std::vector<index_t> const & boxes);
+
+    /// @brief Computes, for every level, the (tensor-product) indices
+    /// of the functions whose status might change by inserting the
+    /// \a boxes, given in the format of refineElements(). These are
+    /// the functions of level up to the level of the box whose
+    /// support overlaps the elements of the previous level which
+    /// contain the box.
+    void functionsOnBoxes(std::vector<index_t> const & boxes,
+                          std::vector<CMatrix> & result) const;
+
     /// @brief Makes sure that there are \a numLevels grids computed
     /// in the hierarachy
     void needLevel(int maxLevel) const;
@@ -909,10 +972,34 @@ private:
 
     void initialize_class(gsBasis<T> const&  tbasis);
 
+    /// \brief Returns the active functions on the element containing
+    /// the point \a pt.
+    ///
+    /// The result is taken from the cache of the calling thread if
+    /// possible, and stored there otherwise. It is valid until the next
+    /// call from the same thread. In nested parallel regions no cache
+    /// is used and the result is computed into \a scratch.
+    ///
+    /// If the element lies in a single level, \a lower and \a upper
+    /// are set to its parameter box, so that the callers can reuse
+    /// the result for subsequent points inside the box without any
+    /// lookup. Otherwise, the box is set to be empty.
+    const std::vector<index_t> & elementActives(const gsMatrix<T> & pt,
+                                                gsVector<T,d> & lower,
+                                                gsVector<T,d> & upper,
+                                                std::vector<index_t> & scratch) const;
+
+    /// \brief Returns the cache of active functions of the calling
+    /// thread, or NULL if the thread cannot be identified
+    activeCache * localActiveCache() const;
+
+    /// \brief Empties the caches of active functions of all threads
+    void clearActiveCache() { m_activeCache = util::gsThreaded<activeCache>(); }
+
     /// \brief Returns the basis functions of \a level which have support on \a
     /// box, represented as an index box
     void functionOverlap(const point & boxLow, const point & boxUpp,
-                         const int level, point & actLow, point & actUpp);
+                         const int level, point & actLow, point & actUpp) const;
 
     // \brief Sets all functions of \a level to active or passive- one by one
     void set_activ1(int level);
@@ -81,33 +81,16 @@ template<short_t d, class T> inline
 void gsHTensorBasis<d,T>::numActive_into(const gsMatrix<T> & u, gsVector<index_t>& result) const
 {
     result.resize( u.cols() );
-    result.setZero();
-
-    point low, upp, cur;
-    const int maxLevel = m_tree.getMaxInsLevel();
 
+    gsVector<T,d> lower, upper;
+    std::vector<index_t> scratch;
     for(index_t p = 0; p < u.cols(); p++ ) //for all input points
     {
-        for(short_t i = 0; i != d; ++i)
-            low[i] = m_bases[maxLevel]->knots(i).uFind(u(i,p)).uIndex();
-
-        // Identify the level of the point
-        const int lvl = m_tree.levelOf(low, maxLevel);
-
-        for(int i = 0; i <= lvl; i++)
-        {
-            m_bases[i]->active_cwise(u.col(p), low, upp);
-            cur = low;
-            do //iterate over all points in [low,upp]
-            {
-                CMatrix::const_iterator it =
-                    m_xmatrix[i].find_it_or_fail( m_bases[i]->index(cur) );
-
-                if( it != m_xmatrix[i].end() )// if index is found
-                    result[p]++;
-            }
-            while( nextCubePoint(cur,low,upp) );
-        }
+        if ( p != 0 && ( lower.array() <= u.col(p).array() ).all()
+                    && ( u.col(p).array() < upper.array() ).all() )
+            result[p] = result[p-1];
+        else
+            result[p] = elementActives(u.col(p), lower, upper, scratch).size();
     }
 }
 
@@ -399,6 +382,9 @@ void gsHTensorBasis<d,T>::refine(gsMatrix<T> const & boxes)
 #endif
 
     gsVector<index_t,d> k1, k2;
+    // The sunk boxes, in the format of refineElements()
+    std::vector<index_t> sunk;
+    sunk.reserve( (2*d+1) * boxes.cols()/2 );
     for(index_t i = 0; i < boxes.cols()/2; i++)
     {
         // 1. Get a small cell containing the box
@@ -430,10 +416,17 @@ void gsHTensorBasis<d,T>::refine(gsMatrix<T> const & boxes)
         m_tree.sinkBox(k1, k2, fLevel);
         // Make sure we have enough levels
         needLevel( m_tree.getMaxInsLevel() );
+
+        // Sinking raises the levels around the box by at most one
+        sunk.push_back(fLevel+1);
+        for(short_t j = 0; j != d; ++j)
+            sunk.push_back(k1[j] << 1);
+        for(short_t j = 0; j != d; ++j)
+            sunk.push_back(k2[j] << 1);
     }
 
     // Update the basis
-    // update_structure();
+    update_structure(sunk);
 }
 
 template<short_t d, class T>
@@ -486,7 +479,7 @@ void gsHTensorBasis<d,T>::refineElements(std::vector<index_t> const & boxes)
         insert_box(i1,i2,boxes[i*(2*d+1)]);
     }
 
-    update_structure();
+    update_structure(boxes);
 }
 
 template<short_t d, class T>
@@ -654,7 +647,7 @@ void gsHTensorBasis<d,T>::set_activ1(int level)
 
 template<short_t d, class T>
 void gsHTensorBasis<d,T>::functionOverlap(const point & boxLow, const point & boxUpp,
-                                          const int level, point & actLow, point & actUpp)
+                                          const int level, point & actLow, point & actUpp) const
 {
     const tensorBasis & tb = *m_bases[level];
     for(short_t i = 0; i != d; ++i)
@@ -887,6 +880,9 @@ void gsHTensorBasis<d,T>::update_structure() // to do: rename as updateHook
     // Make sure we have computed enough levels
     needLevel( m_tree.getMaxInsLevel() );
 
+    // The cached active functions refer to the old structure
+    clearActiveCache();
+
     // Setup the characteristic matrices
     m_xmatrix.clear();
     m_xmatrix.resize( m_bases.size() );
@@ -911,6 +907,128 @@ void gsHTensorBasis<d,T>::update_structure() // to do: rename as updateHook
     }
 }
 
+template<short_t d, class T>
+void gsHTensorBasis<d,T>::update_structure(std::vector<index_t> const & boxes)
+{
+    // Make sure we have computed enough levels
+    needLevel( m_tree.getMaxInsLevel() );
+
+    // The cached active functions refer to the old structure
+    clearActiveCache();
+
+    // New levels start without active functions
+    m_xmatrix.resize( m_bases.size() );
+
+    // Compress the tree
+    m_tree.makeCompressed();
+
+    // Functions which might have changed their status
+    std::vector<CMatrix> affected;
+    functionsOnBoxes(boxes, affected);
+
+    gsMatrix<index_t,d,2> supp;
+    point low, upp;
+    CMatrix merged;
+    for(size_t lvl = 0; lvl != m_xmatrix.size(); ++lvl)
+    {
+        const CMatrix & aff = affected[lvl];
+        if ( aff.empty() ) continue;
+
+        // Merge the unaffected entries with the re-checked ones
+        CMatrix & cmat = m_xmatrix[lvl];
+        merged.clear();
+        merged.reserve( cmat.size() + aff.size() );
+        cmatIterator it = cmat.begin(), end = cmat.end();
+        for(cmatIterator a = aff.begin(); a != aff.end(); ++a)
+        {
+            for(; it != end && *it < *a; ++it)
+                merged.push_back(*it);
+            if ( it != end && *it == *a )
+                ++it;
+
+            m_bases[lvl]->elementSupport_into(*a, supp);
+            low = supp.col(0);
+            upp = supp.col(1);
+            if ( m_tree.query3(low, upp, lvl) == static_cast<int>(lvl) ) //if active
+                merged.push_back(*a);
+        }
+        merged.insert(merged.end(), it, end);
+        cmat.swap(merged);
+    }
+
+    // Compute offsets
+    m_xmatrix_offset.clear();
+    m_xmatrix_offset.reserve(m_xmatrix.size()+1);
+    m_xmatrix_offset.push_back(0);
+    for (size_t i = 0; i != m_xmatrix.size(); i++)
+    {
+        m_xmatrix_offset.push_back(
+            m_xmatrix_offset.back() + m_xmatrix[i].size() );
+    }
+}
+
+template<short_t d, class T>
+void gsHTensorBasis<d,T>::functionsOnBoxes(std::vector<index_t> const & boxes,
+                                           std::vector<CMatrix> & result) const
+{
+    GISMO_ASSERT( (boxes.size()%(2*d + 1))==0,
+                  "The points did not define boxes properly.");
+
+    result.clear();
+    result.resize( m_bases.size() );
+
+    point low, upp, actLow, actUpp, curr;
+    for(size_t i = 0; i < boxes.size(); i += 2*d+1)
+    {
+        const index_t bLevel = boxes[i];
+        const index_t top    = math::min(bLevel, static_cast<index_t>(m_bases.size())-1);
+        for(index_t lvl = 0; lvl <= top; ++lvl)
+        {
+            const tensorBasis & tb = *m_bases[lvl];
+
+            // The tree splits the leaves along the elements of their
+            // own level, hence the status of the functions of level
+            // lvl can change only on the elements of level lvl-1
+            // which contain the box
+            const index_t grid  = math::max<index_t>(lvl-1, 0);
+            const index_t shift = bLevel - grid;
+            const index_t h     = static_cast<index_t>(1) << shift;
+            bool empty = false;
+            for(short_t j = 0; j != d; ++j)
+            {
+                const index_t nEl = tb.knots(j).numElements();
+                low[j] = math::min<index_t>( (boxes[i+j+1] >> shift)
+                                             << (lvl-grid), nEl);
+                upp[j] = math::min<index_t>( ((boxes[i+d+j+1] + h - 1) >> shift)
+                                             << (lvl-grid), nEl);
+                empty = empty || low[j] >= upp[j];
+            }
+            if ( empty ) continue;
+
+            functionOverlap(low, upp, lvl, actLow, actUpp);
+            for(short_t j = 0; j != d; ++j)
+            {
+                actLow[j] = math::max<index_t>(actLow[j], 0);
+                actUpp[j] = math::min<index_t>(actUpp[j], tb.size(j)-1);
+            }
+
+            curr = actLow;
+            do
+            {
+                result[lvl].push_unsorted( tb.index(curr) );
+            }
+            while ( nextCubePoint(curr, actLow, actUpp) );
+        }
+    }
+
+    for(size_t lvl = 0; lvl != result.size(); ++lvl)
+    {
+        CMatrix & cmat = result[lvl];
+        cmat.sort();
+        cmat.erase( std::unique(cmat.begin(), cmat.end()), cmat.end() );
+    }
+}
+
 template<short_t d, class T>
 void gsHTensorBasis<d,T>::needLevel(int maxLevel) const
 {
@@ -965,68 +1083,161 @@ void gsHTensorBasis<d,T>::initialize_class(gsBasis<T> const&  tbasis)
 
 
 template<short_t d, class T>
-void gsHTensorBasis<d,T>::active_into(const gsMatrix<T> & u, gsMatrix<index_t>& result) const
+typename gsHTensorBasis<d,T>::activeCache *
+gsHTensorBasis<d,T>::localActiveCache() const
+{
+#   ifdef _OPENMP
+    // In nested regions the thread number does not identify the
+    // calling thread, so the caches of the object cannot be used
+    if ( omp_get_level() > 1 ||
+         omp_get_thread_num() >= static_cast<int>(m_activeCache.size()) )
+        return NULL;
+#   endif
+    activeCache & cache = m_activeCache.mine();
+    if ( cache.entries.empty() )
+        cache.entries.resize(activeCacheSize);
+    return &cache;
+}
+
+template<short_t d, class T>
+const std::vector<index_t> &
+gsHTensorBasis<d,T>::elementActives(const gsMatrix<T> & pt,
+                                    gsVector<T,d> & lower,
+                                    gsVector<T,d> & upper,
+                                    std::vector<index_t> & scratch) const
 {
-    gsMatrix<T> currPoint;
+    activeCache * cache = localActiveCache();
+
+    // The element of the previous call, e.g. when the values and the
+    // derivatives are evaluated at the same points, is found without
+    // any search
+    if ( NULL != cache && -1 != cache->last )
+    {
+        const activeCacheEntry & e = cache->entries[cache->last];
+        short_t i = 0;
+        while ( i != d && e.lower[i] <= pt(i,0) && pt(i,0) < e.upper[i] )
+            ++i;
+        if ( d == i )
+        {
+            lower = gsAsConstVector<T>(e.lower, d);
+            upper = gsAsConstVector<T>(e.upper, d);
+            return e.actives;
+        }
+    }
+
     point low, upp, cur;
     const int maxLevel = m_tree.getMaxInsLevel();
 
-    std::vector<std::vector<index_t> > temp_output;//collects the outputs
-    temp_output.resize( u.cols() );
-    size_t sz = 0;
+    for(short_t i = 0; i != d; ++i)
+        low[i] = m_bases[maxLevel]->knots(i).uFind( pt(i,0) ).uIndex();
 
-    //gsMatrix<index_t> activesLvl;
+    // Identify the level of the point
+    const int lvl = m_tree.levelOf(low, maxLevel);
 
-    for(index_t p = 0; p < u.cols(); p++) //for all input points
+    // The element is the cell of level lvl containing the point
+    size_t cell = 0, stride = 1;
+    for(short_t i = 0; i != d; ++i)
     {
-        currPoint = u.col(p);
-        for(short_t i = 0; i != d; ++i)
-            low[i] = m_bases[maxLevel]->knots(i).uFind( currPoint(i,0) ).uIndex();
+        const gsKnotVector<T> & kv = m_bases[lvl]->knots(i);
+        typename gsKnotVector<T>::uiterator it = kv.uFind( pt(i,0) );
+        low[i]   = it.uIndex();
+        upp[i]   = low[i] + 1;
+        lower[i] = *it;
+        // The last element is closed from both sides
+        upper[i] = ( it + 1 == kv.domainUEnd() ? std::numeric_limits<T>::max() : *(it+1) );
+        cell    += stride * low[i];
+        stride  *= kv.uSize();
+    }
 
-        // Identify the level of the point
-        const int lvl = m_tree.levelOf(low, maxLevel);
+    activeCacheEntry * e = NULL;
+    if ( NULL != cache )
+    {
+        cache->last = ( cell + 7919 * lvl ) % activeCacheSize;
+        e = &cache->entries[cache->last];
+        if ( e->level == lvl && e->cell == cell ) // cache hit
+        {
+            lower = gsAsConstVector<T>(e->lower, d);
+            upper = gsAsConstVector<T>(e->upper, d);
+            return e->actives;
+        }
+    }
+
+    // Parts of the element are refined further
+    if ( m_tree.query4(low, upp, lvl) != lvl )
+    {
+        lower.setConstant(1);
+        upper.setZero();
+    }
 
-        for(int i = 0; i <= lvl; i++)
+    std::vector<index_t> & actives = ( NULL != e ? e->actives : scratch );
+    actives.clear();
+    for(int i = 0; i <= lvl; i++)
+    {
+        m_bases[i]->active_cwise(pt, low, upp);
+        cur = low;
+        do
         {
-            /*
-              m_bases[i]->active_into(currPoint, activesLvl);
-
-              std::set_intersection(m_xmatrix[i].begin(), m_xmatrix[i].end(),
-              activesLvl.data(), activesLvl.data() + activesLvl.size(),
-              std::back_inserter( temp_output[p] ) );
-              +++ Renumbering to H-basis indexing
-            // */
-
-            // /*
-            m_bases[i]->active_cwise(currPoint, low, upp);
-            cur = low;
-            do
-            {
-                CMatrix::const_iterator it =
-                    m_xmatrix[i].find_it_or_fail( m_bases[i]->index(cur) );
+            CMatrix::const_iterator xit =
+                m_xmatrix[i].find_it_or_fail( m_bases[i]->index(cur) );
 
-                if( it != m_xmatrix[i].end() )// if index is found
-                {
-                    temp_output[p].push_back(
-                        this->m_xmatrix_offset[i] + (it - m_xmatrix[i].begin() )
-                        );
-                }
+            if( xit != m_xmatrix[i].end() )// if index is found
+            {
+                actives.push_back(
+                    this->m_xmatrix_offset[i] + (xit - m_xmatrix[i].begin() )
+                    );
             }
-            while( nextCubePoint(cur,low,upp) );
-            //*/
         }
+        while( nextCubePoint(cur,low,upp) );
+    }
+
+    if ( NULL != e )
+    {
+        e->level = lvl;
+        e->cell  = cell;
+        gsAsVector<T>(e->lower, d) = lower;
+        gsAsVector<T>(e->upper, d) = upper;
+    }
+    return actives;
+}
+
+template<short_t d, class T>
+void gsHTensorBasis<d,T>::active_into(const gsMatrix<T> & u, gsMatrix<index_t>& result) const
+{
+    // The active functions of the elements visited are collected one
+    // after the other in actives; the ones of point p start at first[p]
+    std::vector<index_t> actives, scratch;
+    std::vector<size_t> first(u.cols()), count(u.cols());
+    gsVector<T,d> lower, upper;
+    size_t sz = 0;
+
+    for(index_t p = 0; p < u.cols(); p++) //for all input points
+    {
+        // Consecutive points in one element, e.g. the quadrature
+        // nodes, share the active functions
+        if ( p != 0 && ( lower.array() <= u.col(p).array() ).all()
+                    && ( u.col(p).array() < upper.array() ).all() )
+        {
+            first[p] = first[p-1];
+            count[p] = count[p-1];
+            continue;
+        }
+
+        const std::vector<index_t> & act = elementActives(u.col(p), lower, upper, scratch);
+        first[p] = actives.size();
+        count[p] = act.size();
+        actives.insert(actives.end(), act.begin(), act.end());
 
         // update result size
-        if ( temp_output[p].size() > sz )
-            sz = temp_output[p].size();
+        if ( act.size() > sz )
+            sz = act.size();
     }
 
     result.resize(sz, u.cols() );
     for(index_t i = 0; i < result.cols(); i++)
     {
-        result.col(i).topRows(temp_output[i].size())
-            = gsAsConstVector<index_t>(temp_output[i]);
-        result.col(i).bottomRows(sz-temp_output[i].size()).setZero();
+        result.col(i).topRows(count[i]) =
+            gsAsConstVector<index_t>(actives.data() + first[i], count[i]);
+        result.col(i).bottomRows(sz-count[i]).setZero();
     }
 }
 
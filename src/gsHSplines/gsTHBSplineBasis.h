@@ -405,9 +405,25 @@ private:
         }
     }
 
+    /// @brief Evaluates the \a n-th derivatives (n=0,1,2) of all
+    /// active functions at the points \a u, in the layout of
+    /// eval_into(), deriv_into() and deriv2_into() respectively.
+    ///
+    /// Consecutive points with the same active functions are
+    /// processed together: the tensor-product B-splines of each
+    /// involved level are evaluated once for all of them and the
+    /// truncation is applied as a product with the (sparse)
+    /// presentation coefficients.
+    void _evalDer_into(const gsMatrix<T> & u, const int n,
+                       gsMatrix<T> & result) const;
+
     /// @brief Computes and saves representation of all basis functions.
     void representBasis(); // rename: precompute coeffs
 
+    /// @brief Computes and saves the truncation level and the
+    /// representation of the j-th basis function.
+    void representBasisFunction(const index_t j);
+
 
     /// @brief Computes representation of j-th basis function on pres_level and
     /// saves it.
@@ -608,6 +624,13 @@ private:
         representBasis();
     }
 
+    /**
+     * @brief Updates the structure after the domains \a boxes have
+     * been inserted. The presentations of the functions which are
+     * not affected by the boxes are kept.
+    **/
+    void update_structure(std::vector<index_t> const & boxes);
+
     /**
       @brief Returns a representation of \a thbCoefs as tensor-product
       B-spline coefficientes \a lvlCoefs at level \a level.
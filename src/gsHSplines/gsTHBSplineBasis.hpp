@@ -53,37 +53,98 @@ void gsTHBSplineBasis<d,T>::representBasis()
     this->m_is_truncated.resize(this->size());
     m_presentation.clear();
 
+    for (index_t j = 0; j < this->size(); ++j)
+        representBasisFunction(j);
+}
+
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::representBasisFunction(const index_t j)
+{
     gsMatrix<index_t, d, 2> element_ind(d, 2);
     point low, high;
-    for (index_t j = 0; j < this->size(); ++j)
-    {
-        index_t level = this->levelOf(j);
-        index_t tensor_index = this->flatTensorIndexOf(j, level);
 
-        // element indices
-        this->m_bases[level]->elementSupport_into(tensor_index, element_ind);
+    index_t level = this->levelOf(j);
+    index_t tensor_index = this->flatTensorIndexOf(j, level);
 
-        // I tried with block, I can not trick the compiler to use references
-        low = element_ind.col(0); //block<d, 1>(0, 0);
-        high = element_ind.col(1); //block<d, 1>(0, 1);
+    // element indices
+    this->m_bases[level]->elementSupport_into(tensor_index, element_ind);
 
-        // Finds coarsest level that function, with supports given with
-        // support indices of the coarsest level (low & high), has presentation
-        // based only on B-Splines (and not THB-Splines).
-        // this is not the same as query 3
-        index_t clevel = this->m_tree.query4(low, high, level);
+    // I tried with block, I can not trick the compiler to use references
+    low = element_ind.col(0); //block<d, 1>(0, 0);
+    high = element_ind.col(1); //block<d, 1>(0, 1);
 
-        if (level != clevel) // we must compute its presentation
-        {
-            this->m_tree.computeFinestIndex(low, level, low);
-            this->m_tree.computeFinestIndex(high, level, high);
+    // Finds coarsest level that function, with supports given with
+    // support indices of the coarsest level (low & high), has presentation
+    // based only on B-Splines (and not THB-Splines).
+    // this is not the same as query 3
+    index_t clevel = this->m_tree.query4(low, high, level);
 
-            this->m_is_truncated[j] = clevel;
-            _representBasisFunction(j, clevel, low, high);
-        }
-        else
+    if (level != clevel) // we must compute its presentation
+    {
+        this->m_tree.computeFinestIndex(low, level, low);
+        this->m_tree.computeFinestIndex(high, level, high);
+
+        this->m_is_truncated[j] = clevel;
+        _representBasisFunction(j, clevel, low, high);
+    }
+    else
+    {
+        this->m_is_truncated[j] = -1;
+    }
+}
+
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::update_structure(std::vector<index_t> const & boxes)
+{
+    // Keep the old indexing, to carry over the presentations of the
+    // functions which are not affected by the refinement
+    const std::vector<CMatrix> oldXmatrix = this->m_xmatrix;
+    const std::vector<index_t> oldOffset  = this->m_xmatrix_offset;
+    const gsVector<int> oldTruncated      = m_is_truncated;
+    std::map<index_t, gsSparseVector<T> > oldPresentation;
+    oldPresentation.swap(m_presentation);
+
+    gsHTensorBasis<d,T>::update_structure(boxes);
+
+    // The functions whose truncation might have changed
+    std::vector<CMatrix> affected;
+    this->functionsOnBoxes(boxes, affected);
+
+    m_is_truncated.resize(this->size());
+    for (size_t lvl = 0; lvl != this->m_xmatrix.size(); ++lvl)
+    {
+        const CMatrix & cmat = this->m_xmatrix[lvl];
+        const CMatrix & aff  = affected[lvl];
+        cmatIterator a = aff.begin();
+        const bool oldLevel = lvl < oldXmatrix.size();
+        cmatIterator o    = oldLevel ? oldXmatrix[lvl].begin() : cmat.end();
+        cmatIterator oEnd = oldLevel ? oldXmatrix[lvl].end()   : cmat.end();
+
+        for (size_t i = 0; i != cmat.size(); ++i)
         {
-            this->m_is_truncated[j] = -1;
+            const index_t j = this->m_xmatrix_offset[lvl] + i;
+            for (; a != aff.end() && *a < cmat[i]; ++a) {}
+            if (a != aff.end() && *a == cmat[i])
+            {
+                representBasisFunction(j);
+                continue;
+            }
+
+            // Unaffected functions were active before the refinement
+            for (; o != oEnd && *o < cmat[i]; ++o) {}
+            GISMO_ASSERT(o != oEnd && *o == cmat[i], "Function was not active before refinement.");
+            if (o == oEnd || *o != cmat[i])
+            {
+                representBasisFunction(j);
+                continue;
+            }
+            const index_t oldj = oldOffset[lvl] + (o - oldXmatrix[lvl].begin());
+
+            m_is_truncated[j] = oldTruncated[oldj];
+            if (-1 != m_is_truncated[j])
+                m_presentation.insert(m_presentation.end(),
+                    std::make_pair(j, gsSparseVector<T>()))->second.swap(
+                        oldPresentation[oldj]);
         }
     }
 }
@@ -1065,76 +1126,129 @@ void gsTHBSplineBasis<d,T>::deriv2Single_into(index_t i,
 template<short_t d, class T>
 void gsTHBSplineBasis<d,T>::eval_into(const gsMatrix<T> & u, gsMatrix<T>& result) const
 {
-    gsMatrix<index_t> indices;
-    gsMatrix<T> res(1, 1);
-    this->active_into(u, indices);
-
-    result.setZero(indices.rows(), u.cols());
-
-    for (index_t i = 0; i < indices.cols(); i++)
-    {
-        for (index_t j = 0; j < indices.rows(); j++)
-        {
-            const index_t index = indices(j, i);
-            if (j != 0 && index == 0)
-                break;
-
-            evalSingle_into(index, u.col(i), res);
-            result(j, i) = res.value();
-        }
-    }
+    _evalDer_into(u, 0, result);
 }
 
 
 template<short_t d, class T>
 void gsTHBSplineBasis<d,T>::deriv2_into(const gsMatrix<T>& u, gsMatrix<T>& result)const
 {
-    gsMatrix<index_t> indices;
-    this->active_into(u, indices);
-
-    static const short_t numDers = (d * (d + 1)) / 2;
-    gsMatrix<T> res(numDers, 1); // result of deriv2Single_into
-
-    result.setZero(indices.rows() * numDers, u.cols());
-
-    for (int i = 0; i < indices.cols(); i++)
-    {
-        for (int j = 0; j < indices.rows(); j++)
-        {
-            const index_t index = indices(j, i);
-            if (j != 0 && index == 0)
-                break;
+    _evalDer_into(u, 2, result);
+}
 
-            this->deriv2Single_into(index, u.col(i), res);
 
-            result.template block<numDers, 1>(j * numDers, i) = res;
-        }
-    }
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::deriv_into(const gsMatrix<T>& u, gsMatrix<T>& result) const
+{
+    _evalDer_into(u, 1, result);
 }
 
 
 template<short_t d, class T>
-void gsTHBSplineBasis<d,T>::deriv_into(const gsMatrix<T>& u, gsMatrix<T>& result) const
+void gsTHBSplineBasis<d,T>::_evalDer_into(const gsMatrix<T> & u,
+                                          const int n,
+                                          gsMatrix<T>& result) const
 {
+    GISMO_ASSERT(n >= 0 && n <= 2, "Derivative order "<< n <<" not supported");
+    const index_t stride = (0 == n ? 1 : (1 == n ? d : (d * (d + 1)) / 2) );
 
     gsMatrix<index_t> indices;
     this->active_into(u, indices);
-    gsMatrix<T> res(d, 1);
 
-    result.setZero(indices.rows() * d, u.cols());
+    result.setZero(indices.rows() * stride, u.cols());
 
-    for (int i = 0; i < indices.cols(); i++)
+    const index_t maxLvl = this->m_tree.getMaxInsLevel() + 1;
+    std::vector< gsMatrix<T> > lvlVal(maxLvl);     // tensor values per level
+    std::vector< gsMatrix<index_t> > lvlAct(maxLvl); // tensor actives per level
+    gsVector<index_t> lvlState(maxLvl); // 0: not computed, 1: different
+                                        // actives per point, 2: same actives
+    gsMatrix<T> uBlock;
+    gsVector<T> cf; // truncation coefficients restricted to the actives
+
+    index_t pt = 0;
+    while ( pt != u.cols() )
     {
-        for (int j = 0; j < indices.rows(); j++)
+        // Group of consecutive points with the same active functions,
+        // typically the quadrature nodes of one element
+        index_t np = 1;
+        while ( pt + np != u.cols() && indices.col(pt + np) == indices.col(pt) )
+            ++np;
+        uBlock = u.middleCols(pt, np);
+        lvlState.setZero();
+
+        for (index_t j = 0; j != indices.rows(); ++j)
         {
-
-            const unsigned index = indices(j, i);
+            const index_t index = indices(j, pt);
             if (j != 0 && index == 0)
                 break;
 
-            this->derivSingle_into(index, u.col(i), res);
-            result.template block<d,1>(j * d, i) = res;
+            const index_t lvl = getPresLevelOfBasisFun(index);
+            gsMatrix<T> & val = lvlVal[lvl];
+            gsMatrix<index_t> & act = lvlAct[lvl];
+
+            // Tensor-product values of this level, once per group
+            if ( 0 == lvlState[lvl] )
+            {
+                const gsTensorBSplineBasis<d,T> & base = *this->m_bases[lvl];
+                switch (n)
+                {
+                case 0 : base.eval_into  (uBlock, val); break;
+                case 1 : base.deriv_into (uBlock, val); break;
+                default: base.deriv2_into(uBlock, val); break;
+                }
+                base.active_into(uBlock, act);
+                lvlState[lvl] = 2;
+                for (index_t c = 1; c != np; ++c)
+                    if ( act.col(c) != act.col(0) )
+                    {
+                        lvlState[lvl] = 1;
+                        break;
+                    }
+            }
+
+            // Actives are shared by all points of the group
+            const bool shared = (2 == lvlState[lvl]);
+            const index_t numAct = act.rows();
+            if (m_is_truncated[index] == -1)
+            {
+                const index_t flatTenIndx = this->flatTensorIndexOf(index, lvl);
+                index_t r = 0;
+                for (index_t c = 0; c != np; ++c)
+                {
+                    if ( 0 == c || !shared )
+                    {
+                        r = 0;
+                        while ( r != numAct && act(r, c) != flatTenIndx ) ++r;
+                        GISMO_ASSERT(r != numAct, "Function "<< index <<" is not active");
+                    }
+                    result.block(j * stride, pt + c, stride, 1) =
+                        val.block(r * stride, c, stride, 1);
+                }
+            }
+            else // basis function is truncated
+            {
+                const gsSparseVector<T> & coefs = getCoefs(index);
+                for (index_t c = 0; c != np; ++c)
+                {
+                    if ( 0 == c || !shared )
+                    {
+                        cf.resize(numAct);
+                        for (index_t i = 0; i != numAct; ++i)
+                            cf[i] = coefs.coeff(act(i, c));
+                    }
+
+                    for (index_t k = 0; k != stride; ++k)
+                    {
+                        T tmp = 0;
+                        for (index_t i = 0; i != numAct; ++i)
+                            tmp += cf[i] * val(i * stride + k, c);
+                        result(j * stride + k, pt + c) = tmp;
+                    }
+                }
+            }
         }
+
+        pt += np;
     }
 }
 
@@ -58,6 +58,22 @@ public:
      */
     bool read(String const & fn) ;
 
+    /**
+     * Opens a G+Smo XML file for lazy reading: the file is mapped to
+     * memory and only its top-level objects are indexed by tag, type
+     * and id. An object is parsed when it is first requested, eg. by
+     * getId() or getFirst(), so fetching a single object from a large
+     * file does not load the whole file.
+     *
+     * Compressed files and other formats are read completely, as by
+     * read().
+     *
+     * @param fn filename string
+     *
+     * Returns true on success, false on failure.
+     */
+    bool readLazy(String const & fn);
+
     ~gsFileData();
 
     /// \brief Clear all data
@@ -93,6 +109,15 @@ public:
     /// to a 64-bit double.
     unsigned getFloatPrecision() const { return data->getFloatPrecision(); }
 
+    /// If true, the entries of real-valued matrices (eg. control
+    /// points) and sparse matrices that are added afterwards are
+    /// written as base64-encoded 64-bit floats instead of text. Such
+    /// files are smaller, faster to read and are read transparently.
+    void setBinaryMatrices(const bool b = true) { data->setBinaryMatrices(b); }
+
+    /// Returns true if matrices are written as binary data
+    bool getBinaryMatrices() const { return data->getBinaryMatrices(); }
+
 private:
     /// File data as an xml tree
     FileData * data;
@@ -103,6 +128,9 @@ private:
     // Holds the last path that was used in an I/O operation
     mutable String m_lastPath;
 
+    // Index of the file which is read lazily, or NULL
+    internal::gsXmlLazyFile * m_lazy;
+
 protected:
 
 /*
@@ -171,6 +199,7 @@ public:
     template<class Object>
     inline memory::unique_ptr<Object> getId( const int & id)  const
     {
+        if ( m_lazy ) m_lazy->loadId(id, *data);
         return memory::make_unique( internal::gsXml<Object>::getId( getXmlRoot(), id ) );
     }
 
@@ -213,6 +242,8 @@ public:
     template<class Object>
     inline int count() const
     {
+        lazyLoad( internal::gsXml<Object>::tag(),
+                  internal::gsXml<Object>::type() );
         int i(0);
         for (gsXmlNode * child = getFirstNode( internal::gsXml<Object>::tag(),
                                                internal::gsXml<Object>::type() ) ;
@@ -342,6 +373,8 @@ public:
     {
         std::vector< memory::unique_ptr<Object> > result;
 
+        lazyLoad( internal::gsXml<Object>::tag(),
+                  internal::gsXml<Object>::type() );
         for (gsXmlNode * child = getFirstNode( internal::gsXml<Object>::tag(),
                                                internal::gsXml<Object>::type() ) ;
              child; child = getNextSibling(child, internal::gsXml<Object>::tag(),
@@ -419,6 +452,11 @@ private:
     gsXmlNode * getXmlRoot() const;
     static void deleteXmlSubtree (gsXmlNode* node);
 
+    // Parses all nodes with the given tag and type (all nodes, if
+    // empty) when the file is read lazily
+    void lazyLoad( const String & name = "", const String & type = "" ) const
+    { if ( m_lazy ) m_lazy->loadTag(name, type, *data, true); }
+
     // getFirst ? (tag and or type)
     gsXmlNode * getFirstNode  ( const String & name = "",
                                 const String & type = "" ) const;
@@ -44,6 +44,7 @@ namespace gismo {
 
 template<class T>
 gsFileData<T>::gsFileData()
+: m_lazy(NULL)
 {
     data = new FileData;
     data->makeRoot();
@@ -51,6 +52,7 @@ gsFileData<T>::gsFileData()
 
 template<class T>
 gsFileData<T>::gsFileData(String const & fn)
+: m_lazy(NULL)
 {
     data = new FileData;
     data->makeRoot();
@@ -60,6 +62,7 @@ gsFileData<T>::gsFileData(String const & fn)
 template<class T>
 gsFileData<T>::~gsFileData()
 {
+    delete m_lazy;
     data->clear();
     delete data;
 }
@@ -68,6 +71,8 @@ gsFileData<T>::~gsFileData()
 template<class T> void
 gsFileData<T>::clear()
 {
+    delete m_lazy;
+    m_lazy = NULL;
     data->clear();
     data->makeRoot(); // ready to re-use
 }
@@ -76,6 +81,7 @@ gsFileData<T>::clear()
 template<class T>
 std::ostream & gsFileData<T>::print(std::ostream &os) const
 {
+    lazyLoad();
     //rapidxml::print_no_indenting
     os<< *data;
     return os;
@@ -97,6 +103,7 @@ gsFileData<T>::addComment(std::string const & message)
 template<class T> void
 gsFileData<T>::save(std::string const & fname, bool compress)  const
 {
+    lazyLoad();
     gsXmlNode * comment = internal::makeComment("This file was created by G+Smo "
                                                 GISMO_VERSION, *data);
     data->prepend_node(comment);
@@ -126,6 +133,7 @@ gsFileData<T>::save(std::string const & fname, bool compress)  const
 template<class T> void
 gsFileData<T>::saveCompressed(std::string const & fname)  const
 {
+    lazyLoad();
     String tmp = gsFileManager::getExtension(fname);
     if (tmp != "gz" )
     {
@@ -157,6 +165,8 @@ gsFileData<T>::ioError(int lineNumber, const std::string& str)
 template<class T>
 bool gsFileData<T>::read(String const & fn)
 {
+    if ( m_lazy )
+        clear();
 
     m_lastPath = gsFileManager::find(fn);
     if ( m_lastPath.empty() )
@@ -220,6 +230,30 @@ bool gsFileData<T>::read(String const & fn)
     }
 }
 
+template<class T>
+bool gsFileData<T>::readLazy(String const & fn)
+{
+    m_lastPath = gsFileManager::find(fn);
+    if ( m_lastPath.empty() )
+    {
+        gsWarn<<"gsFileData: Problem with file "<<fn<<": File not found.\n";
+        gsWarn<<"search paths: "<< gsFileManager::getSearchPaths()<<"\n";
+        return false;
+    }
+
+    if ( gsFileManager::getExtension(fn) == "xml" )
+    {
+        clear();
+        m_lazy = new internal::gsXmlLazyFile;
+        if ( m_lazy->open(m_lastPath) )
+            return true;
+        delete m_lazy;
+        m_lazy = NULL;
+    }
+
+    return read(fn);
+}
+
 /*---------- Native Gismo format */
 
 template<class T>
@@ -1817,6 +1851,7 @@ template<class T>
 std::string
 gsFileData<T>::contents () const
 {
+    lazyLoad();
     std::ostringstream os;
     os << "--- \n";
     int i(1);
@@ -1836,6 +1871,7 @@ gsFileData<T>::contents () const
 template<class T> inline
 int gsFileData<T>::numTags() const
 {
+    lazyLoad();
     int i(0);
     for (gsXmlNode * child = data->first_node("xml")->first_node() ;
          child; child = child->next_sibling() )
@@ -1862,6 +1898,7 @@ template<class T> inline
 typename gsFileData<T>::gsXmlNode *
 gsFileData<T>::getFirstNode(const std::string & name, const std::string & type) const
 {
+    if ( m_lazy ) m_lazy->loadTag(name, type, *data);
     gsXmlNode * root = data->first_node("xml");
     if ( ! root )
     {
@@ -1886,6 +1923,7 @@ template<class T> inline
 typename gsFileData<T>::gsXmlNode *
 gsFileData<T>::getAnyFirstNode(const std::string & name, const std::string & type) const
 {
+    lazyLoad();
     gsXmlNode * root = data->first_node("xml");
     assert( root ) ;
     if ( type == "" )
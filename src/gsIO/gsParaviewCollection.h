@@ -127,6 +127,121 @@ private:
     gsParaviewCollection();
 };
 
+/**
+    \brief This class is used to create a Paraview .vtm (multi-block)
+    file.
+
+    A multi-block file groups the files of the patches of a
+    multi-patch object into one (partitioned) dataset, which appears
+    as a single item in Paraview. Since it is a single file, it can
+    be used as one step of a time series (see
+    gsParaviewCollection::addTimestep).
+
+    Typical usage is
+    \verbatim
+    gsParaviewMultiBlock mb(fn);
+    mb.newBlock("Solution");
+    mb.addPart(fn, 0, ".vts"); // the file fn0.vts
+    mb.addPart(fn, 1, ".vts");
+    mb.newBlock("Mesh");
+    mb.addPart(fn + "0_mesh", ".vtp");
+    ...
+    mb.save() // writes fn.vtm
+    \endverbatim
+
+    \ingroup IO
+*/
+class gsParaviewMultiBlock
+{
+public:
+    typedef std::string String;
+public:
+
+    /// Constructor using a filename.
+    gsParaviewMultiBlock(std::string const & fn)
+    : mfn(fn), block(-1), counter(0)
+    {
+        // Parts are stored relative to the location of the .vtm file
+        const String::size_type sep = fn.find_last_of("/\\");
+        mpath = ( sep == String::npos ? 0 : sep + 1 );
+
+        mfile <<"<?xml version=\"1.0\"?>\n";
+        mfile <<"<VTKFile type=\"vtkMultiBlockDataSet\" version=\"1.0\">\n";
+        mfile <<"<vtkMultiBlockDataSet>\n";
+    }
+
+    /// Starts a new block named \a name, the parts added afterwards
+    /// belong to this block
+    void newBlock(String const & name)
+    {
+        GISMO_ASSERT(counter!=-1, "Error: multi-block file has been already saved." );
+        if ( -1 != block )
+            mfile <<"</Block>\n";
+        mfile <<"<Block index=\""<< ++block <<"\" name=\""<< name <<"\">\n";
+        counter = 0;
+    }
+
+    /// Adds a part in the current block, with filename \a fn with extension \a ext appended
+    void addPart(String const & fn, String const & ext)
+    {
+        GISMO_ASSERT(counter!=-1, "Error: multi-block file has been already saved." );
+        if ( -1 == block ) newBlock("Block");
+        mfile << "<DataSet index=\""<<counter++<<"\" file=\""<<relative(fn)<<ext<<"\"/>\n";
+    }
+
+    /// Adds a part in the current block, with filename \a fni and extension \a ext appended
+    void addPart(String const & fn, int i, String const & ext)
+    {
+        GISMO_ASSERT(counter!=-1, "Error: multi-block file has been already saved." );
+        if ( -1 == block ) newBlock("Block");
+        mfile << "<DataSet index=\""<<counter++<<"\" name=\"Patch "<<i<<"\" file=\""
+              <<relative(fn)<<i<<ext<<"\"/>\n";
+    }
+
+    /// Finalizes the file by closing the XML tags, always call
+    /// this function (once) when you finish adding files
+    void save()
+    {
+        GISMO_ASSERT(counter!=-1, "Error: gsParaviewMultiBlock::save() already called." );
+        if ( -1 != block )
+            mfile <<"</Block>\n";
+        mfile <<"</vtkMultiBlockDataSet>\n";
+        mfile <<"</VTKFile>\n";
+
+        mfn.append(".vtm");
+        std::ofstream f( mfn.c_str() );
+        GISMO_ASSERT(f.is_open(), "Error creating "<< mfn );
+        f << mfile.rdbuf();
+        f.close();
+        mfile.str("");
+        counter = -1;
+    }
+
+private:
+    String relative(String const & fn) const
+    { return fn.compare(0, mpath, mfn, 0, mpath) ? fn : fn.substr(mpath); }
+
+private:
+    /// Pointer to char stream
+    std::stringstream mfile;
+
+    /// File name
+    String mfn;
+
+    /// Length of the directory part of the file name
+    String::size_type mpath;
+
+    /// Index of the current block
+    int block;
+
+    /// Counter for the number of parts (files) added in the current block
+    int counter;
+
+private:
+    // Construction without a filename is not allowed
+    gsParaviewMultiBlock();
+};
+
 /// Fast creation of a collection using base filename \a fn, extension
 /// \a ext.  The collection will contain the files fn_0.ext,
 /// fn_1.ext,...,fn_{n-1}.ext In the special case of n=0, the
@@ -0,0 +1,183 @@
+/** @file gsParaviewFormat.cpp
+
+    @brief Provides implementation of the data array writer of Paraview files.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsIO/gsParaviewFormat.h>
+#include <gsCore/gsConfig.h>
+#include <gsCore/gsDebug.h>
+#include <gsIO/gsXml.h>
+
+#include <zlib/zlib.h>
+#include <stdint.h>
+#include <algorithm>
+
+namespace gismo
+{
+
+namespace
+{
+
+// Type of the size entries preceding the binary data (header_type)
+typedef uint64_t vtkHeader_t;
+
+// Uncompressed size of the blocks of compressed data, as used by
+// the vtkZLibDataCompressor
+const size_t vtkBlockSize = 32768;
+
+bool isLittleEndian()
+{
+    const int one = 1;
+    return 1 == *reinterpret_cast<const char*>(&one);
+}
+
+// Compresses \a data block-wise, the header contains the number of
+// blocks, the block size, the size of the last (partial) block and
+// the compressed sizes of all blocks
+void zlibCompress(const char * data, const size_t size, const int level,
+                  std::vector<vtkHeader_t> & header, std::string & blocks)
+{
+    const size_t nb = (size + vtkBlockSize - 1) / vtkBlockSize;
+    header.resize(3 + nb);
+    header[0] = nb;
+    header[1] = vtkBlockSize;
+    header[2] = size % vtkBlockSize;
+
+    std::vector<Bytef> buf( compressBound(vtkBlockSize) );
+    for (size_t b = 0; b != nb; ++b)
+    {
+        const size_t len = ( b+1 == nb && 0 != header[2] ? header[2] : vtkBlockSize );
+        uLongf csize = buf.size();
+        const int ok = compress2(&buf[0], &csize,
+                                 reinterpret_cast<const Bytef*>(data + b * vtkBlockSize),
+                                 len, level);
+        GISMO_ENSURE(Z_OK == ok, "zlib compression failed (error "<< ok <<").");
+        header[3+b] = csize;
+        blocks.append(reinterpret_cast<const char*>(&buf[0]), csize);
+    }
+}
+
+template<class V>
+void writeAscii(std::ostream & out, const std::string & tag, const std::vector<V> & values)
+{
+    out << tag << " format=\"ascii\">\n";
+    for (typename std::vector<V>::const_iterator it = values.begin(); it != values.end(); ++it)
+        out << *it << " ";
+    out << "\n</DataArray>\n";
+}
+
+} // namespace
+
+gsParaviewFormat & gsParaviewFormat::global()
+{
+    static gsParaviewFormat fmt;
+    return fmt;
+}
+
+gsParaviewDataWriter::gsParaviewDataWriter(const gsParaviewFormat & format)
+: m_format(format)
+{ }
+
+std::string gsParaviewDataWriter::fileAttributes() const
+{
+    std::string res = m_format.isBinary() ? "version=\"1.0\"" : "version=\"0.1\"";
+    res += isLittleEndian() ? " byte_order=\"LittleEndian\"" : " byte_order=\"BigEndian\"";
+    if ( m_format.isBinary() )
+        res += " header_type=\"UInt64\"";
+    if ( 0 != m_format.compression() )
+        res += " compressor=\"vtkZLibDataCompressor\"";
+    return res;
+}
+
+void gsParaviewDataWriter::write(std::ostream & out, const std::string & attributes,
+                                 const std::vector<float> & values)
+{
+    const std::string tag = "<DataArray type=\"Float32\" " + attributes;
+    if ( m_format.isBinary() )
+        writeBytes(out, tag, values.empty() ? NULL : reinterpret_cast<const char*>(&values[0]),
+                   values.size() * sizeof(float));
+    else
+        writeAscii(out, tag, values);
+}
+
+void gsParaviewDataWriter::write(std::ostream & out, const std::string & attributes,
+                                 const std::vector<double> & values)
+{
+    if ( m_format.isBinary() )
+        writeBytes(out, "<DataArray type=\"Float64\" " + attributes,
+                   values.empty() ? NULL : reinterpret_cast<const char*>(&values[0]),
+                   values.size() * sizeof(double));
+    else // text, with the type of the files written so far
+        writeAscii(out, "<DataArray type=\"Float32\" " + attributes, values);
+}
+
+void gsParaviewDataWriter::write(std::ostream & out, const std::string & attributes,
+                                 const std::vector<int> & values)
+{
+    GISMO_STATIC_ASSERT(4 == sizeof(int), "Int32 data arrays expect 32 bit integers.");
+    const std::string tag = "<DataArray type=\"Int32\" " + attributes;
+    if ( m_format.isBinary() )
+        writeBytes(out, tag, values.empty() ? NULL : reinterpret_cast<const char*>(&values[0]),
+                   values.size() * sizeof(int));
+    else
+        writeAscii(out, tag, values);
+}
+
+void gsParaviewDataWriter::writeBytes(std::ostream & out, const std::string & tag,
+                                      const char * bytes, const size_t size)
+{
+    // Size header followed by the data, possibly compressed
+    std::vector<vtkHeader_t> header(1, size);
+    std::string blocks;
+    const int level = m_format.compression();
+    if ( 0 != level )
+        zlibCompress(bytes, size, std::min(9, std::max(1, level)), header, blocks);
+    const char * hbytes = reinterpret_cast<const char*>(&header[0]);
+    const size_t hsize  = header.size() * sizeof(vtkHeader_t);
+
+    if ( gsParaviewFormat::appended == m_format.dataEncoding() )
+    {
+        out << tag << " format=\"appended\" offset=\"" << m_appended.size() << "\"/>\n";
+        m_appended.append(hbytes, hsize);
+        if ( 0 != level )
+            m_appended.append(blocks);
+        else if ( 0 != size )
+            m_appended.append(bytes, size);
+    }
+    else
+    {
+        std::string enc;
+        if ( 0 != level ) // the header is encoded separately
+        {
+            internal::encodeBase64(hbytes, hsize, enc);
+            internal::encodeBase64(blocks.data(), blocks.size(), enc);
+        }
+        else
+        {
+            blocks.reserve(hsize + size);
+            blocks.assign(hbytes, hsize);
+            if ( 0 != size )
+                blocks.append(bytes, size);
+            internal::encodeBase64(blocks.data(), blocks.size(), enc);
+        }
+        out << tag << " format=\"binary\">\n" << enc << "\n</DataArray>\n";
+    }
+}
+
+void gsParaviewDataWriter::finish(std::ostream & out)
+{
+    if ( m_appended.empty() )
+        return;
+    out << "<AppendedData encoding=\"raw\">\n_";
+    out.write(m_appended.data(), m_appended.size());
+    out << "\n</AppendedData>\n";
+    m_appended.clear();
+}
+
+} // namespace gismo
@@ -0,0 +1,144 @@
+/** @file gsParaviewFormat.h
+
+    @brief Provides the output format of the Paraview (VTK XML) files
+    and a helper writing their data arrays.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsExport.h>
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace gismo {
+
+/**
+    \brief Output format of the VTK XML files written by the
+    gsWriteParaview functions.
+
+    The numeric data (points, fields, connectivity) of a file can be
+    written as text (the default), as base64-encoded binary data
+    inside the DataArray elements or as raw binary data in an
+    AppendedData section at the end of the file. The binary encodings
+    can additionally be compressed using zlib.
+
+    The format can be passed to the writers or set once for all
+    subsequent calls:
+    \verbatim
+    gsParaviewFormat::global() = gsParaviewFormat(gsParaviewFormat::appended, 1);
+    gsWriteParaview(field, "solution", 10000);
+    \endverbatim
+
+    \ingroup IO
+*/
+class GISMO_EXPORT gsParaviewFormat
+{
+public:
+
+    /// Encoding of the data arrays
+    enum encoding
+    {
+        ascii    = 0, ///< Values as text
+        binary   = 1, ///< Base64-encoded values inside the DataArray elements
+        appended = 2  ///< Raw values in the AppendedData section of the file
+    };
+
+    /// Constructor. \a compression is the zlib compression level
+    /// (from 1 (fastest) to 9 (smallest)), zero disables the
+    /// compression. The compression is ignored for ascii files.
+    gsParaviewFormat(encoding enc = ascii, int compression = 0)
+    : m_encoding(enc), m_compression(compression) { }
+
+    /// Returns the encoding of the data arrays
+    encoding dataEncoding() const { return m_encoding; }
+
+    /// Returns the zlib compression level (zero if not compressed)
+    int compression() const
+    { return ascii==m_encoding ? 0 : m_compression; }
+
+    /// Returns true if the data arrays are written as binary data
+    bool isBinary() const { return ascii!=m_encoding; }
+
+    /// Returns the format used by the writers when no format is
+    /// given explicitly. It can be changed, initially it is ascii.
+    static gsParaviewFormat & global();
+
+private:
+    encoding m_encoding;
+    int      m_compression;
+};
+
+/**
+    \brief Writes the DataArray elements of a VTK XML file in a given
+    gsParaviewFormat.
+
+    Typical usage is
+    \verbatim
+    gsParaviewDataWriter data(format);
+    file << "<VTKFile type=\"PolyData\" " << data.fileAttributes() << ">\n";
+    ...
+    data.write(file, "NumberOfComponents=\"3\"", points); // std::vector<double>
+    ...
+    file << "</PolyData>\n";
+    data.finish(file); // AppendedData section, if any
+    file << "</VTKFile>\n";
+    \endverbatim
+
+    Text output uses the formatting flags of the stream. For the
+    appended encoding, the stream must be opened in binary mode.
+
+    \ingroup IO
+*/
+class GISMO_EXPORT gsParaviewDataWriter
+{
+public:
+
+    explicit gsParaviewDataWriter(const gsParaviewFormat & format = gsParaviewFormat::global());
+
+    /// Returns the attributes of the VTKFile element
+    /// (version, byte order and compressor)
+    std::string fileAttributes() const;
+
+    /// Writes a Float32 DataArray element holding \a values.
+    /// \a attributes (eg. Name, NumberOfComponents) are copied to
+    /// the element
+    void write(std::ostream & out, const std::string & attributes,
+               const std::vector<float> & values);
+
+    /// Writes a DataArray element holding \a values in double
+    /// precision (Float64 in the binary encodings)
+    void write(std::ostream & out, const std::string & attributes,
+               const std::vector<double> & values);
+
+    /// Writes an Int32 DataArray element holding \a values
+    void write(std::ostream & out, const std::string & attributes,
+               const std::vector<int> & values);
+
+    /// Writes the AppendedData section, if any. Call it once, after
+    /// all data arrays and before closing the VTKFile element
+    void finish(std::ostream & out);
+
+    /// Returns the format of this writer
+    const gsParaviewFormat & format() const { return m_format; }
+
+private:
+
+    void writeBytes(std::ostream & out, const std::string & tag,
+                    const char * bytes, size_t size);
+
+private:
+    gsParaviewFormat m_format;
+
+    /// Content of the AppendedData section
+    std::string m_appended;
+};
+
+} // namespace gismo
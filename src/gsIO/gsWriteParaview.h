@@ -14,6 +14,7 @@
 #include <gsCore/gsGeometry.h>
 #include <gsCore/gsForwardDeclarations.h>
 #include <gsCore/gsExport.h>
+#include <gsIO/gsParaviewFormat.h>
 
 #include <sstream>
 #include <fstream>
@@ -33,19 +34,23 @@ namespace gismo {
 /// \param npts number of points used for sampling each patch
 /// \param mesh if true, the parameter mesh is plotted as well
 /// \param ctrlNet if true, the control net is plotted as well
+/// \param fmt output format of the data (see gsParaviewFormat)
 ///
 /// \ingroup IO
 template<class T>
 void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn, 
-                     unsigned npts=NS, bool mesh = false, bool ctrlNet = false);
+                     unsigned npts=NS, bool mesh = false, bool ctrlNet = false,
+                     const gsParaviewFormat & fmt = gsParaviewFormat::global());
 
 /// \brief Export a mesh to paraview file
 ///
 /// \param sl a gsMesh object
 /// \param fn filename where paraview file is written
 /// \param pvd if true, a .pvd file is generated (for compatibility)
+/// \param fmt output format of the data (see gsParaviewFormat)
 template <class T>
-void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd = true);
+void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd = true,
+                     const gsParaviewFormat & fmt = gsParaviewFormat::global());
 
 /// \brief Export a vector of meshes, each mesh in its own file.
 ///
@@ -61,9 +66,17 @@ void gsWriteParaview(const std::vector<gsMesh<T> >& meshes, std::string const& f
 /// \param fn filename where paraview file is written
 /// \param npts number of points used for sampling each patch
 /// \param mesh if true, the parameter mesh is plotted as well
+/// \param fmt output format of the data (see gsParaviewFormat)
+///
+/// The patches are written concurrently (if OpenMP is enabled), each
+/// one to a separate file as soon as it is evaluated. The files are
+/// listed in the collection file \a fn.pvd and grouped into the
+/// multi-block dataset \a fn.vtm, which can be used as a step of a
+/// time series (see gsParaviewCollection::addTimestep).
 template<class T>
 void gsWriteParaview(const gsField<T> & field, std::string const & fn, 
-                     unsigned npts=NS, bool mesh = false);
+                     unsigned npts=NS, bool mesh = false,
+                     const gsParaviewFormat & fmt = gsParaviewFormat::global());
 
 /// \brief Export a multipatch Geometry (without scalar information) to paraview file
 ///
@@ -72,11 +85,13 @@ void gsWriteParaview(const gsField<T> & field, std::string const & fn,
 /// \param npts number of points used for sampling each patch
 /// \param mesh if true, the parameter mesh is plotted as well
 /// \param ctrlNet if true, the control net is plotted as well
+/// \param fmt output format of the data (see gsParaviewFormat)
 template<class T>
 void gsWriteParaview(const gsMultiPatch<T> & Geo, std::string const & fn, 
-                     unsigned npts=NS, bool mesh = false, bool ctrlNet = false)
+                     unsigned npts=NS, bool mesh = false, bool ctrlNet = false,
+                     const gsParaviewFormat & fmt = gsParaviewFormat::global())
 {
-    gsWriteParaview( Geo.patches(), fn, npts, mesh, ctrlNet);
+    gsWriteParaview( Geo.patches(), fn, npts, mesh, ctrlNet, fmt);
 }
 
 /// \brief Export a multipatch Geometry (without scalar information) to paraview file
@@ -86,15 +101,27 @@ void gsWriteParaview(const gsMultiPatch<T> & Geo, std::string const & fn,
 /// \param npts number of points used for sampling each geometry
 /// \param mesh if true, the parameter mesh is plotted as well
 /// \param ctrlNet if true, the control net is plotted as well
+/// \param fmt output format of the data (see gsParaviewFormat)
+///
+/// The patches are written concurrently (if OpenMP is enabled), each
+/// one to a separate file as soon as it is evaluated. The files are
+/// listed in the collection file \a fn.pvd and grouped into the
+/// multi-block dataset \a fn.vtm, which can be used as a step of a
+/// time series (see gsParaviewCollection::addTimestep).
 template<class T>
 void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo, 
                       std::string const & fn, unsigned npts=NS,
-                      bool mesh = false, bool ctrlNet = false);
+                      bool mesh = false, bool ctrlNet = false,
+                      const gsParaviewFormat & fmt = gsParaviewFormat::global());
 
 /// \brief Export a computational mesh to paraview file
+///
+/// The meshes of the patches are written concurrently, see
+/// gsWriteParaview(const gsField<T>&, std::string const&, unsigned, bool, const gsParaviewFormat&)
 template<class T>
 void gsWriteParaview(const gsMultiBasis<T> & mb, const gsMultiPatch<T> & domain,
-                     std::string const & fn, unsigned npts);
+                     std::string const & fn, unsigned npts,
+                     const gsParaviewFormat & fmt = gsParaviewFormat::global());
 
 /// \brief Export a composite Geometry to paraview file
 ///
@@ -160,10 +187,12 @@ void gsWriteParaview(gsBasis<T> const& basis, std::string const & fn,
 /// \param X  1 times n matrix of values for x direction
 /// \param Y  1 times n matrix of values for y direction
 /// \param fn filename where paraview file is written
+/// \param fmt output format of the data (see gsParaviewFormat)
 template<class T>
 void gsWriteParaviewPoints(gsMatrix<T> const& X, 
                            gsMatrix<T> const& Y, 
-                           std::string const & fn);
+                           std::string const & fn,
+                           const gsParaviewFormat & fmt = gsParaviewFormat::global());
 
 /// \brief Export 3D Point set to Paraview file
 ///
@@ -171,18 +200,31 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
 /// \param Y  1 times n matrix of values for y direction
 /// \param Z  1 times n matrix of values for z-direction
 /// \param fn filename where paraview file is written
+/// \param fmt output format of the data (see gsParaviewFormat)
+template<class T>
+void gsWriteParaviewPoints(gsMatrix<T> const& X,
+                           gsMatrix<T> const& Y,
+                           gsMatrix<T> const& Z,
+                           std::string const & fn,
+                           const gsParaviewFormat & fmt = gsParaviewFormat::global());
+
+/// \brief Export 3D Point set with point values \a V to Paraview file
 template<class T>
 void gsWriteParaviewPoints(gsMatrix<T> const& X,
                            gsMatrix<T> const& Y,
                            gsMatrix<T> const& Z,
-                           std::string const & fn);
+                           gsMatrix<T> const& V,
+                           std::string const & fn,
+                           const gsParaviewFormat & fmt = gsParaviewFormat::global());
 
 /// \brief Export Point set to Paraview file
 ///
 /// \param points matrix that contain 2D or 3D points, points are columns
 /// \param fn filename where paraview file is written
+/// \param fmt output format of the data (see gsParaviewFormat)
 template<class T>
-void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn);
+void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn,
+                           const gsParaviewFormat & fmt = gsParaviewFormat::global());
 
 /// \brief Export tensor-structured point set with field data to Paraview file
 ///
@@ -190,11 +232,13 @@ void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn);
 /// \param data
 /// \param np
 /// \param fn filename where paraview file is written
+/// \param fmt output format of the data (see gsParaviewFormat)
 template<class T>
 void gsWriteParaviewTPgrid(gsMatrix<T> const& points,
                            gsMatrix<T> const& data,
                            const gsVector<index_t> & np,
-                           std::string const & fn);
+                           std::string const & fn,
+                           const gsParaviewFormat & fmt = gsParaviewFormat::global());
 
 /// \brief Depicting edge graph of each volume of one gsSolid with a segmenting loop
 ///
@@ -282,7 +326,8 @@ template<class T>
 void writeSinglePatchField(const gsFunction<T> & geometry,
                            const gsFunction<T> & parField,
                            const bool isParam,
-                           std::string const & fn, unsigned npts);
+                           std::string const & fn, unsigned npts,
+                           const gsParaviewFormat & fmt = gsParaviewFormat::global());
 
 // Please document
 template <class T>
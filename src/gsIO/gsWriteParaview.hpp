@@ -33,23 +33,96 @@
 namespace gismo
 {
 
+namespace internal
+{
+
+/// Type of the values written for the scalar type \a T, which keeps
+/// the precision of \a T (up to double)
+template<class T> struct vtkReal        { typedef double type; };
+template<>        struct vtkReal<float> { typedef float  type; };
+
+/// Returns the columns of \a m as consecutive tuples of \a nc
+/// values, missing rows of \a m are set to zero
+template<class T>
+std::vector<typename vtkReal<T>::type> vtkTuples(const gsMatrix<T> & m, const index_t nc)
+{
+    typedef typename vtkReal<T>::type V;
+    std::vector<V> res(nc * m.cols(), V(0));
+    const index_t nr = math::min(nc, m.rows());
+    for (index_t j = 0; j != m.cols(); ++j)
+        for (index_t i = 0; i != nr; ++i)
+            res[nc*j+i] = cast<T,V>(m(i,j));
+    return res;
+}
+
+/// Returns the \a n values first, first+step, first+2*step, ...
+inline std::vector<int> vtkSequence(const int n, const int first = 0, const int step = 1)
+{
+    std::vector<int> res(n);
+    for (int i = 0; i != n; ++i)
+        res[i] = first + i * step;
+    return res;
+}
+
+/// Returns the coordinates of the vertices of \a sl
+template<class T>
+std::vector<typename vtkReal<T>::type> vtkVertices(const gsMesh<T> & sl)
+{
+    typedef typename vtkReal<T>::type V;
+    std::vector<V> res;
+    res.reserve(3 * sl.numVertices());
+    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertices().begin(); it!=sl.vertices().end(); ++it)
+    {
+        const gsVertex<T>& vertex = **it;
+        res.push_back(cast<T,V>(vertex[0]));
+        res.push_back(cast<T,V>(vertex[1]));
+        res.push_back(cast<T,V>(vertex[2]));
+    }
+    return res;
+}
+
+/// Returns the data values attached to the vertices of \a sl
+template<class T>
+std::vector<typename vtkReal<T>::type> vtkVertexData(const gsMesh<T> & sl)
+{
+    typedef typename vtkReal<T>::type V;
+    std::vector<V> res;
+    res.reserve(sl.numVertices());
+    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertices().begin(); it!=sl.vertices().end(); ++it)
+        res.push_back(cast<T,V>((*it)->data));
+    return res;
+}
+
+/// Keeps the message of the first exception thrown in a parallel
+/// loop, since exceptions must not leave the parallel region
+inline void vtkKeepError(std::string & error, const std::exception & e)
+{
+#   pragma omp critical (vtkKeepError)
+    if ( error.empty() )
+        error = e.what();
+}
+
+} // namespace internal
+
 // Export a 3D parametric mesh
 template<class T>
 void writeSingleBasisMesh3D(const gsMesh<T> & sl,
-                            std::string const & fn)
+                            std::string const & fn,
+                            const gsParaviewFormat & fmt = gsParaviewFormat::global())
 {
     const unsigned numVer = sl.numVertices();
     const unsigned numEl  = numVer / 8;
     std::string mfn(fn);
     mfn.append(".vtu");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     if ( ! file.is_open() )
         gsWarn<<"writeSingleBasisMesh3D: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data(fmt);
 
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"UnstructuredGrid\" "<< data.fileAttributes() <<">\n";
     file <<"<UnstructuredGrid>\n";
 
     // Number of vertices and number of cells
@@ -57,60 +130,30 @@ void writeSingleBasisMesh3D(const gsMesh<T> & sl,
 
     // Coordinates of vertices
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">\n";
-    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertices().begin(); it!=sl.vertices().end(); ++it)
-    {
-        const gsVertex<T>& vertex = **it;
-        file << vertex[0] << " " << vertex[1] << " " << vertex[2] << " \n";
-    }
-    file << "\n";
-    file <<"</DataArray>\n";
+    data.write(file, "NumberOfComponents=\"3\"", internal::vtkVertices(sl));
     file <<"</Points>\n";
 
     // Point data
     file <<"<PointData Scalars=\"CellVolume\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"CellVolume\" format=\"ascii\" NumberOfComponents=\"1\">\n";
-    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertices().begin(); it!=sl.vertices().end(); ++it)
-    {
-        file << (*it)->data <<" ";
-    }
-    file << "\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"CellVolume\" NumberOfComponents=\"1\"", internal::vtkVertexData(sl));
     file <<"</PointData>\n";
 
     // Cells
     file <<"<Cells>\n";
 
     // Connectivity
-    file <<"<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
-    for (unsigned i = 0; i!= numVer;++i)
-    {
-        file << i << " ";
-    }
-    file << "\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"connectivity\"", internal::vtkSequence(numVer));
 
     // Offsets
-    file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-    for (unsigned i = 1; i<= numEl;++i)
-    {
-        file << 8*i << " ";
-    }
-    file << "\n";
-    file << "</DataArray>\n";
+    data.write(file, "Name=\"offsets\"", internal::vtkSequence(numEl, 8, 8));
 
     // Type
-    file << "<DataArray type=\"Int32\" Name=\"types\" format=\"ascii\">\n";
-    for (unsigned i = 1; i<= numEl;++i)
-    {
-        file << "11 ";
-    }
-    file << "\n";
-    file << "</DataArray>\n";
+    data.write(file, "Name=\"types\"", std::vector<int>(numEl, 11));
 
     file <<"</Cells>\n";
     file << "</Piece>\n";
     file <<"</UnstructuredGrid>\n";
+    data.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 
@@ -122,20 +165,22 @@ void writeSingleBasisMesh3D(const gsMesh<T> & sl,
 //
 template<class T>
 void writeSingleBasisMesh2D(const gsMesh<T> & sl,
-                            std::string const & fn)
+                            std::string const & fn,
+                            const gsParaviewFormat & fmt = gsParaviewFormat::global())
 {
     const unsigned numVer = sl.numVertices();
     const unsigned numEl  = numVer / 4; //(1<<dim)
     std::string mfn(fn);
     mfn.append(".vtu");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     if ( ! file.is_open() )
         gsWarn<<"writeSingleBasisMesh2D: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data(fmt);
 
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"UnstructuredGrid\" "<< data.fileAttributes() <<">\n";
     file <<"<UnstructuredGrid>\n";
 
     // Number of vertices and number of cells
@@ -143,67 +188,36 @@ void writeSingleBasisMesh2D(const gsMesh<T> & sl,
 
     // Coordinates of vertices
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">\n";
-    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertices().begin(); it!=sl.vertices().end(); it+=4)
+    std::vector<typename internal::vtkReal<T>::type> pts = internal::vtkVertices(sl);
+    for (size_t i = 0; i < pts.size(); i+=12)
     {
         // order is important!
-        const gsVertex<T>& vertex0 = **it;
-        const gsVertex<T>& vertex1 = **(it+1);
-        const gsVertex<T>& vertex3 = **(it+3);
-        const gsVertex<T>& vertex2 = **(it+2);
-        file << vertex0[0] << " " << vertex0[1] << " " << vertex0[2] << " \n";
-        file << vertex1[0] << " " << vertex1[1] << " " << vertex1[2] << " \n";
-        file << vertex3[0] << " " << vertex3[1] << " " << vertex3[2] << " \n";
-        file << vertex2[0] << " " << vertex2[1] << " " << vertex2[2] << " \n";
+        std::swap_ranges(pts.begin()+i+6, pts.begin()+i+9, pts.begin()+i+9);
     }
-    file << "\n";
-    file <<"</DataArray>\n";
+    data.write(file, "NumberOfComponents=\"3\"", pts);
     file <<"</Points>\n";
 
     // Point data
     file <<"<PointData Scalars=\"CellArea\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"CellVolume\" format=\"ascii\" NumberOfComponents=\"1\">\n";
-    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertices().begin(); it!=sl.vertices().end(); ++it)
-    {
-        file << (*it)->data <<" ";
-    }
-    file << "\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"CellVolume\" NumberOfComponents=\"1\"", internal::vtkVertexData(sl));
     file <<"</PointData>\n";
 
     // Cells
     file <<"<Cells>\n";
 
     // Connectivity
-    file <<"<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
-    for (unsigned i = 0; i!= numVer;++i)
-    {
-        file << i << " ";
-    }
-    file << "\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"connectivity\"", internal::vtkSequence(numVer));
 
     // Offsets
-    file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-    for (unsigned i = 1; i<= numEl;++i)
-    {
-        file << 4*i << " "; //step: (1<<dim)
-    }
-    file << "\n";
-    file << "</DataArray>\n";
+    data.write(file, "Name=\"offsets\"", internal::vtkSequence(numEl, 4, 4)); //step: (1<<dim)
 
     // Type
-    file << "<DataArray type=\"Int32\" Name=\"types\" format=\"ascii\">\n";
-    for (unsigned i = 1; i<= numEl;++i)
-    {
-        file << "9 ";// 11: 3D, 9: 2D
-    }
-    file << "\n";
-    file << "</DataArray>\n";
+    data.write(file, "Name=\"types\"", std::vector<int>(numEl, 9)); // 11: 3D, 9: 2D
 
     file <<"</Cells>\n";
     file << "</Piece>\n";
     file <<"</UnstructuredGrid>\n";
+    data.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 
@@ -215,21 +229,23 @@ void writeSingleBasisMesh2D(const gsMesh<T> & sl,
 /// Export a parametric mesh
 template<class T>
 void writeSingleBasisMesh(const gsBasis<T> & basis,
-                         std::string const & fn)
+                         std::string const & fn,
+                         const gsParaviewFormat & fmt = gsParaviewFormat::global())
 {
     gsMesh<T> msh(basis, 0);
     if ( basis.dim() == 3)
-        writeSingleBasisMesh3D(msh,fn);
+        writeSingleBasisMesh3D(msh,fn,fmt);
     else if ( basis.dim() == 2)
-        writeSingleBasisMesh2D(msh,fn);
+        writeSingleBasisMesh2D(msh,fn,fmt);
     else
-        gsWriteParaview(msh, fn, false);
+        gsWriteParaview(msh, fn, false, fmt);
 }
 
 /// Export a computational mesh
 template<class T>
 void writeSingleCompMesh(const gsBasis<T> & basis, const gsGeometry<T> & Geo,
-                         std::string const & fn, unsigned resolution = 8)
+                         std::string const & fn, unsigned resolution = 8,
+                         const gsParaviewFormat & fmt = gsParaviewFormat::global())
 {
     gsMesh<T> msh(basis, resolution);
     Geo.evaluateMesh(msh);
@@ -239,13 +255,14 @@ void writeSingleCompMesh(const gsBasis<T> & basis, const gsGeometry<T> & Geo,
     // else if ( basis.dim() == 2)
     //     writeSingleBasisMesh2D(msh,fn);
     // else
-        gsWriteParaview(msh, fn, false);
+        gsWriteParaview(msh, fn, false, fmt);
 }
 
 /// Export a control net
 template<class T>
 void writeSingleControlNet(const gsGeometry<T> & Geo,
-                           std::string const & fn)
+                           std::string const & fn,
+                           const gsParaviewFormat & fmt = gsParaviewFormat::global())
 {
     const int d = Geo.parDim();
     gsMesh<T> msh;
@@ -265,66 +282,48 @@ void writeSingleControlNet(const gsGeometry<T> & Geo,
     {
         gsDebug<<"Writing 4th coordinate\n";
         const gsMatrix<T> & cp = Geo.coefs();
-        gsWriteParaviewPoints<T>(cp.transpose(), fn );
+        gsWriteParaviewPoints<T>(cp.transpose(), fn, fmt);
         return;
     }
 
-    gsWriteParaview(msh, fn, false);
+    gsWriteParaview(msh, fn, false, fmt);
 }
 
 template<class T>
 void gsWriteParaviewTPgrid(const gsMatrix<T> & eval_geo  ,
                            const gsMatrix<T> & eval_field,
                            const gsVector<index_t> & np,
-                           std::string const & fn)
+                           std::string const & fn,
+                           const gsParaviewFormat & fmt)
 {
-    const int n = eval_geo.rows();
     GISMO_ASSERT(eval_geo.cols()==eval_field.cols()
                  && static_cast<index_t>(np.prod())==eval_geo.cols(),
                  "Data do not match");
 
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data(fmt);
 
+    const index_t nc = ( eval_field.rows()==1 ? 1 : 3);
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file <<"<VTKFile type=\"StructuredGrid\" "<< data.fileAttributes() <<">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "
          << (np.size()>2 ? np(2)-1 : 0) <<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "
          << (np.size()>2 ? np(2)-1 : 0) <<"\">\n";
     file <<"<PointData "<< ( eval_field.rows()==1 ?"Scalars":"Vectors")<<"=\"SolutionField\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"SolutionField\" format=\"ascii\" NumberOfComponents=\""<< ( eval_field.rows()==1 ? 1 : 3) <<"\">\n";
-    if ( eval_field.rows()==1 )
-        for ( index_t j=0; j<eval_field.cols(); ++j)
-            file<< eval_field.at(j) <<" ";
-    else
-    {
-        for ( index_t j=0; j<eval_field.cols(); ++j)
-        {
-            for ( index_t i=0; i!=eval_field.rows(); ++i)
-                file<< eval_field(i,j) <<" ";
-            for ( index_t i=eval_field.rows(); i<3; ++i)
-                file<<"0 ";
-        }
-    }
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"SolutionField\" NumberOfComponents=\""+util::to_string(nc)+"\"",
+               internal::vtkTuples(eval_field, nc));
     file <<"</PointData>\n";
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\">\n";
-    for ( index_t j=0; j<eval_geo.cols(); ++j)
-    {
-        for ( index_t i=0; i!=n; ++i)
-            file<< eval_geo(i,j) <<" ";
-        for ( index_t i=n; i<3; ++i)
-            file<<"0 ";
-    }
-    file <<"</DataArray>\n";
+    data.write(file, "NumberOfComponents=\"3\"", internal::vtkTuples(eval_geo, 3));
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    data.finish(file);
     file <<"</VTKFile>\n";
 
     file.close();
@@ -334,7 +333,8 @@ template<class T>
 void writeSinglePatchField(const gsFunction<T> & geometry,
                            const gsFunction<T> & parField,
                            const bool isParam,
-                           std::string const & fn, unsigned npts)
+                           std::string const & fn, unsigned npts,
+                           const gsParaviewFormat & fmt)
 {
     const int n = geometry.targetDim();
     const int d = geometry.domainDim();
@@ -376,15 +376,16 @@ void writeSinglePatchField(const gsFunction<T> & geometry,
         eval_field.bottomRows(1).setZero(); // 3-field.dim()
     }
 
-    gsWriteParaviewTPgrid(eval_geo, eval_field, np.template cast<index_t>(), fn);
+    gsWriteParaviewTPgrid(eval_geo, eval_field, np.template cast<index_t>(), fn, fmt);
 }
 
 /// Write a file containing a solution field over a single geometry
 template<class T>
 void writeSinglePatchField(const gsField<T> & field, int patchNr,
-                           std::string const & fn, unsigned npts)
+                           std::string const & fn, unsigned npts,
+                           const gsParaviewFormat & fmt = gsParaviewFormat::global())
 {
-    writeSinglePatchField(field.patch(patchNr), field.function(patchNr), field.isParametric(), fn, npts);
+    writeSinglePatchField(field.patch(patchNr), field.function(patchNr), field.isParametric(), fn, npts, fmt);
 /*
     const int n = field.geoDim();
     const int d = field.parDim();
@@ -464,7 +465,8 @@ void writeSinglePatchField(const gsField<T> & field, int patchNr,
 template<class T>
 void writeSingleGeometry(gsFunction<T> const& func,
                          gsMatrix<T> const& supp,
-                         std::string const & fn, unsigned npts)
+                         std::string const & fn, unsigned npts,
+                         const gsParaviewFormat & fmt = gsParaviewFormat::global())
 {
     const int n = func.targetDim();
     const int d = func.domainDim();
@@ -497,13 +499,14 @@ void writeSingleGeometry(gsFunction<T> const& func,
 
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     if ( ! file.is_open() )
         gsWarn<<"writeSingleGeometry: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data(fmt);
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file <<"<VTKFile type=\"StructuredGrid\" "<< data.fileAttributes() <<">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<<np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     // Add norm of the point as data
@@ -520,23 +523,18 @@ void writeSingleGeometry(gsFunction<T> const& func,
     {
         //gsWarn<< "4th dimension as scalar data.\n";
         file <<"<PointData "<< "Scalars=\"Coordinate4\">\n";
-        file <<"<DataArray type=\"Float32\" Name=\"Coordinate4\" format=\"ascii\" NumberOfComponents=\"1\">\n";
-        for ( index_t j=0; j!=eval_func.cols(); ++j)
-            file<< eval_func(3,j) <<" ";
-        file <<"</DataArray>\n";
+        data.write(file, "Name=\"Coordinate4\" NumberOfComponents=\"1\"",
+                   internal::vtkTuples<T>(eval_func.row(3), 1));
         file <<"</PointData>\n";
     }
     //---------
 
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\">\n";
-    for ( index_t j=0; j<eval_func.cols(); ++j)
-        for ( index_t i=0; i!=3; ++i)
-            file<< eval_func(i,j) <<" ";
-    file <<"</DataArray>\n";
+    data.write(file, "NumberOfComponents=\"3\"", internal::vtkTuples(eval_func, 3));
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    data.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 }
@@ -545,7 +543,8 @@ void writeSingleGeometry(gsFunction<T> const& func,
 template<class T>
 void writeSingleCurve(gsFunction<T> const& func,
                       gsMatrix<T> const& supp,
-                      std::string const & fn, unsigned npts)
+                      std::string const & fn, unsigned npts,
+                      const gsParaviewFormat & fmt = gsParaviewFormat::global())
 {
     const unsigned n = func.targetDim();
     const unsigned d = func.domainDim();
@@ -576,59 +575,55 @@ void writeSingleCurve(gsFunction<T> const& func,
 
     std::string mfn(fn);
     mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     if ( ! file.is_open() )
         gsWarn<<"writeSingleCurve: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data(fmt);
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"PolyData\" "<< data.fileAttributes() <<">\n";
     file <<"<PolyData>\n";
     // Accounting
     file <<"<Piece NumberOfPoints=\""<< npts
          <<"\" NumberOfVerts=\"0\" NumberOfLines=\""<< npts-1
          <<"\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n";
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\""<<eval_func.rows()<<"\">\n";
-    for ( index_t j=0; j<eval_func.cols(); ++j)
-        for ( index_t i=0; i<eval_func.rows(); ++i)
-            file<< eval_func(i,j) <<" ";
-    file <<"\n</DataArray>\n";
+    data.write(file, "NumberOfComponents=\""+util::to_string(eval_func.rows())+"\"",
+               internal::vtkTuples(eval_func, eval_func.rows()));
     file <<"</Points>\n";
     // Lines
     file <<"<Lines>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<npts-1<<"\">\n";
+    std::vector<int> conn(2*(npts-1));
     for (unsigned i=0; i< npts-1; ++i )
     {
-        file << i << " " << i+1 << " ";
+        conn[2*i  ] = i;
+        conn[2*i+1] = i+1;
     }
+    data.write(file, "Name=\"connectivity\" RangeMin=\"0\" RangeMax=\""+util::to_string(npts-1)+"\"", conn);
     // offsets
-    file <<"\n</DataArray>\n";
-    unsigned offset(0);
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<npts-1<<"\">\n";
-    for (unsigned i=0; i< npts-1; ++i )
-    {
-        offset +=2;
-        file << offset << " ";
-    }
-    file <<"\n</DataArray>\n";
+    data.write(file, "Name=\"offsets\" RangeMin=\"0\" RangeMax=\""+util::to_string(npts-1)+"\"",
+               internal::vtkSequence(npts-1, 2, 2));
     file <<"</Lines>\n";
     // Closing
     file <<"</Piece>\n";
     file <<"</PolyData>\n";
+    data.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 }
 
 template<class T>
-void writeSingleCurve(const gsGeometry<T> & Geo, std::string const & fn, unsigned npts)
+void writeSingleCurve(const gsGeometry<T> & Geo, std::string const & fn, unsigned npts,
+                      const gsParaviewFormat & fmt = gsParaviewFormat::global())
 {
     gsMatrix<T> ab = Geo.parameterRange();
-    writeSingleCurve( Geo, ab, fn, npts);
+    writeSingleCurve( Geo, ab, fn, npts, fmt);
 }
 
 template<class T>
-void writeSingleGeometry(const gsGeometry<T> & Geo, std::string const & fn, unsigned npts)
+void writeSingleGeometry(const gsGeometry<T> & Geo, std::string const & fn, unsigned npts,
+                         const gsParaviewFormat & fmt = gsParaviewFormat::global())
 {
     /*
       gsMesh<T> msh;
@@ -637,7 +632,7 @@ void writeSingleGeometry(const gsGeometry<T> & Geo, std::string const & fn, unsi
       return;
     //*/
     gsMatrix<T> ab = Geo.parameterRange();
-    writeSingleGeometry( Geo, ab, fn, npts);
+    writeSingleGeometry( Geo, ab, fn, npts, fmt);
 }
 
 template<class T>
@@ -653,7 +648,8 @@ void writeSingleTrimSurface(const gsTrimSurface<T> & surf,
 template<class T>
 void gsWriteParaview(const gsField<T> & field,
                      std::string const & fn,
-                     unsigned npts, bool mesh)
+                     unsigned npts, bool mesh,
+                     const gsParaviewFormat & fmt)
 {
     /*
     if (mesh && (!field.isParametrized()) )
@@ -663,35 +659,58 @@ void gsWriteParaview(const gsField<T> & field,
     }
     */
 
-    const unsigned n = field.nPieces();
-    gsParaviewCollection collection(fn);
-    std::string fileName;
+    const index_t n = field.nPieces();
 
-    for ( unsigned i=0; i < n; ++i )
+    // The patches are evaluated and written concurrently, each one
+    // directly to its own file
+    std::string error; // raised after the parallel loop
+#   pragma omp parallel for schedule(dynamic,1)
+    for ( index_t i=0; i < n; ++i )
     {
-        const gsBasis<T> & dom = field.isParametrized() ?
-            field.igaFunction(i).basis() : field.patch(i).basis();
-
-        fileName = fn + util::to_string(i);
-        writeSinglePatchField( field, i, fileName, npts );
-        collection.addPart(fileName, ".vts");
-        if ( mesh )
+        try
         {
-            fileName+= "_mesh";
-            writeSingleCompMesh(dom, field.patch(i), fileName);
+            const gsBasis<T> & dom = field.isParametrized() ?
+                field.igaFunction(i).basis() : field.patch(i).basis();
 
-            collection.addPart(fileName, ".vtp");
+            const std::string fileName = fn + util::to_string(i);
+            writeSinglePatchField( field, i, fileName, npts, fmt );
+            if ( mesh )
+                writeSingleCompMesh(dom, field.patch(i), fileName + "_mesh", 8, fmt);
+        }
+        catch (std::exception & e)
+        {
+            internal::vtkKeepError(error, e);
         }
+    }
+    if ( !error.empty() )
+        throw std::runtime_error(error);
 
+    gsParaviewCollection collection(fn);
+    gsParaviewMultiBlock blocks(fn);
+    blocks.newBlock("SolutionField");
+    for ( index_t i=0; i < n; ++i )
+    {
+        collection.addPart(fn + util::to_string(i), ".vts");
+        if ( mesh )
+            collection.addPart(fn + util::to_string(i) + "_mesh", ".vtp");
+        blocks.addPart(fn, i, ".vts");
+    }
+    if ( mesh )
+    {
+        blocks.newBlock("Mesh");
+        for ( index_t i=0; i < n; ++i )
+            blocks.addPart(fn + util::to_string(i) + "_mesh", ".vtp");
     }
     collection.save();
+    blocks.save();
 }
 
 
 /// Export a Geometry without scalar information
 template<class T>
 void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn,
-                     unsigned npts, bool mesh, bool ctrlNet)
+                     unsigned npts, bool mesh, bool ctrlNet,
+                     const gsParaviewFormat & fmt)
 {
     const bool curve = ( Geo.domainDim() == 1 );
 
@@ -699,12 +718,12 @@ void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn,
 
     if ( curve )
     {
-        writeSingleCurve(Geo, fn, npts);
+        writeSingleCurve(Geo, fn, npts, fmt);
         collection.addPart(fn, ".vtp");
     }
     else
     {
-        writeSingleGeometry(Geo, fn, npts);
+        writeSingleGeometry(Geo, fn, npts, fmt);
         collection.addPart(fn, ".vts");
     }
 
@@ -731,14 +750,14 @@ void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn,
 	    ptsPerEdge = npts;
 	}
 
-        writeSingleCompMesh(Geo.basis(), Geo, fileName, ptsPerEdge);
+        writeSingleCompMesh(Geo.basis(), Geo, fileName, ptsPerEdge, fmt);
         collection.addPart(fileName, ".vtp");
     }
 
     if ( ctrlNet ) // Output the control net
     {
         const std::string fileName = fn + "_cnet";
-        writeSingleControlNet(Geo, fileName);
+        writeSingleControlNet(Geo, fileName, fmt);
         collection.addPart(fileName, ".vtp");
     }
 
@@ -749,21 +768,42 @@ void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn,
 // Export a multibasis mesh
 template<class T>
 void gsWriteParaview(const gsMultiBasis<T> & mb, const gsMultiPatch<T> & domain,
-                     std::string const & fn, unsigned npts)
+                     std::string const & fn, unsigned npts,
+                     const gsParaviewFormat & fmt)
 {
     // GISMO_ASSERT sizes
 
-    gsParaviewCollection collection(fn);
+    const index_t n = domain.nPatches();
 
-    for (size_t i = 0; i != domain.nPatches(); ++i)
+    std::string error; // raised after the parallel loop
+#   pragma omp parallel for schedule(dynamic,1)
+    for (index_t i = 0; i < n; ++i)
+    {
+        try
+        {
+            const std::string fileName = fn + util::to_string(i) + "_mesh";
+            writeSingleCompMesh(mb[i], domain.patch(i), fileName, npts, fmt);
+        }
+        catch (std::exception & e)
+        {
+            internal::vtkKeepError(error, e);
+        }
+    }
+    if ( !error.empty() )
+        throw std::runtime_error(error);
+
+    // Write out the collection and multi-block files
+    gsParaviewCollection collection(fn);
+    gsParaviewMultiBlock blocks(fn);
+    blocks.newBlock("Mesh");
+    for (index_t i = 0; i < n; ++i)
     {
         const std::string fileName = fn + util::to_string(i) + "_mesh";
-        writeSingleCompMesh(mb[i], domain.patch(i), fileName, npts);
         collection.addPart(fileName, ".vtp");
+        blocks.addPart(fileName, ".vtp");
     }
-
-    // Write out the collection file
     collection.save();
+    blocks.save();
 }
 
 /// Export a Geometry without scalar information
@@ -783,43 +823,69 @@ void gsWriteParaview(const gsGeometrySlice<T> & Geo,
 template<class T>
 void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo,
                       std::string const & fn,
-                      unsigned npts, bool mesh, bool ctrlNet)
+                      unsigned npts, bool mesh, bool ctrlNet,
+                      const gsParaviewFormat & fmt)
 {
-    const size_t n = Geo.size();
+    const index_t n = Geo.size();
 
-    gsParaviewCollection collection(fn);
-    std::string fnBase;
-
-    for ( size_t i=0; i<n ; i++)
+    // The patches are evaluated and written concurrently, each one
+    // directly to its own file
+    std::string error; // raised after the parallel loop
+#   pragma omp parallel for schedule(dynamic,1)
+    for ( index_t i=0; i<n ; i++)
     {
-        fnBase = fn + "_" + util::to_string(i);
-
-        if ( Geo.at(i)->domainDim() == 1 )
+        try
         {
-            writeSingleCurve(*Geo[i], fnBase, npts);
-            collection.addPart(fnBase, ".vtp");
+            const std::string fnBase = fn + "_" + util::to_string(i);
+
+            if ( Geo[i]->domainDim() == 1 )
+                writeSingleCurve(*Geo[i], fnBase, npts, fmt);
+            else
+                writeSingleGeometry( *Geo[i], fnBase, npts, fmt ) ;
+
+            if ( mesh )
+                writeSingleCompMesh(Geo[i]->basis(), *Geo[i], fnBase + "_mesh", 8, fmt);
+
+            if ( ctrlNet ) // Output the control net
+                writeSingleControlNet(*Geo[i], fnBase + "_cnet", fmt);
         }
-        else
+        catch (std::exception & e)
         {
-            writeSingleGeometry( *Geo[i], fnBase, npts ) ;
-            collection.addPart(fnBase, ".vts");
+            internal::vtkKeepError(error, e);
         }
+    }
+    if ( !error.empty() )
+        throw std::runtime_error(error);
 
+    // Write out the collection and multi-block files
+    gsParaviewCollection collection(fn);
+    gsParaviewMultiBlock blocks(fn);
+    blocks.newBlock("Geometry");
+    for ( index_t i=0; i<n ; i++)
+    {
+        const std::string fnBase = fn + "_" + util::to_string(i);
+        const char * ext = ( Geo[i]->domainDim() == 1 ? ".vtp" : ".vts" );
+        collection.addPart(fnBase, ext);
         if ( mesh )
-        {
-            const std::string fileName = fnBase + "_mesh";
-            writeSingleCompMesh(Geo[i]->basis(), *Geo[i], fileName);
-            collection.addPart(fileName, ".vtp");
-        }
-
-        if ( ctrlNet ) // Output the control net
-        {
-            const std::string fileName = fnBase + "_cnet";
-            writeSingleControlNet(*Geo[i], fileName);
-            collection.addPart(fileName, ".vtp");
-        }
+            collection.addPart(fnBase + "_mesh", ".vtp");
+        if ( ctrlNet )
+            collection.addPart(fnBase + "_cnet", ".vtp");
+        blocks.addPart(fn + "_", i, ext);
+    }
+    if ( mesh )
+    {
+        blocks.newBlock("Mesh");
+        for ( index_t i=0; i<n ; i++)
+            blocks.addPart(fn + "_" + util::to_string(i) + "_mesh", ".vtp");
+    }
+    if ( ctrlNet )
+    {
+        blocks.newBlock("ControlNet");
+        for ( index_t i=0; i<n ; i++)
+            blocks.addPart(fn + "_" + util::to_string(i) + "_cnet", ".vtp");
     }
     collection.save();
+    blocks.save();
 }
 
 /// Export i-th Basis function
@@ -866,37 +932,32 @@ void gsWriteParaview_basisFnct(int i, gsBasis<T> const& basis, std::string const
 
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     if ( ! file.is_open() )
         gsWarn<<"gsWriteParaview_basisFnct: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data;
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file <<"<VTKFile type=\"StructuredGrid\" "<< data.fileAttributes() <<">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<<np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     // Scalar information
     file <<"<PointData "<< "Scalars"<<"=\"SolutionField\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"SolutionField\" format=\"ascii\" NumberOfComponents=\""<<1<<"\">\n";
-    for ( index_t j=0; j<eval_geo.cols(); ++j)
-            file<< eval_geo(0,j) <<" ";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"SolutionField\" NumberOfComponents=\"1\"",
+               internal::vtkTuples<T>(eval_geo.row(0), 1));
     file <<"</PointData>\n";
     //
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\""<<3<<"\">\n";
-    for ( index_t j=0; j<eval_geo.cols(); ++j)
-    {
-        for ( int l=0; l!=d; ++l)
-            file<< pts(l,j) <<" ";
-        file<< eval_geo(0,j) <<" ";
-         for ( index_t l=d; l!=pts.rows(); ++l)
-             file<< pts(l,j) <<" ";
-    }
-    file <<"</DataArray>\n";
+    gsMatrix<T> coords(pts.rows() + 1, eval_geo.cols());
+    coords.topRows(d) = pts.topRows(d);
+    coords.row(d)     = eval_geo.row(0);
+    coords.bottomRows(pts.rows() - d) = pts.bottomRows(pts.rows() - d);
+    data.write(file, "NumberOfComponents=\"3\"", internal::vtkTuples(coords, 3));
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    data.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 }
@@ -925,37 +986,31 @@ void gsWriteParaview(gsFunction<T> const& func, gsMatrix<T> const& supp, std::st
 
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     if ( ! file.is_open() )
         gsWarn<<"gsWriteParaview: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data;
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file <<"<VTKFile type=\"StructuredGrid\" "<< data.fileAttributes() <<">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<<np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     // Scalar information
     file <<"<PointData "<< "Scalars"<<"=\"SolutionField\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"SolutionField\" format=\"ascii\" NumberOfComponents=\""<<1<<"\">\n";
-    for ( index_t j=0; j<ev.cols(); ++j)
-            file<< ev(0,j) <<" ";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"SolutionField\" NumberOfComponents=\"1\"",
+               internal::vtkTuples<T>(ev.row(0), 1));
     file <<"</PointData>\n";
     //
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\""<<3<<"\">\n";
-    for ( index_t j=0; j<ev.cols(); ++j)
-    {
-        for ( int i=0; i< d; ++i)
-            file<< pts(i,j) <<" ";
-        file<< ev(0,j) <<" ";
-//         for ( index_t i=d; i< pts.rows(); ++i)
-//             file<< pts(i,j) <<" ";
-    }
-    file <<"</DataArray>\n";
+    gsMatrix<T> coords(d+1, ev.cols());
+    coords.topRows(d) = pts.topRows(d);
+    coords.row(d)     = ev.row(0);
+    data.write(file, "NumberOfComponents=\"3\"", internal::vtkTuples(coords, 3));
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    data.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 }
@@ -990,7 +1045,8 @@ void gsWriteParaview(gsBasis<T> const& basis, std::string const & fn,
 
 /// Export Point set to Paraview
 template<class T>
-void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, std::string const & fn)
+void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, std::string const & fn,
+                           const gsParaviewFormat & fmt)
 {
     assert( X.cols() == Y.cols() );
     assert( X.rows() == 1 && Y.rows() == 1 );
@@ -998,13 +1054,14 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, std::stri
 
     std::string mfn(fn);
     mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     if ( ! file.is_open() )
         gsWarn<<"gsWriteParaviewPoints: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data(fmt);
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"PolyData\" "<< data.fileAttributes() <<">\n";
     file <<"<PolyData>\n";
     file <<"<Piece NumberOfPoints=\""<<np<<"\" NumberOfVerts=\"1\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n";
     file <<"<PointData>\n";
@@ -1012,39 +1069,31 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, std::stri
     file <<"<CellData>\n";
     file <<"</CellData>\n";
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" Name=\"Points\" NumberOfComponents=\"3\" format=\"ascii\" RangeMin=\""<<X.minCoeff()<<"\" RangeMax=\""<<X.maxCoeff()<<"\">\n";
-    for (index_t i=0; i< np; ++i )
-        file << X(0,i) <<" "<<Y(0,i)<<" "<< 0.0 <<"\n";
-    file <<"\n</DataArray>\n";
+    gsMatrix<T> coords(2, np);
+    coords << X, Y;
+    data.write(file, "Name=\"Points\" NumberOfComponents=\"3\"", internal::vtkTuples(coords, 3));
     file <<"</Points>\n";
     file <<"<Verts>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\""<<0<<"\" RangeMax=\""<<np-1<<"\">\n";
-    for (index_t i=0; i< np; ++i )
-        file << i<<" ";
-    file <<"\n</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n"<<np<<"\n";
-    file <<"</DataArray>\n";
+    const std::string range0 = "RangeMin=\"0\" RangeMax=\""+util::to_string(np-1)+"\"";
+    const std::string range1 = "RangeMin=\""+util::to_string(np)+"\" RangeMax=\""+util::to_string(np)+"\"";
+    data.write(file, "Name=\"connectivity\" "+range0, internal::vtkSequence(np));
+    data.write(file, "Name=\"offsets\" "+range1, std::vector<int>(1, np));
     file <<"</Verts>\n";
     file <<"<Lines>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"connectivity\" "+range0, std::vector<int>());
+    data.write(file, "Name=\"offsets\" "+range1, std::vector<int>());
     file <<"</Lines>\n";
     file <<"<Strips>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"connectivity\" "+range0, std::vector<int>());
+    data.write(file, "Name=\"offsets\" "+range1, std::vector<int>());
     file <<"</Strips>\n";
     file <<"<Polys>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"connectivity\" "+range0, std::vector<int>());
+    data.write(file, "Name=\"offsets\" "+range1, std::vector<int>());
     file <<"</Polys>\n";
     file <<"</Piece>\n";
     file <<"</PolyData>\n";
+    data.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 
@@ -1055,7 +1104,8 @@ template<class T>
 void gsWriteParaviewPoints(gsMatrix<T> const& X,
                            gsMatrix<T> const& Y,
                            gsMatrix<T> const& Z,
-                           std::string const & fn)
+                           std::string const & fn,
+                           const gsParaviewFormat & fmt)
 {
     GISMO_ASSERT(X.cols() == Y.cols() && X.cols() == Z.cols(),
                  "X, Y and Z must have the same size of columns!");
@@ -1065,7 +1115,7 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
 
     std::string mfn(fn);
     mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
 
     if (!file.is_open())
     {
@@ -1075,9 +1125,10 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
 
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data(fmt);
 
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"PolyData\" "<< data.fileAttributes() <<">\n";
     file <<"<PolyData>\n";
     file <<"<Piece NumberOfPoints=\""<<np<<"\" NumberOfVerts=\"1\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n";
     file <<"<PointData>\n"; //empty
@@ -1085,47 +1136,31 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
     file <<"<CellData>\n";
     file <<"</CellData>\n";
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" Name=\"Points\" NumberOfComponents=\"3\" format=\"ascii\" RangeMin=\""<<X.minCoeff()<<"\" RangeMax=\""<<X.maxCoeff()<<"\">\n";
-
-    for (index_t i = 0; i < np; ++i)
-    {
-        file << X(0, i) << " " << Y(0, i) << " " << Z(0, i) << "\n";
-    }
-
-    file <<"\n</DataArray>\n";
+    gsMatrix<T> coords(3, np);
+    coords << X, Y, Z;
+    data.write(file, "Name=\"Points\" NumberOfComponents=\"3\"", internal::vtkTuples(coords, 3));
     file <<"</Points>\n";
     file <<"<Verts>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\""<<0<<"\" RangeMax=\""<<np-1<<"\">\n";
-
-    for (index_t i=0; i< np; ++i )
-    {
-        file << i << " ";
-    }
-
-    file <<"\n</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n"<<np<<"\n";
-    file <<"</DataArray>\n";
+    const std::string range0 = "RangeMin=\"0\" RangeMax=\""+util::to_string(np-1)+"\"";
+    const std::string range1 = "RangeMin=\""+util::to_string(np)+"\" RangeMax=\""+util::to_string(np)+"\"";
+    data.write(file, "Name=\"connectivity\" "+range0, internal::vtkSequence(np));
+    data.write(file, "Name=\"offsets\" "+range1, std::vector<int>(1, np));
     file <<"</Verts>\n";
     file <<"<Lines>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"connectivity\" "+range0, std::vector<int>());
+    data.write(file, "Name=\"offsets\" "+range1, std::vector<int>());
     file <<"</Lines>\n";
     file <<"<Strips>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"connectivity\" "+range0, std::vector<int>());
+    data.write(file, "Name=\"offsets\" "+range1, std::vector<int>());
     file <<"</Strips>\n";
     file <<"<Polys>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"connectivity\" "+range0, std::vector<int>());
+    data.write(file, "Name=\"offsets\" "+range1, std::vector<int>());
     file <<"</Polys>\n";
     file <<"</Piece>\n";
     file <<"</PolyData>\n";
+    data.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 
@@ -1137,7 +1172,8 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
                            gsMatrix<T> const& Y,
                            gsMatrix<T> const& Z,
                            gsMatrix<T> const& V,
-                           std::string const & fn)
+                           std::string const & fn,
+                           const gsParaviewFormat & fmt)
 {
     GISMO_ASSERT(X.cols() == Y.cols() && X.cols() == Z.cols(),
                  "X, Y and Z must have the same size of columns!");
@@ -1147,7 +1183,7 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
 
     std::string mfn(fn);
     mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
 
     if (!file.is_open())
     {
@@ -1157,63 +1193,45 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
 
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data(fmt);
 
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"PolyData\" "<< data.fileAttributes() <<">\n";
     file <<"<PolyData>\n";
     file <<"<Piece NumberOfPoints=\""<<np<<"\" NumberOfVerts=\"1\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n";
     //---------
     file <<"<PointData "<< "Scalars=\"PointInfo\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"PointInfo\" format=\"ascii\" NumberOfComponents=\"1\">\n";
-    for ( index_t j=0; j<np; ++j)
-        file<< V(0,j) <<" ";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"PointInfo\" NumberOfComponents=\"1\"", internal::vtkTuples(V, 1));
     file <<"</PointData>\n";
     //---------
     file <<"<CellData>\n";
     file <<"</CellData>\n";
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" Name=\"Points\" NumberOfComponents=\"3\" format=\"ascii\" RangeMin=\""<<X.minCoeff()<<"\" RangeMax=\""<<X.maxCoeff()<<"\">\n";
-
-    for (index_t i = 0; i < np; ++i)
-    {
-        file << X(0, i) << " " << Y(0, i) << " " << Z(0, i) << "\n";
-    }
-
-    file <<"\n</DataArray>\n";
+    gsMatrix<T> coords(3, np);
+    coords << X, Y, Z;
+    data.write(file, "Name=\"Points\" NumberOfComponents=\"3\"", internal::vtkTuples(coords, 3));
     file <<"</Points>\n";
     file <<"<Verts>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\""<<0<<"\" RangeMax=\""<<np-1<<"\">\n";
-
-    for (index_t i=0; i< np; ++i )
-    {
-        file << i << " ";
-    }
-
-    file <<"\n</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n"<<np<<"\n";
-    file <<"</DataArray>\n";
+    const std::string range0 = "RangeMin=\"0\" RangeMax=\""+util::to_string(np-1)+"\"";
+    const std::string range1 = "RangeMin=\""+util::to_string(np)+"\" RangeMax=\""+util::to_string(np)+"\"";
+    data.write(file, "Name=\"connectivity\" "+range0, internal::vtkSequence(np));
+    data.write(file, "Name=\"offsets\" "+range1, std::vector<int>(1, np));
     file <<"</Verts>\n";
     file <<"<Lines>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"connectivity\" "+range0, std::vector<int>());
+    data.write(file, "Name=\"offsets\" "+range1, std::vector<int>());
     file <<"</Lines>\n";
     file <<"<Strips>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"connectivity\" "+range0, std::vector<int>());
+    data.write(file, "Name=\"offsets\" "+range1, std::vector<int>());
     file <<"</Strips>\n";
     file <<"<Polys>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<np-1<<"\">\n";
-    file <<"</DataArray>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\""<<np<<"\" RangeMax=\""<<np<<"\">\n";
-    file <<"</DataArray>\n";
+    data.write(file, "Name=\"connectivity\" "+range0, std::vector<int>());
+    data.write(file, "Name=\"offsets\" "+range1, std::vector<int>());
     file <<"</Polys>\n";
     file <<"</Piece>\n";
     file <<"</PolyData>\n";
+    data.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 
@@ -1221,22 +1239,23 @@ void gsWriteParaviewPoints(gsMatrix<T> const& X,
 }
 
 template<class T>
-void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn)
+void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn,
+                           const gsParaviewFormat & fmt)
 {
     const index_t rows = points.rows();
     switch (rows)
     {
     case 1:
-        gsWriteParaviewPoints<T>(points.row(0), gsMatrix<T>::Zero(1, points.cols()), fn);
+        gsWriteParaviewPoints<T>(points.row(0), gsMatrix<T>::Zero(1, points.cols()), fn, fmt);
         break;
     case 2:
-        gsWriteParaviewPoints<T>(points.row(0), points.row(1), fn);
+        gsWriteParaviewPoints<T>(points.row(0), points.row(1), fn, fmt);
         break;
     case 3:
-        gsWriteParaviewPoints<T>(points.row(0), points.row(1), points.row(2), fn);
+        gsWriteParaviewPoints<T>(points.row(0), points.row(1), points.row(2), fn, fmt);
         break;
     case 4:
-        gsWriteParaviewPoints<T>(points.row(0), points.row(1), points.row(2), points.row(3), fn);
+        gsWriteParaviewPoints<T>(points.row(0), points.row(1), points.row(2), points.row(3), fn, fmt);
         break;
     default:
         GISMO_ERROR("Point plotting is implemented just for 2D and 3D (rows== 1, 2 or 3).");
@@ -1265,13 +1284,14 @@ void gsWriteParaview(gsSolid<T> const& sl, std::string const & fn, unsigned numP
 
     std::string mfn(fn);
     mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     if ( ! file.is_open() )
         gsWarn<<"gsWriteParaview: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data;
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"PolyData\" "<< data.fileAttributes() <<">\n";
     file <<"<PolyData>\n";
 
 
@@ -1324,51 +1344,36 @@ void gsWriteParaview(gsSolid<T> const& sl, std::string const & fn, unsigned numP
 
                 /// Coordinates of vertices
                 file <<"<Points>\n";
-                file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">\n";
                 // translate the volume towards the *translate* vector
+                gsMatrix<T> pts(3, 2*curvePoints.cols());
                 for (index_t iCol = 0;iCol!=curvePoints.cols();iCol++)
                 {
-                    file << curvePoints(0,iCol) + translate(0) << " " << curvePoints(1,iCol) + translate(1) << " " << curvePoints(2,iCol) + translate(2) << " \n";
+                    pts.col(2*iCol  ) = curvePoints.col(iCol).topRows(3) + translate;
                     // translate the vertex about along the vector (faceThick,0,0)
-                    file << curvePoints(0,iCol) + faceThick + translate(0) << " " << curvePoints(1,iCol) + faceThick + translate(1)
-                         << " " << curvePoints(2,iCol) +faceThick + translate(2) << " \n";
+                    pts.col(2*iCol+1) = pts.col(2*iCol).array() + faceThick;
                 };
-                file << "\n";
-                file <<"</DataArray>\n";
+                data.write(file, "NumberOfComponents=\"3\"", internal::vtkTuples(pts, 3));
                 file <<"</Points>\n";
 
                 /// Scalar field attached to each degenerate face on the "edge"
                 file << "<CellData Scalars=\"cell_scalars\">\n";
-                file << "<DataArray type=\"Int32\" Name=\"cell_scalars\" format=\"ascii\">\n";
                 /// limit: for now, assign all scalars to 0
-                for (index_t iCol = 0;iCol!=curvePoints.cols()-1;iCol++)
-                {
-                    file << color << " ";
-                }
-                file << "\n";
-                file << "</DataArray>\n";
+                data.write(file, "Name=\"cell_scalars\"", std::vector<int>(curvePoints.cols()-1, color));
                 file << "</CellData>\n";
 
                 /// Which vertices belong to which faces
                 file << "<Polys>\n";
-                file << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
+                std::vector<int> conn;
+                conn.reserve(4*(curvePoints.cols()-1));
                 for (index_t iCol = 0;iCol<=curvePoints.cols()-2;iCol++)
                 {
-                    //file << iCol << " " << iCol+1 << " "<< iCol+1 << " " << iCol << " ";
-                    file << 2*iCol << " " << 2*iCol+1 << " "<< 2*iCol+3 << " " << 2*iCol+2 << " ";
-                }
-                //file << curvePoints.cols()-1 << " " << 0 << " "<< 0 << " "<< curvePoints.cols()-1 << " ";
-                file << "\n";
-                file << "</DataArray>\n";
-                file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-                unsigned offsets(0);
-                for (index_t iCol = 0;iCol!=curvePoints.cols()-1;iCol++)
-                {
-                    offsets +=4;
-                    file << offsets << " ";
+                    conn.push_back(2*iCol  );
+                    conn.push_back(2*iCol+1);
+                    conn.push_back(2*iCol+3);
+                    conn.push_back(2*iCol+2);
                 }
-                file << "\n";
-                file << "</DataArray>\n";
+                data.write(file, "Name=\"connectivity\"", conn);
+                data.write(file, "Name=\"offsets\"", internal::vtkSequence(curvePoints.cols()-1, 4, 4));
                 file << "</Polys>\n";
 
                 file << "</Piece>\n";
@@ -1381,6 +1386,7 @@ void gsWriteParaview(gsSolid<T> const& sl, std::string const & fn, unsigned numP
     }
 
     file <<"</PolyData>\n";
+    data.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 
@@ -1412,18 +1418,20 @@ void gsWriteParaviewSolid(gsSolid<T> const& sl,
 
 /// Visualizing a mesh
 template <class T>
-void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd)
+void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd,
+                     const gsParaviewFormat & fmt)
 {
     std::string mfn(fn);
     mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     if ( ! file.is_open() )
         gsWarn<<"gsWriteParaview: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data(fmt);
 
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"PolyData\" "<< data.fileAttributes() <<">\n";
     file <<"<PolyData>\n";
 
     /// Number of vertices and number of faces
@@ -1432,17 +1440,7 @@ void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd)
 
     /// Coordinates of vertices
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">\n";
-    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertices().begin(); it!=sl.vertices().end(); ++it)
-    {
-        const gsVertex<T>& vertex = **it;
-        file << vertex[0] << " ";
-        file << vertex[1] << " ";
-        file << vertex[2] << " \n";
-    }
-
-    file << "\n";
-    file <<"</DataArray>\n";
+    data.write(file, "NumberOfComponents=\"3\"", internal::vtkVertices(sl));
     file <<"</Points>\n";
 
     // Scalar field attached to each face
@@ -1459,23 +1457,16 @@ void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd)
 
     // Write out edges
     file << "<Lines>\n";
-    file << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
-    for (typename std::vector< gsEdge<T> >::const_iterator it=sl.edges().begin();
-         it!=sl.edges().end(); ++it)
-    {
-            file << it->source->getId() << " " << it->target->getId() << "\n";
-    }
-    file << "</DataArray>\n";
-    file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-    int count=0;
+    std::vector<int> conn;
+    conn.reserve(2*sl.numEdges());
     for (typename std::vector< gsEdge<T> >::const_iterator it=sl.edges().begin();
          it!=sl.edges().end(); ++it)
     {
-        count+=2;
-        file << count << " ";
+        conn.push_back(it->source->getId());
+        conn.push_back(it->target->getId());
     }
-    file << "\n";
-    file << "</DataArray>\n";
+    data.write(file, "Name=\"connectivity\"", conn);
+    data.write(file, "Name=\"offsets\"", internal::vtkSequence(sl.numEdges(), 2, 2));
     file << "</Lines>\n";
 
     // Scalar field attached to each face (* if edges exists, this has a problem)
@@ -1492,32 +1483,26 @@ void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd)
 
     /// Which vertices belong to which faces
     file << "<Polys>\n";
-    file << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
+    std::vector<int> offsets;
+    offsets.reserve(sl.numFaces());
+    conn.clear();
     for (typename std::vector< gsFace<T>* >::const_iterator it=sl.faces().begin();
          it!=sl.faces().end(); ++it)
     {
         for (typename std::vector< gsVertex<T>* >::const_iterator vit= (*it)->vertices.begin();
              vit!=(*it)->vertices.end(); ++vit)
         {
-            file << (*vit)->getId() << " ";
+            conn.push_back((*vit)->getId());
         }
-        file << "\n";
-    }
-    file << "</DataArray>\n";
-    file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-    count=0;
-    for (typename std::vector< gsFace<T>* >::const_iterator it=sl.faces().begin();
-         it!=sl.faces().end(); ++it)
-    {
-        count += (*it)->vertices.size();
-        file << count << " ";
+        offsets.push_back(conn.size());
     }
-    file << "\n";
-    file << "</DataArray>\n";
+    data.write(file, "Name=\"connectivity\"", conn);
+    data.write(file, "Name=\"offsets\"", offsets);
     file << "</Polys>\n";
 
     file << "</Piece>\n";
     file <<"</PolyData>\n";
+    data.finish(file);
     file <<"</VTKFile>\n";
     file.close();
 
@@ -1642,7 +1627,7 @@ void gsWriteParaviewTrimmedCurve(const gsTrimSurface<T>& surf,
     std::string myFile(fn);
     myFile.append(".vts");
 
-    std::ofstream file(myFile.c_str());
+    std::ofstream file(myFile.c_str(), std::ios::binary);
     if (!file.is_open())
     {
         gsWarn << "Problem opening " << fn << " Aborting..." << std::endl;
@@ -1651,9 +1636,10 @@ void gsWriteParaviewTrimmedCurve(const gsTrimSurface<T>& surf,
 
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataWriter data;
 
     file << "<?xml version=\"1.0\"?>\n";
-    file << "<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file << "<VTKFile type=\"StructuredGrid\" "<< data.fileAttributes() <<">\n";
     file << "<StructuredGrid WholeExtent=\"0 "<< np(0) - 1 <<
             " 0 " << np(1) - 1 << " 0 " << np(2) - 1 << "\">\n";
 
@@ -1661,22 +1647,12 @@ void gsWriteParaviewTrimmedCurve(const gsTrimSurface<T>& surf,
          << np(2) - 1 << "\">\n";
 
     file << "<Points>\n";
-    file << "<DataArray type=\"Float32\" NumberOfComponents=\"" << points.rows()
-         << "\">\n";
-
-    for (index_t j = 0; j < points.cols(); ++j)
-    {
-        for (index_t i = 0; i < points.rows(); ++i)
-        {
-            file << points(i, j) << " ";
-        }
-        file << "\n";
-    }
-
-    file << "</DataArray>\n";
+    data.write(file, "NumberOfComponents=\"" + util::to_string(points.rows()) + "\"",
+               internal::vtkTuples(points, points.rows()));
     file << "</Points>\n";
     file << "</Piece>\n";
     file << "</StructuredGrid>\n";
+    data.finish(file);
     file << "</VTKFile>\n";
     file.close();
 
@@ -12,19 +12,19 @@ namespace gismo
   
 TEMPLATE_INST
 void gsWriteParaview(const gsField<T> & field, std::string const & fn, 
-                     unsigned npts, bool mesh);
+                     unsigned npts, bool mesh, const gsParaviewFormat & fmt);
 
 TEMPLATE_INST
 void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn, 
-                     unsigned npts, bool mesh, bool ctrlNet);
+                     unsigned npts, bool mesh, bool ctrlNet, const gsParaviewFormat & fmt);
 
 TEMPLATE_INST
 void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo, std::string const & fn, 
-                      unsigned npts, bool mesh, bool ctrlNet);
+                      unsigned npts, bool mesh, bool ctrlNet, const gsParaviewFormat & fmt);
 
 TEMPLATE_INST
 void gsWriteParaview(const gsMultiBasis<T> & mb, const gsMultiPatch<T> & domain,
-                     std::string const & fn, unsigned npts);
+                     std::string const & fn, unsigned npts, const gsParaviewFormat & fmt);
 
 TEMPLATE_INST
 void gsWriteParaview_basisFnct(int i, gsBasis<T> const& basis, std::string const & fn, 
@@ -41,22 +41,27 @@ void gsWriteParaview(gsBasis<T> const& basis, std::string const & fn,
                      unsigned npts, bool mesh);
 
 TEMPLATE_INST
-void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, std::string const & fn);
+void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, std::string const & fn,
+                           const gsParaviewFormat & fmt);
 
 TEMPLATE_INST
-void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, gsMatrix<T> const& z, std::string const & fn);
+void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, gsMatrix<T> const& z, std::string const & fn,
+                           const gsParaviewFormat & fmt);
 
 TEMPLATE_INST
-void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, gsMatrix<T> const& z, gsMatrix<T> const& v, std::string const & fn);
+void gsWriteParaviewPoints(gsMatrix<T> const& X, gsMatrix<T> const& Y, gsMatrix<T> const& z, gsMatrix<T> const& v, std::string const & fn,
+                           const gsParaviewFormat & fmt);
 
 TEMPLATE_INST
-void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn);
+void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn,
+                           const gsParaviewFormat & fmt);
 
 TEMPLATE_INST
 void gsWriteParaviewTPgrid(gsMatrix<T> const& points,
                            gsMatrix<T> const& data,
                            const gsVector<index_t> & np,
-                           std::string const & fn);
+                           std::string const & fn,
+                           const gsParaviewFormat & fmt);
 
 TEMPLATE_INST
 void gsWriteParaview(gsSolid<T> const& sl, std::string const & fn, unsigned numPoints_for_eachCurve, int vol_Num,
@@ -69,7 +74,8 @@ void gsWriteParaviewSolid(gsSolid<T> const  & sl,
                      unsigned numSamples );
 
 TEMPLATE_INST
-void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd);
+void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd,
+                     const gsParaviewFormat & fmt);
 
 TEMPLATE_INST
 void gsWriteParaview(const std::vector<gsMesh<T> >& sl, std::string const & fn);
@@ -101,7 +107,8 @@ TEMPLATE_INST
 void writeSinglePatchField(const gsFunction<T> & geometry,
                            const gsFunction<T> & parField,
                            const bool isParam,
-                           std::string const & fn, unsigned npts);
+                           std::string const & fn, unsigned npts,
+                           const gsParaviewFormat & fmt);
 
 
 } // namespace gismo
@@ -13,6 +13,18 @@
 
 #include <fstream>
 #include <iomanip>      // std::setprecision
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+
+#if defined _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsCore/gsBoxTopology.h>
@@ -34,6 +46,225 @@ char * makeValue( const std::string & value, gsXmlTree & data)
     return data.allocate_string( value.c_str() );
 }
 
+namespace {
+
+inline bool isLittleEndian()
+{
+    const int one = 1;
+    return 1 == *reinterpret_cast<const char*>(&one);
+}
+
+inline void swapBytes(char * bytes, const size_t size)
+{
+    for (size_t i = 0; i < size; i += sizeof(double))
+        std::reverse(bytes + i, bytes + i + sizeof(double));
+}
+
+inline bool isSpace(const char c)
+{ return ' '==c || '\n'==c || '\t'==c || '\r'==c || '\v'==c || '\f'==c; }
+
+inline bool isDigit(const char c)
+{ return c >= '0' && c <= '9'; }
+
+}
+
+char * makeBinaryValue( const std::vector<double> & value, gsXmlTree & data)
+{
+    std::string enc;
+    if ( !value.empty() )
+    {
+        const size_t size = value.size() * sizeof(double);
+        if ( isLittleEndian() )
+            encodeBase64(reinterpret_cast<const char*>(&value[0]), size, enc);
+        else
+        {
+            std::vector<char> bytes(size);
+            memcpy(&bytes[0], &value[0], size);
+            swapBytes(&bytes[0], size);
+            encodeBase64(&bytes[0], size, enc);
+        }
+    }
+    return data.allocate_string( enc.c_str() );
+}
+
+bool getBinaryValue( const char * str, std::vector<double> & result)
+{
+    std::string bytes;
+    if ( !decodeBase64(str, bytes) || 0 != bytes.size() % sizeof(double) )
+        return false;
+
+    result.resize( bytes.size() / sizeof(double) );
+    if ( !bytes.empty() )
+    {
+        if ( !isLittleEndian() )
+            swapBytes(&bytes[0], bytes.size());
+        memcpy(&result[0], bytes.data(), bytes.size());
+    }
+    return true;
+}
+
+bool isBinaryNode( const gsXmlNode * node)
+{
+    const gsXmlAttribute * format = node->first_attribute("format");
+    return NULL != format && !strcmp(format->value(), "base64");
+}
+
+void encodeBase64( const char * bytes, const size_t size, std::string & out)
+{
+    static const char table[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const unsigned char * in = reinterpret_cast<const unsigned char*>(bytes);
+
+    out.reserve( out.size() + 4 * ((size+2)/3) );
+    size_t i = 0;
+    for (; i + 2 < size; i += 3)
+    {
+        out.push_back( table[   in[i] >> 2                               ] );
+        out.push_back( table[ ((in[i  ] & 0x03) << 4) | (in[i+1] >> 4)   ] );
+        out.push_back( table[ ((in[i+1] & 0x0f) << 2) | (in[i+2] >> 6)   ] );
+        out.push_back( table[   in[i+2] & 0x3f                           ] );
+    }
+
+    if (i + 1 == size)
+    {
+        out.push_back( table[   in[i] >> 2          ] );
+        out.push_back( table[  (in[i] & 0x03) << 4  ] );
+        out.append("==");
+    }
+    else if (i + 2 == size)
+    {
+        out.push_back( table[   in[i] >> 2                             ] );
+        out.push_back( table[ ((in[i  ] & 0x03) << 4) | (in[i+1] >> 4) ] );
+        out.push_back( table[  (in[i+1] & 0x0f) << 2                   ] );
+        out.push_back('=');
+    }
+}
+
+bool decodeBase64( const char * str, std::string & out)
+{
+    // Value of each character, 64 for whitespace, 65 for invalid ones
+    static const unsigned char table[256] = {
+        65,65,65,65,65,65,65,65,65,64,64,64,64,64,65,65,
+        65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,
+        64,65,65,65,65,65,65,65,65,65,65,62,65,65,65,63,
+        52,53,54,55,56,57,58,59,60,61,65,65,65,65,65,65,
+        65, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,
+        15,16,17,18,19,20,21,22,23,24,25,65,65,65,65,65,
+        65,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,
+        41,42,43,44,45,46,47,48,49,50,51,65,65,65,65,65,
+        65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,
+        65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,
+        65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,
+        65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,
+        65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,
+        65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,
+        65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,
+        65,65,65,65,65,65,65,65,65,65,65,65,65,65,65,65 };
+
+    const size_t len   = strlen(str);
+    const size_t first = out.size();
+    out.resize( first + 3 * (len / 4) + 3 );
+    char * o = &out[first];
+
+    const unsigned char * in = reinterpret_cast<const unsigned char*>(str);
+    unsigned buf  = 0;
+    int      bits = 0;
+    for (; '\0' != *in && '=' != *in; ++in)
+    {
+        const unsigned v = table[*in];
+        if (v > 63)
+        {
+            if (64 == v) continue; // whitespace
+            out.resize(first);
+            return false;
+        }
+        buf   = (buf << 6) | v;
+        bits += 6;
+        if (bits >= 8)
+        {
+            bits -= 8;
+            *o++ = static_cast<char>( (buf >> bits) & 0xff );
+        }
+    }
+    out.resize( o - out.data() );
+    return true;
+}
+
+bool parseReal( const char * & str, double & val)
+{
+    // Powers of ten which are exactly representable as doubles
+    static const double pow10[] = {1e0 , 1e1 , 1e2 , 1e3 , 1e4 , 1e5 ,
+                                   1e6 , 1e7 , 1e8 , 1e9 , 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                   1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char * p = str;
+    while ( isSpace(*p) ) ++p;
+    if ( '\0' == *p ) return false;
+    const char * start = p;
+
+    const bool neg = ('-' == *p);
+    if ( neg || '+' == *p ) ++p;
+
+    // Read up to 19 significant digits into the integer m, the value
+    // is m * 10^e
+    uint64_t m = 0;
+    int  nd = 0, e = 0;
+    bool digits = false, exact = true;
+    for (; isDigit(*p); ++p, digits = true)
+    {
+        if (nd < 19) { m = 10*m + (*p - '0'); if (0 != m) ++nd; }
+        else { ++e; exact &= ('0' == *p); }
+    }
+    if ( '.' == *p )
+        for (++p; isDigit(*p); ++p, digits = true)
+        {
+            if (nd < 19) { m = 10*m + (*p - '0'); if (0 != m) ++nd; --e; }
+            else exact &= ('0' == *p);
+        }
+    if ( digits && ('e' == *p || 'E' == *p) )
+    {
+        const char * q = p + 1;
+        const bool eneg = ('-' == *q);
+        if ( eneg || '+' == *q ) ++q;
+        if ( isDigit(*q) )
+        {
+            int x = 0;
+            for (; isDigit(*q); ++q)
+                if (x < 100000) x = 10*x + (*q - '0');
+            e += ( eneg ? -x : x );
+            p = q;
+        }
+    }
+
+    // Both m and 10^|e| are exact, hence the result is correctly rounded
+    if ( digits && exact && m <= (uint64_t(1) << 53) && e >= -22 && e <= 22 )
+    {
+        val = ( e < 0 ? m / pow10[-e] : m * pow10[e] );
+        if (neg) val = -val;
+    }
+    else // long mantissa, large exponent, inf, nan, ...
+    {
+        char * end;
+        val = strtod(start, &end);
+        if ( end == start ) return false;
+        p = end;
+    }
+
+    if ( '/' == *p ) // fraction
+    {
+        ++p;
+        double den;
+        if ( isSpace(*p) || !parseReal(p, den) ) return false;
+        val /= den;
+    }
+
+    // The number has to be followed by a separator
+    if ( '\0' != *p && !isSpace(*p) ) return false;
+    str = p;
+    return true;
+}
+
 gsXmlAttribute * makeAttribute( const std::string & name, const std::string & value, gsXmlTree & data)
 {
     return data.allocate_attribute( 
@@ -303,6 +534,307 @@ void getBoundaries(gsXmlNode * node, std::map<int, int> & ids,
     }
 }
 
+/* Lazy reading of XML files */
+
+namespace {
+
+// Returns the position after the first occurrence of \a pat in
+// [p,end), or end if there is none
+const char * skipPast(const char * p, const char * end, const char * pat)
+{
+    const size_t n = strlen(pat);
+    while ( p < end && (p = static_cast<const char*>(memchr(p, pat[0], end - p))) )
+    {
+        if ( static_cast<size_t>(end - p) < n )
+            break;
+        if ( !memcmp(p, pat, n) )
+            return p + n;
+        ++p;
+    }
+    return end;
+}
+
+// Skips a comment, CDATA section, processing instruction or
+// declaration starting at p, which points to '<'. Returns NULL if
+// there is none at p.
+const char * skipMarkup(const char * p, const char * end)
+{
+    if ( end - p < 2 ) return NULL;
+    if ( p[1] == '?' )
+        return skipPast(p + 2, end, "?>");
+    if ( p[1] != '!' ) return NULL;
+    if ( end - p >= 4 && !memcmp(p, "<!--", 4) )
+        return skipPast(p + 4, end, "-->");
+    if ( end - p >= 9 && !memcmp(p, "<![CDATA[", 9) )
+        return skipPast(p + 9, end, "]]>");
+    return skipPast(p + 2, end, ">");
+}
+
+// Scans the start tag at p, which points to '<'. Returns the
+// position after the tag; \a empty is set if the tag is closed by
+// "/>". The tag name and the attributes "type" and "id" are stored
+// if the pointers are non-NULL.
+const char * scanStartTag(const char * p, const char * end, bool & empty,
+                          std::string * name = NULL, std::string * type = NULL,
+                          int * id = NULL)
+{
+    const char * s = ++p;
+    while ( p < end && !isSpace(*p) && *p != '>' && *p != '/' ) ++p;
+    if ( name ) name->assign(s, p);
+
+    while ( p < end )
+    {
+        if ( *p == '>' )
+        {
+            empty = ( p[-1] == '/' );
+            return p + 1;
+        }
+        if ( isSpace(*p) || *p == '/' )
+        {
+            ++p;
+            continue;
+        }
+
+        // Attribute name="value"
+        s = p;
+        while ( p < end && !isSpace(*p) && *p != '=' && *p != '>' && *p != '/' ) ++p;
+        const size_t n = p - s;
+        while ( p < end && isSpace(*p) ) ++p;
+        if ( p == end || *p != '=' ) continue;
+        ++p;
+        while ( p < end && isSpace(*p) ) ++p;
+        if ( p == end || (*p != '"' && *p != '\'') ) continue;
+        const char * q = static_cast<const char*>(memchr(p + 1, *p, end - p - 1));
+        if ( !q ) return end;
+        if ( type && n == 4 && !memcmp(s, "type", 4) )
+            type->assign(p + 1, q);
+        else if ( id && n == 2 && !memcmp(s, "id", 2) )
+            *id = atoi( std::string(p + 1, q).c_str() );
+        p = q + 1;
+    }
+    return end;
+}
+
+// Skips the contents and the end tag of the element whose start tag
+// ends right before p
+const char * skipElement(const char * p, const char * end)
+{
+    for (int depth = 1; depth; )
+    {
+        p = static_cast<const char*>(memchr(p, '<', end - p));
+        if ( !p ) return end;
+
+        if ( const char * q = skipMarkup(p, end) )
+            p = q;
+        else if ( p + 1 < end && p[1] == '/' )
+        {
+            p = skipPast(p, end, ">");
+            --depth;
+        }
+        else
+        {
+            bool empty = false;
+            p = scanStartTag(p, end, empty);
+            if ( !empty ) ++depth;
+        }
+    }
+    return p;
+}
+
+}
+
+gsXmlLazyFile::gsXmlLazyFile()
+: m_data(NULL), m_size(0)
+{ }
+
+bool gsXmlLazyFile::open(const std::string & fn)
+{
+    close();
+
+#if defined _WIN32
+    std::ifstream file(fn.c_str(), std::ios::in | std::ios::binary);
+    if ( file.fail() )
+        return false;
+    m_buffer.assign( std::istreambuf_iterator<char>(file.rdbuf()),
+                     std::istreambuf_iterator<char>() );
+    m_data = m_buffer.empty() ? NULL : &m_buffer[0];
+    m_size = m_buffer.size();
+#else
+    const int fd = ::open(fn.c_str(), O_RDONLY);
+    if ( fd < 0 )
+        return false;
+    struct stat st;
+    if ( fstat(fd, &st) == 0 && st.st_size > 0 )
+    {
+        void * map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if ( map != MAP_FAILED )
+        {
+            m_data = static_cast<const char*>(map);
+            m_size = st.st_size;
+        }
+    }
+    ::close(fd);
+#endif
+
+    if ( !m_data || !index() )
+    {
+        close();
+        return false;
+    }
+    m_fn = fn;
+    return true;
+}
+
+void gsXmlLazyFile::close()
+{
+#if !defined _WIN32
+    if ( m_data )
+        munmap(const_cast<char*>(m_data), m_size);
+#endif
+    m_buffer.clear();
+    m_data = NULL;
+    m_size = 0;
+    m_fn.clear();
+    m_index.clear();
+    m_ids.clear();
+}
+
+bool gsXmlLazyFile::index()
+{
+    const char * p = m_data, * end = m_data + m_size;
+    bool empty = false;
+
+    // Find the root tag
+    for (;;)
+    {
+        p = static_cast<const char*>(memchr(p, '<', end - p));
+        if ( !p ) return false;
+        if ( const char * q = skipMarkup(p, end) )
+        {
+            p = q;
+            continue;
+        }
+        std::string name;
+        p = scanStartTag(p, end, empty, &name);
+        if ( name != "xml" ) return false;
+        break;
+    }
+    if ( empty ) return true;
+
+    // Index the children of the root
+    for (;;)
+    {
+        p = static_cast<const char*>(memchr(p, '<', end - p));
+        if ( !p || (p + 1 < end && p[1] == '/') )
+            break;
+        if ( const char * q = skipMarkup(p, end) )
+        {
+            p = q;
+            continue;
+        }
+
+        Entry e;
+        e.id   = -1;
+        e.node = NULL;
+        e.begin = p - m_data;
+        p = scanStartTag(p, end, empty, &e.tag, &e.type, &e.id);
+        if ( !empty )
+            p = skipElement(p, end);
+        e.end = p - m_data;
+
+        if ( e.id != -1 )
+            m_ids.insert( std::make_pair(e.id, m_index.size()) );
+        m_index.push_back(e);
+    }
+    return true;
+}
+
+int gsXmlLazyFile::count(const std::string & tag, const std::string & type) const
+{
+    int c = 0;
+    for (std::vector<Entry>::const_iterator it = m_index.begin(); it != m_index.end(); ++it)
+        if ( (tag.empty() || it->tag == tag) && (type.empty() || it->type == type) )
+            ++c;
+    return c;
+}
+
+gsXmlNode * gsXmlLazyFile::load(size_t i, gsXmlTree & data)
+{
+    Entry & e = m_index[i];
+    if ( e.node )
+        return e.node;
+
+    // Parse a copy of the node, which persists in the memory pool of data
+    const size_t len = e.end - e.begin;
+    char * buf = data.allocate_string(NULL, len + 1);
+    memcpy(buf, m_data + e.begin, len);
+    buf[len] = '\0';
+    gsXmlTree tmp;
+    try
+    {
+        tmp.parse<0>(buf);
+    }
+    catch (rapidxml::parse_error & err)
+    {
+        gsWarn<<"gsFileData: Problem with file "<<m_fn<<": "<<err.what()
+              <<" in <"<<e.tag<<"> at byte "<<e.begin + (err.where<char>() - buf)<<".\n";
+        return NULL;
+    }
+    e.node = data.clone_node( tmp.first_node() );
+
+    // Keep the file order of the loaded nodes
+    gsXmlNode * root = data.first_node("xml");
+    size_t j = i + 1;
+    while ( j < m_index.size() && !m_index[j].node ) ++j;
+    if ( j < m_index.size() && m_index[j].node->parent() == root )
+        root->insert_node(m_index[j].node, e.node);
+    else
+        root->append_node(e.node);
+
+    // Load the objects referenced by id (eg. patches of a MultiPatch)
+    if ( gsXmlNode * ref = e.node->first_node("patches") )
+    {
+        const gsXmlAttribute * rtype = ref->first_attribute("type");
+        const char * str = ref->value();
+        char * next;
+        if ( rtype && !strcmp(rtype->value(), "id_range") )
+        {
+            const long first = strtol(str, &next, 10);
+            const long last  = strtol(next, NULL, 10);
+            for (long k = first; k <= last; ++k)
+                loadId(k, data);
+        }
+        else if ( rtype && !strcmp(rtype->value(), "id_index") )
+        {
+            for (long k = strtol(str, &next, 10); next != str; k = strtol(str, &next, 10))
+            {
+                loadId(k, data);
+                str = next;
+            }
+        }
+    }
+    return e.node;
+}
+
+void gsXmlLazyFile::loadTag(const std::string & tag, const std::string & type,
+                            gsXmlTree & data, bool all)
+{
+    for (size_t i = 0; i != m_index.size(); ++i)
+        if ( (tag.empty() || m_index[i].tag == tag) &&
+             (type.empty() || m_index[i].type == type) )
+        {
+            load(i, data);
+            if ( !all ) return;
+        }
+}
+
+gsXmlNode * gsXmlLazyFile::loadId(int id, gsXmlTree & data)
+{
+    std::map<int,size_t>::const_iterator it = m_ids.find(id);
+    return it == m_ids.end() ? NULL : load(it->second, data);
+}
+
+
 }// end namespace internal
 
 }// end namespace gismo
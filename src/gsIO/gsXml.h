@@ -257,6 +257,56 @@ template<class T>
 char * makeValue(const gsMatrix<T> & value, gsXmlTree & data,
                  bool transposed);
 
+/// Helper to allocate binary data (little-endian 64-bit floats) as a
+/// base64-encoded XML value
+GISMO_EXPORT char * makeBinaryValue( const std::vector<double> & value, gsXmlTree & data);
+
+/// Helper to fetch binary data written by makeBinaryValue. Returns
+/// false if \a str is not valid base64 data of 64-bit floats
+GISMO_EXPORT bool getBinaryValue( const char * str, std::vector<double> & result);
+
+/// Helper to check whether the value of \a node is binary data
+/// (attribute format="base64")
+GISMO_EXPORT bool isBinaryNode( const gsXmlNode * node);
+
+/// Helper to encode \a size bytes in base64, the result is appended
+/// to \a out
+GISMO_EXPORT void encodeBase64( const char * bytes, size_t size, std::string & out);
+
+/// Helper to decode a base64 string, the result is appended to \a
+/// out. Whitespace is ignored. Returns false on invalid characters
+GISMO_EXPORT bool decodeBase64( const char * str, std::string & out);
+
+/// Helper to read a real number (decimal or fraction p/q) from the
+/// whitespace-separated values of \a str. On success \a str is
+/// advanced past the number and true is returned. A value with
+/// trailing characters (e.g. "1.5abc") is rejected and \a str is left
+/// unchanged.
+///
+/// Numbers whose significant digits form an integer of at most 2^53
+/// and with a decimal exponent of magnitude at most 22 are converted
+/// exactly without calling strtod, all others are passed to strtod.
+GISMO_EXPORT bool parseReal( const char * & str, double & val);
+
+/// True if the entries of a matrix with scalar type \a T are stored
+/// as binary data (only machine floats, which are exact as doubles)
+template<class T>
+inline bool writeBinary(const gsXmlTree & data)
+{
+    return data.getBinaryMatrices()
+        && std::numeric_limits<T>::is_iec559
+        && std::numeric_limits<T>::digits <= std::numeric_limits<double>::digits;
+}
+
+/// True if the text values with scalar type \a T are read with
+/// parseReal
+template<class T>
+inline bool parseFast()
+{
+    return std::numeric_limits<T>::is_iec559
+        && std::numeric_limits<T>::digits <= std::numeric_limits<double>::digits;
+}
+
 /// Helper to allocate XML attribute
 GISMO_EXPORT gsXmlAttribute *  makeAttribute( const std::string & name,
 				              const std::string & value, gsXmlTree & data);
@@ -355,6 +405,76 @@ template<class T>
 gsXmlNode * putSparseMatrixToXml ( gsSparseMatrix<T> const & mat,
                                    gsXmlTree & data, std::string name = "SparseMatrix");
 
+/// \brief Index of the top-level objects of a G+Smo XML file, used
+/// by gsFileData to read files lazily.
+///
+/// The file is mapped to memory and scanned once for the tag, type
+/// and id of every child of the root tag \<xml\>. A node is parsed
+/// only when it is requested, and then it is inserted into the XML
+/// tree at its position in the file.
+class GISMO_EXPORT gsXmlLazyFile
+{
+public:
+    /// A top-level node of the file
+    struct Entry
+    {
+        std::string tag, type;
+        int id;             ///< value of the id attribute, or -1
+        size_t begin, end;  ///< byte range of the node in the file
+        gsXmlNode * node;   ///< parsed node, or NULL if not loaded yet
+    };
+
+    gsXmlLazyFile();
+
+    ~gsXmlLazyFile() { close(); }
+
+    /// Maps the file \a fn to memory and indexes its top-level
+    /// nodes. Returns false if the file cannot be mapped or has no
+    /// \<xml\> root tag.
+    bool open(const std::string & fn);
+
+    /// Releases the file and the index
+    void close();
+
+    /// Returns the top-level nodes of the file, in file order
+    const std::vector<Entry> & entries() const { return m_index; }
+
+    /// Counts the top-level nodes with \a tag and \a type (empty
+    /// strings match everything), without parsing them
+    int count(const std::string & tag, const std::string & type) const;
+
+    /// Parses the \a i-th top-level node into \a data. The objects
+    /// which it references by id in a \<patches\> child are loaded as
+    /// well. If the node is malformed, a warning with the file name
+    /// is printed and NULL is returned.
+    gsXmlNode * load(size_t i, gsXmlTree & data);
+
+    /// Loads the first node with \a tag and \a type, or all of them
+    /// if \a all is true. Empty strings match every node
+    void loadTag(const std::string & tag, const std::string & type,
+                 gsXmlTree & data, bool all = false);
+
+    /// Loads the node with the given \a id, returns NULL if there is none
+    gsXmlNode * loadId(int id, gsXmlTree & data);
+
+private:
+    bool index();
+
+private:
+    std::string m_fn;
+    const char * m_data;
+    size_t m_size;
+
+    // Holds the file contents if it cannot be mapped to memory
+    std::vector<char> m_buffer;
+
+    std::vector<Entry> m_index;
+    std::map<int,size_t> m_ids;
+
+    gsXmlLazyFile(const gsXmlLazyFile &);
+    gsXmlLazyFile & operator=(const gsXmlLazyFile &);
+};
+
 }// end namespace internal
 
 }// end namespace gismo
@@ -35,15 +35,34 @@ gsXmlNode * makeNode( const std::string & name,
                       const gsMatrix<T> & value, gsXmlTree & data,
                       bool transposed)
 {
-    return data.allocate_node(rapidxml::node_element ,
-                              data.allocate_string(name.c_str() ),
-                              makeValue(value,data,transposed) );
+    gsXmlNode * node = data.allocate_node(rapidxml::node_element ,
+                                          data.allocate_string(name.c_str() ),
+                                          makeValue(value,data,transposed) );
+    if ( writeBinary<T>(data) )
+        node->append_attribute( makeAttribute("format", "base64", data) );
+    return node;
 }
 
 template<class T>
 char * makeValue(const gsMatrix<T> & value, gsXmlTree & data,
                  bool transposed)
 {
+    if ( writeBinary<T>(data) )
+    {
+        // Read/Write is RowMajor
+        std::vector<double> tmp;
+        tmp.reserve(value.size());
+        if ( transposed )
+            for ( index_t j = 0; j< value.cols(); ++j)
+                for ( index_t i = 0; i< value.rows(); ++i)
+                    tmp.push_back( static_cast<double>(value(i,j)) );
+        else
+            for ( index_t i = 0; i< value.rows(); ++i)
+                for ( index_t j = 0; j< value.cols(); ++j)
+                    tmp.push_back( static_cast<double>(value(i,j)) );
+        return makeBinaryValue(tmp, data);
+    }
+
     std::ostringstream oss;
     // Set precision
     oss << std::setprecision(data.getFloatPrecision());
@@ -95,9 +114,43 @@ void getMatrixFromXml ( gsXmlNode * node, unsigned const & rows,
                         unsigned const & cols, gsMatrix<T> & result )
 {
     //gsWarn<<"Reading "<< node->name() <<" matrix of size "<<rows<<"x"<<cols<<"Geometry..\n";
+    result.resize(rows,cols);
+
+    if ( isBinaryNode(node) )
+    {
+        std::vector<double> tmp;
+        if ( !getBinaryValue(node->value(), tmp) || tmp.size() != (size_t)rows*cols )
+        {
+            gsWarn<<"XML Warning: Reading binary matrix of size "<<rows<<"x"<<cols<<" failed.\n";
+            gsWarn<<"Tag: "<< node->name() <<".\n";
+            return;
+        }
+        for (unsigned i=0; i<rows; ++i) // Read is RowMajor
+            for (unsigned j=0; j<cols; ++j)
+                result(i,j) = static_cast<T>(tmp[(size_t)i*cols+j]);
+        return;
+    }
+
+    if ( parseFast<T>() )
+    {
+        const char * str = node->value();
+        double val;
+        for (unsigned i=0; i<rows; ++i) // Read is RowMajor
+            for (unsigned j=0; j<cols; ++j)
+            {
+                if (! parseReal(str,val) )
+                {
+                    gsWarn<<"XML Warning: Reading matrix of size "<<rows<<"x"<<cols<<" failed.\n";
+                    gsWarn<<"Tag: "<< node->name() <<", Matrix entry: ("<<i<<", "<<j<<").\n";
+                    return;
+                }
+                result(i,j) = static_cast<T>(val);
+            }
+        return;
+    }
+
     std::istringstream str;
     str.str( node->value() );
-    result.resize(rows,cols);
 
     for (unsigned i=0; i<rows; ++i) // Read is RowMajor
         for (unsigned j=0; j<cols; ++j)
@@ -123,10 +176,29 @@ gsXmlNode * putSparseMatrixToXml ( gsSparseMatrix<T> const & mat,
                                    gsXmlTree & data, std::string name)
 {
     typedef typename gsSparseMatrix<T>::InnerIterator cIter;
+    const index_t nCol = mat.cols();
+
+    if ( writeBinary<T>(data) )
+    {
+        // Triplets (row, column, value), all stored as doubles
+        std::vector<double> tmp;
+        tmp.reserve(3 * mat.nonZeros());
+        for (index_t j=0; j != nCol; ++j) // for all columns
+            for ( cIter it(mat,j); it; ++it ) // for all non-zeros in column
+            {
+                tmp.push_back( static_cast<double>(it.index()) );
+                tmp.push_back( static_cast<double>(j) );
+                tmp.push_back( static_cast<double>(it.value()) );
+            }
+
+        gsXmlNode* new_node = internal::makeNode(name, data);
+        new_node->value( makeBinaryValue(tmp, data) );
+        new_node->append_attribute( makeAttribute("format", "base64", data) );
+        return new_node;
+    }
 
     std::ostringstream str;
     str << std::setprecision(data.getFloatPrecision());
-    const index_t nCol = mat.cols();
 
     for (index_t j=0; j != nCol; ++j) // for all columns
         for ( cIter it(mat,j); it; ++it ) // for all non-zeros in column
@@ -146,6 +218,40 @@ void getSparseEntriesFromXml ( gsXmlNode * node,
 {
     result.clear();
 
+    if ( isBinaryNode(node) )
+    {
+        std::vector<double> tmp;
+        if ( !getBinaryValue(node->value(), tmp) || 0 != tmp.size() % 3 )
+        {
+            gsWarn<<"XML Warning: Reading binary sparse matrix failed.\n";
+            return;
+        }
+        result.reserve(tmp.size() / 3);
+        for (size_t k = 0; k < tmp.size(); k += 3)
+            result.add( static_cast<index_t>(tmp[k]), static_cast<index_t>(tmp[k+1]),
+                        static_cast<T>(tmp[k+2]) );
+        return;
+    }
+
+    if ( parseFast<T>() )
+    {
+        const char * str = node->value();
+        char * end;
+        double val;
+        for (;;)
+        {
+            const index_t r = strtol(str, &end, 10);
+            if ( end == str ) break;
+            str = end;
+            const index_t c = strtol(str, &end, 10);
+            if ( end == str ) break;
+            str = end;
+            if ( !parseReal(str, val) ) break;
+            result.add(r, c, static_cast<T>(val));
+        }
+        return;
+    }
+
     std::istringstream str;
     str.str( node->value() );
     index_t r,c;
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <gsSolver/gsMatrixOp.h>
+#include <gsMpi/gsMpi.h>
 
 namespace gismo
 {
@@ -62,6 +63,18 @@ namespace gismo
  *
  *  The right-hand sides are stored in a vector accessible via \ref localRhs.
  *
+ *  If G+Smo is compiled with OpenMP, the local solvers are set up and applied
+ *  for the subdomains in parallel. Thus, they have to be distinct objects or
+ *  allow to be applied concurrently.
+ *
+ *  The subdomains might also be distributed among the processes of an MPI
+ *  communicator, see \ref setCommunicator. Then, every process only adds the
+ *  subdomains it owns. The primal subdomain is added on only one process (cf.
+ *  \a gsPrimalSystem::gatherContributions). The Lagrange multipliers are
+ *  stored on all processes and the contributions of the subdomains are summed
+ *  up over all processes; so, a Krylov solver for the Schur complement
+ *  formulation can be run on all processes simultaneously.
+ *
  *  @ingroup Solver
 **/
 
@@ -110,6 +123,14 @@ public:
     OpPtr&               localSolverOp(index_t k)        { return m_localSolverOps[k]; }
     const OpPtr&         localSolverOp(index_t k) const  { return m_localSolverOps[k]; }
 
+    /// @brief Sets the communicator if the subdomains are distributed among processes
+    ///
+    /// Every process has to own at least one subdomain.
+    void setCommunicator(const gsMpiComm& comm)          { m_comm = comm;              }
+
+    /// Returns the communicator
+    const gsMpiComm&     communicator() const            { return m_comm;              }
+
     /// @brief Returns the number of Lagrange multipliers
     ///
     /// This requires that at least one jump matrix has been set.
@@ -139,12 +160,17 @@ public:
     /// @param multipliers  The Lagrange multipliers previously computed
     ///                     (based on the Schur complement form)
     ///
+    /// If the subdomains are distributed among processes, only the solutions
+    /// for the subdomains owned by the process are returned.
+    ///
     /// If the local solvers have not been provided, this function will generate
     /// them from the \ref localMatrixOp if they are \a gsMatrixOp<gsSparseMatrix<T>>
     std::vector<Matrix> constructSolutionFromLagrangeMultipliers(const Matrix& multipliers) const;
 
     /// @brief Returns \a gsLinearOperator that represents the IETI problem as
     ///        saddle point problem
+    ///
+    /// This is not available if the subdomains are distributed among processes.
     OpPtr saddlePointProblem() const;
 
     /// @brief Returns the right-hand-side that is required for the saddle point
@@ -164,6 +190,7 @@ private:
     std::vector<OpPtr>          m_localMatrixOps;     ///< Stores the local matrix ops \f$ \tilde A_k \f$
     std::vector<Matrix>         m_localRhs;           ///< Stores the local right-hand sides
     mutable std::vector<OpPtr>  m_localSolverOps;     ///< Stores the local solvers
+    gsMpiComm                   m_comm;               ///< Communicator for distributed subdomains
 };
 
 } // namespace gismo
@@ -49,24 +49,47 @@ void gsIetiSystem<T>::addSubdomain(JumpMatrixPtr jumpMatrix, OpPtr localMatrixOp
 template<class T>
 void gsIetiSystem<T>::setupSparseLUSolvers() const
 {
-    const size_t sz = this->m_localSolverOps.size();
-    for (size_t i=0; i<sz; ++i)
+    const index_t sz = this->m_localSolverOps.size();
+    for (index_t i=0; i<sz; ++i)
+    {
+        GISMO_ENSURE( m_localSolverOps[i]
+            || dynamic_cast<SparseMatrixOp*>(this->m_localMatrixOps[i].get()),
+            "gsIetiSystem::setupSparseLUSolvers The local solvers can only "
+            "be computed on the fly if the local systems in localMatrixOps are of type "
+            "gsMatrixOp<gsSparseMatrix<T>>. Please provide solvers via members .addSubdomain "
+            "or .solverOp" );
+    }
+
+    // The factorizations are independent of each other
+    std::string error; // raised after the parallel loop
+#   pragma omp parallel for schedule(dynamic)
+    for (index_t i=0; i<sz; ++i)
     {
         if (!m_localSolverOps[i]) // If not yet provided...
         {
-            SparseMatrixOp* matop = dynamic_cast<SparseMatrixOp*>(this->m_localMatrixOps[i].get());
-            GISMO_ENSURE( matop, "gsIetiSystem::setupSparseLUSolvers The local solvers can only "
-              "be computed on the fly if the local systems in localMatrixOps are of type "
-              "gsMatrixOp<gsSparseMatrix<T>>. Please provide solvers via members .addSubdomain "
-              "or .solverOp" );
-            this->m_localSolverOps[i] = makeSparseLUSolver(SparseMatrix(matop->matrix()));
+            try
+            {
+                SparseMatrixOp* matop = static_cast<SparseMatrixOp*>(this->m_localMatrixOps[i].get());
+                this->m_localSolverOps[i] = makeSparseLUSolver(SparseMatrix(matop->matrix()));
+            }
+            catch (std::exception & e)
+            {
+#               pragma omp critical (gsIetiSystem_error)
+                if ( error.empty() )
+                    error = e.what();
+            }
         }
     }
+    if ( !error.empty() )
+        throw std::runtime_error(error);
 }
 
 template<class T>
 typename gsIetiSystem<T>::OpPtr gsIetiSystem<T>::saddlePointProblem() const
 {
+    GISMO_ENSURE( m_comm.size() <= 1, "gsIetiSystem::saddlePointProblem is not "
+        "available if the subdomains are distributed among processes." );
+
     const size_t sz = this->m_localMatrixOps.size();
     typename gsBlockOp<T>::Ptr result = gsBlockOp<T>::make( sz+1, sz+1 );
     for (size_t i=0; i<sz; ++i)
@@ -83,7 +106,10 @@ template<class T>
 typename gsIetiSystem<T>::OpPtr gsIetiSystem<T>::schurComplement() const
 {
     setupSparseLUSolvers();
-    return gsAdditiveOp<T>::make( this->m_jumpMatrices, this->m_localSolverOps );
+    typename gsAdditiveOp<T>::Ptr result = gsAdditiveOp<T>::make( this->m_jumpMatrices, this->m_localSolverOps );
+    result->setCommunicator(m_comm);
+    result->setParallel();
+    return result;
 }
 
 
@@ -94,12 +120,38 @@ gsMatrix<T> gsIetiSystem<T>::rhsForSchurComplement() const
     Matrix result;
     result.setZero( this->nLagrangeMultipliers(), this->m_localRhs[0].cols());
     const index_t numPatches = this->m_jumpMatrices.size();
-    for (index_t i=0; i<numPatches; ++i)
+
+    std::string error; // raised after the parallel region
+#   pragma omp parallel
     {
-        Matrix tmp;
-        this->m_localSolverOps[i]->apply( this->m_localRhs[i], tmp );
-        result += *(this->m_jumpMatrices[i]) * tmp;
+        Matrix tmp, result_local;
+        result_local.setZero( result.rows(), result.cols() );
+
+#       pragma omp for schedule(dynamic)
+        for (index_t i=0; i<numPatches; ++i)
+        {
+            try
+            {
+                this->m_localSolverOps[i]->apply( this->m_localRhs[i], tmp );
+                result_local += *(this->m_jumpMatrices[i]) * tmp;
+            }
+            catch (std::exception & e)
+            {
+#               pragma omp critical (gsIetiSystem_error)
+                if ( error.empty() )
+                    error = e.what();
+            }
+        }
+
+#       pragma omp critical (gsIetiSystem_rhsForSchurComplement)
+        result += result_local;
     }
+    if ( !error.empty() )
+        throw std::runtime_error(error);
+
+    // Sum up the contributions of the subdomains owned by the other processes
+    if (m_comm.size() > 1)
+        m_comm.sum(result.data(), static_cast<int>(result.size()));
     return result;
 }
 
@@ -111,16 +163,32 @@ std::vector< gsMatrix<T> > gsIetiSystem<T>::constructSolutionFromLagrangeMultipl
     const index_t numPatches = this->m_jumpMatrices.size();
     std::vector<Matrix> result;
     result.resize(numPatches);
+    std::string error; // raised after the parallel loop
+#   pragma omp parallel for schedule(dynamic)
     for (index_t i=0; i<numPatches; ++i)
     {
-        this->m_localSolverOps[i]->apply( this->m_localRhs[i]-this->m_jumpMatrices[i]->transpose()*multipliers, result[i] );
+        try
+        {
+            this->m_localSolverOps[i]->apply( this->m_localRhs[i]-this->m_jumpMatrices[i]->transpose()*multipliers, result[i] );
+        }
+        catch (std::exception & e)
+        {
+#           pragma omp critical (gsIetiSystem_error)
+            if ( error.empty() )
+                error = e.what();
+        }
     }
+    if ( !error.empty() )
+        throw std::runtime_error(error);
     return result;
 }
 
 template<class T>
 gsMatrix<T> gsIetiSystem<T>::rhsForSaddlePoint() const
 {
+    GISMO_ENSURE( m_comm.size() <= 1, "gsIetiSystem::rhsForSaddlePoint is not "
+        "available if the subdomains are distributed among processes." );
+
     const index_t sz = m_localMatrixOps.size();
     index_t rows = nLagrangeMultipliers();
     for (index_t k=0; k<sz; ++k)
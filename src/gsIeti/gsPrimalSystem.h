@@ -15,6 +15,7 @@
 
 #include <gsSolver/gsMatrixOp.h>
 #include <gsMatrix/gsVector.h>
+#include <gsMpi/gsMpi.h>
 
 namespace gismo
 {
@@ -79,6 +80,13 @@ namespace gismo
  *  After solving, the member \ref distributePrimalSolution distributes the
  *  solution obtained for the primal problem back to the individual patches.
  *
+ *  If the patches are distributed among the processes of an MPI communicator,
+ *  every process calls \ref handleConstraints only for the patches it owns.
+ *  Afterwards, \ref gatherContributions collects the primal problem on one
+ *  process, which then hands it over to its \a gsIetiSystem. The overload of
+ *  \ref distributePrimalSolution that takes the communicator broadcasts the
+ *  solution of the primal problem back to all processes.
+ *
  *  @ingroup Solver
 **/
 
@@ -265,6 +273,28 @@ public:
     /// @returns        The solution for the K patches
     std::vector<Matrix> distributePrimalSolution( std::vector<Matrix> sol );
 
+    /// @brief  Collects the contributions to the primal problem from all processes
+    ///
+    /// @param  comm    The communicator among whose processes the patches are distributed
+    /// @param  root    The process that obtains the primal problem
+    ///
+    /// Every process has only added the contributions of the patches it owns.
+    /// This function sums up the \ref jumpMatrix, the \ref localMatrix and the
+    /// \ref localRhs on the process \a root. On all other processes, they are set
+    /// to zero. So, the primal problem should be handed over to the \a gsIetiSystem
+    /// only on the process \a root.
+    void gatherContributions( const gsMpiComm& comm, int root = 0 );
+
+    /// @brief  Distributes the given solution for the subdomains to the patches
+    ///
+    /// @param    sol   The solution for the patches owned by this process. On
+    ///                 the process \a root, it is followed by the solution for
+    ///                 the primal problem (cf. \ref gatherContributions).
+    /// @param    comm  The communicator among whose processes the patches are distributed
+    /// @param    root  The process that holds the primal problem
+    /// @returns        The solution for the patches owned by this process
+    std::vector<Matrix> distributePrimalSolution( std::vector<Matrix> sol, const gsMpiComm& comm, int root = 0 );
+
     /// Returns the jump matrix for the primal problem
     JumpMatrix&                           jumpMatrix()        { return m_jumpMatrix;                    }
     const JumpMatrix&                     jumpMatrix() const  { return m_jumpMatrix;                    }
@@ -287,6 +317,10 @@ public:
     void setEliminatePointwiseConstraints(bool v)             { m_eliminatePointwiseConstraints = v;    }
 
 private:
+    /// Sums up the given sparse matrix over all processes on the process \a root
+    template <class SparseMatrixType>
+    static void gatherSparseMatrix( const gsMpiComm& comm, int root, SparseMatrixType& mat );
+
     JumpMatrix                  m_jumpMatrix;   ///< The jump matrix for the primal problem
     SparseMatrix                m_localMatrix;  ///< The overall matrix for the primal problem
     Matrix                      m_localRhs;     ///< The right-hand side for the primal problem
@@ -267,5 +267,92 @@ gsPrimalSystem<T>::distributePrimalSolution( std::vector<Matrix> sol )
     return sol;
 }
 
+template <class T>
+template <class SparseMatrixType>
+void gsPrimalSystem<T>::gatherSparseMatrix( const gsMpiComm& comm, int root, SparseMatrixType& mat )
+{
+    const int nProcs = comm.size();
+    const bool isRoot = comm.rank() == root;
+
+    // The local non-zero entries
+    const int nnz = static_cast<int>(mat.nonZeros());
+    gsMatrix<index_t> indices(2, nnz);
+    Matrix values(1, nnz);
+    index_t j = 0;
+    for (index_t i=0; i<mat.outerSize(); ++i)
+        for (typename SparseMatrixType::InnerIterator it(mat, i); it; ++it, ++j)
+        {
+            indices(0,j) = it.row();
+            indices(1,j) = it.col();
+            values(0,j)  = it.value();
+        }
+
+    // The number of non-zero entries of all processes
+    std::vector<int> counts(nProcs), displ(nProcs), counts2(nProcs), displ2(nProcs);
+    int sendCount = nnz;
+    comm.gather(&sendCount, counts.data(), 1, root);
+    int total = 0;
+    if (isRoot)
+        for (int p=0; p<nProcs; ++p)
+        {
+            displ[p]   = total;
+            counts2[p] = 2*counts[p];
+            displ2[p]  = 2*total;
+            total     += counts[p];
+        }
+
+    gsMatrix<index_t> allIndices(2, total);
+    Matrix allValues(1, total);
+    comm.gatherv(indices.data(), 2*nnz, allIndices.data(), counts2.data(), displ2.data(), root);
+    comm.gatherv(values.data(), nnz, allValues.data(), counts.data(), displ.data(), root);
+
+    // Entries that are contributed by several processes are summed up
+    SparseMatrixType result(mat.rows(), mat.cols());
+    if (isRoot)
+    {
+        gsSparseEntries<T> se;
+        se.reserve(total);
+        for (index_t k=0; k<total; ++k)
+            se.add(allIndices(0,k), allIndices(1,k), allValues(0,k));
+        result.setFrom(se);
+        result.makeCompressed();
+    }
+    mat.swap(result);
+}
+
+template <class T>
+void gsPrimalSystem<T>::gatherContributions( const gsMpiComm& comm, int root )
+{
+    if (comm.size() <= 1) return;
+
+    gatherSparseMatrix(comm, root, m_localMatrix);
+    gatherSparseMatrix(comm, root, m_jumpMatrix);
+
+    // The right-hand side is dense anyway
+    comm.sum(m_localRhs.data(), static_cast<int>(m_localRhs.size()));
+    if (comm.rank() != root)
+        m_localRhs.setZero();
+}
+
+template <class T>
+std::vector<typename gsPrimalSystem<T>::Matrix>
+gsPrimalSystem<T>::distributePrimalSolution( std::vector<Matrix> sol, const gsMpiComm& comm, int root )
+{
+    // The primal problem might have been moved to the gsIetiSystem, so we
+    // take its size from the primal bases
+    const index_t nPrimal = m_primalBases.empty() ? 0 : m_primalBases[0].cols();
+    if (comm.size() <= 1 || nPrimal == 0)
+        return distributePrimalSolution( give(sol) );
+
+    // Only the process root has solved the primal problem
+    int cols = comm.rank() == root ? static_cast<int>(sol.back().cols()) : 0;
+    comm.broadcast(&cols, 1, root);
+    if (comm.rank() != root)
+        sol.push_back( Matrix(nPrimal, cols) );
+    comm.broadcast(sol.back().data(), static_cast<int>(sol.back().size()), root);
+
+    return distributePrimalSolution( give(sol) );
+}
+
 
 } // namespace gismo
@@ -15,6 +15,7 @@
 
 #include <gsSolver/gsMatrixOp.h>
 #include <gsUtils/gsSortedVector.h>
+#include <gsMpi/gsMpi.h>
 
 namespace gismo
 {
@@ -71,6 +72,13 @@ namespace gismo
  *  \ref scalingMatrix. They can be provided by the caller or generated by
  *  calling \ref setupMultiplicityScaling.
  *
+ *  The preconditioner is realized as \a gsAdditiveOp, so the local Schur
+ *  complements are applied in parallel if G+Smo is compiled with OpenMP.
+ *  Thus, they have to be distinct objects or allow to be applied
+ *  concurrently.
+ *  Like for \a gsIetiSystem, the subdomains might be distributed among the
+ *  processes of an MPI communicator, see \ref setCommunicator.
+ *
  *  @ingroup Solver
 **/
 
@@ -209,6 +217,15 @@ public:
         return m_jumpMatrices[0]->rows();
     }
 
+    /// @brief Sets the communicator if the subdomains are distributed among processes
+    ///
+    /// Then, every process only adds the subdomains it owns; every process
+    /// has to own at least one subdomain.
+    void setCommunicator(const gsMpiComm& comm)          { m_comm = comm;             }
+
+    /// Returns the communicator
+    const gsMpiComm&     communicator() const            { return m_comm;             }
+
     /// @brief This sets up the member vector \a localScaling based on
     ///        multiplicity scaling
     ///
@@ -224,6 +241,7 @@ public:
     std::vector<JumpMatrixPtr>  m_jumpMatrices;     ///< The jump matrices \f$ \hat B_k \f$
     std::vector<OpPtr>          m_localSchurOps;    ///< The local Schur complements \f$ S_k \f$
     std::vector<Matrix>         m_localScaling;     ///< The diagonal entries of \f$ D_k \f$ as vectors
+    gsMpiComm                   m_comm;             ///< Communicator for distributed subdomains
 };
 
 } // namespace gismo
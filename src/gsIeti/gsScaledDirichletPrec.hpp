@@ -206,6 +206,8 @@ gsScaledDirichletPrec<T>::preconditioner() const
         local->addOperator(scalingOps[i]);
         result->addOperator(m_jumpMatrices[i],local);
     }
+    result->setCommunicator(m_comm);
+    result->setParallel();
 
     return result;
 }
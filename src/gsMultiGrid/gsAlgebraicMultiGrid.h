@@ -0,0 +1,182 @@
+/** @file gsAlgebraicMultiGrid.h
+
+    @brief Smoothed aggregation algebraic multigrid.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsForwardDeclarations.h>
+#include <gsMultiGrid/gsMultiGrid.h>
+#include <gsIO/gsOptionList.h>
+
+namespace gismo
+{
+
+/** @brief
+ *  Smoothed aggregation algebraic multigrid
+ *
+ *  This class constructs a multigrid hierarchy based only on an assembled
+ *  (symmetric positive definite) sparse matrix. So, it can be used where
+ *  no grid hierarchy (see \a gsGridHierarchy) is available, like for
+ *  THB-splines or for mapped bases.
+ *
+ *  On each level, the unknowns are grouped into aggregates based on the
+ *  strong connections \f$ |a_{ij}| \ge \theta \sqrt{|a_{ii}a_{jj}|} \f$.
+ *  The tentative prolongation interpolates the constants on each
+ *  aggregate; it is then smoothed with one step of a damped Jacobi
+ *  method. The coarse matrices are computed by the Galerkin principle.
+ *  The levels are added until the number of unknowns falls below
+ *  "CoarseSize" or until the coarsening stagnates.
+ *
+ *  For systems of PDEs, the unknowns can be split into blocks (e.g., the
+ *  components of a vector-valued function), as given by a
+ *  \a gsSparseSystem. If all blocks have the same size, the unknowns of
+ *  all blocks with the same index form a node and all of them are
+ *  aggregated in the same way; otherwise, every block is aggregated on
+ *  its own. In both cases, the coarse unknowns keep the block structure.
+ *
+ *  The resulting multigrid method is obtained with \ref makeMultiGridOp;
+ *  it can be used as a preconditioner for \a gsConjugateGradient:
+ *
+ *  \code
+ *      gsMultiGridOp<>::Ptr mg = gsAlgebraicMultiGrid<>::build(mat).makeMultiGridOp();
+ *      gsConjugateGradient<> solver(mat, mg);
+ *  \endcode
+ *
+ *  The setup of the prolongations and the multigrid cycle (matrix-vector
+ *  products and smoothers) are parallelized with OpenMP.
+ *
+ *  @ingroup Solver
+**/
+template< typename T >
+class gsAlgebraicMultiGrid
+{
+
+public:
+
+    /// Sparse matrix type
+    typedef gsSparseMatrix<T> SpMatrix;
+
+    /// Matrix type for the levels and the transfers
+    typedef gsSparseMatrix<T, RowMajor> SpMatrixRowMajor;
+
+    /// Smart pointer to sparse matrix type
+    typedef memory::shared_ptr<SpMatrix> SpMatrixPtr;
+
+    /// Smart pointer to matrix type for the levels and the transfers
+    typedef memory::shared_ptr<SpMatrixRowMajor> SpMatrixRowMajorPtr;
+
+    /// @brief Sets up the hierarchy for a matrix
+    ///
+    /// @param matrix                    The (symmetric positive definite) matrix
+    /// @param options                   A gsOptionList, see \ref defaultOptions
+    static gsAlgebraicMultiGrid build(
+        const SpMatrix& matrix,
+        const gsOptionList& options = defaultOptions()
+        )
+    {
+        std::vector<index_t> blockOffsets(2, 0);
+        blockOffsets[1] = matrix.rows();
+        return build(matrix, blockOffsets, options);
+    }
+
+    /// @brief Sets up the hierarchy for a matrix consisting of blocks
+    ///
+    /// @param matrix                    The (symmetric positive definite) matrix
+    /// @param blockOffsets              The unknowns of block \a b are \a blockOffsets[b],
+    ///                                  ..., \a blockOffsets[b+1]-1
+    /// @param options                   A gsOptionList, see \ref defaultOptions
+    static gsAlgebraicMultiGrid build(
+        const SpMatrix& matrix,
+        const std::vector<index_t>& blockOffsets,
+        const gsOptionList& options = defaultOptions()
+        );
+
+    /// @brief Sets up the hierarchy for the matrix of a gsSparseSystem
+    ///
+    /// The column blocks of the system are taken as blocks.
+    ///
+    /// @param system                    The assembled system
+    /// @param options                   A gsOptionList, see \ref defaultOptions
+    static gsAlgebraicMultiGrid build(
+        const gsSparseSystem<T>& system,
+        const gsOptionList& options = defaultOptions()
+        );
+
+    /// Returns a list of default options
+    static gsOptionList defaultOptions();
+
+    /// @brief Creates the multigrid solver based on the hierarchy
+    ///
+    /// The smoothers are chosen by the option "Smoother" (Chebyshev,
+    /// MultiColorGaussSeidel or Jacobi); the remaining options are passed to
+    /// the smoothers and to \a gsMultiGridOp. On the coarsest level, a
+    /// sparse LU solver is used.
+    typename gsMultiGridOp<T>::Ptr makeMultiGridOp( const gsOptionList& options = defaultOptions() ) const;
+
+    /// The number of levels
+    index_t numLevels() const                                             { return m_matrices.size();   }
+
+    /// The matrices for all levels (the coarsest level first)
+    const std::vector<SpMatrixRowMajorPtr>& matrices() const               { return m_matrices;          }
+
+    /// The prolongation matrices, the first one mapping from level 0 to level 1
+    const std::vector<SpMatrixRowMajorPtr>& transferMatrices() const       { return m_transferMatrices;  }
+
+    /// The block offsets for all levels (the coarsest level first)
+    const std::vector< std::vector<index_t> >& blockOffsets() const        { return m_blockOffsets;      }
+
+    /// The operator complexity, i.e., the number of non-zeros on all levels
+    /// relative to the number of non-zeros of the finest level
+    T operatorComplexity() const;
+
+private:
+
+    /// @brief Computes the aggregates
+    ///
+    /// @param[in]  matrix               The matrix
+    /// @param[in]  blockOffsets         The block offsets of the matrix
+    /// @param[in]  theta                The threshold for strong connections
+    /// @param[out] aggregate            The aggregate for each unknown
+    /// @param[out] coarseBlockOffsets   The block offsets for the coarse level
+    static void aggregate(
+        const SpMatrixRowMajor& matrix,
+        const std::vector<index_t>& blockOffsets,
+        T theta,
+        std::vector<index_t>& aggregate,
+        std::vector<index_t>& coarseBlockOffsets
+        );
+
+    /// @brief Computes the smoothed prolongation
+    ///
+    /// @param[in]  matrix               The matrix
+    /// @param[in]  aggregate            The aggregate for each unknown
+    /// @param[in]  nCoarse              The number of coarse unknowns
+    /// @param[in]  damping              The damping for the Jacobi smoothing, relative
+    ///                                  to the spectral radius of \f$ D^{-1}A \f$
+    static SpMatrixRowMajor smoothedProlongation(
+        const SpMatrixRowMajor& matrix,
+        const std::vector<index_t>& aggregate,
+        index_t nCoarse,
+        T damping
+        );
+
+private:
+
+    std::vector<SpMatrixRowMajorPtr> m_matrices;             ///< The matrices for all levels
+    std::vector<SpMatrixRowMajorPtr> m_transferMatrices;     ///< The prolongation matrices
+    std::vector< std::vector<index_t> > m_blockOffsets;      ///< The block offsets for all levels
+
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsAlgebraicMultiGrid.hpp)
+#endif
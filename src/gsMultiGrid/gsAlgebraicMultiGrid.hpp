@@ -0,0 +1,361 @@
+/** @file gsAlgebraicMultiGrid.hpp
+
+    @brief Smoothed aggregation algebraic multigrid.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsDofMapper.h>
+#include <gsAssembler/gsSparseSystem.h>
+#include <gsSolver/gsMatrixOp.h>
+#include <gsSolver/gsSimplePreconditioners.h>
+#include <gsSolver/gsChebyshevOp.h>
+
+namespace gismo
+{
+
+template <typename T>
+gsAlgebraicMultiGrid<T> gsAlgebraicMultiGrid<T>::build(
+    const SpMatrix& matrix,
+    const std::vector<index_t>& blockOffsets,
+    const gsOptionList& options
+    )
+{
+    GISMO_ASSERT( matrix.rows() == matrix.cols(), "gsAlgebraicMultiGrid needs quadratic matrices." );
+    GISMO_ASSERT( blockOffsets.size() >= 2 && blockOffsets.front() == 0 && blockOffsets.back() == matrix.rows(),
+        "gsAlgebraicMultiGrid: The block offsets do not fit to the matrix." );
+
+    const T       theta      = options.askReal( "StrengthThreshold",   (T)(0.08)   );
+    const T       damping    = options.askReal( "ProlongationDamping", (T)(4)/(T)(3) );
+    const index_t coarseSize = options.askInt ( "CoarseSize",          200         );
+    const index_t maxLevels  = options.askInt ( "MaxLevels",           10          );
+
+    // The levels are collected from the finest to the coarsest one
+    std::vector<SpMatrixRowMajorPtr> matrices(1, SpMatrixRowMajorPtr(new SpMatrixRowMajor(matrix)));
+    std::vector<SpMatrixRowMajorPtr> transfers;
+    std::vector< std::vector<index_t> > offsets(1, blockOffsets);
+
+    std::vector<index_t> aggregates, coarseOffsets;
+    while ( (index_t)matrices.size() < maxLevels && matrices.back()->rows() > coarseSize )
+    {
+        const SpMatrixRowMajor & mat = *matrices.back();
+        aggregate( mat, offsets.back(), theta, aggregates, coarseOffsets );
+
+        // Stop if the coarsening stagnates
+        const index_t nCoarse = coarseOffsets.back();
+        if ( nCoarse == 0 || nCoarse >= mat.rows() )
+            break;
+
+        SpMatrixRowMajorPtr prolongation(
+            new SpMatrixRowMajor( smoothedProlongation( mat, aggregates, nCoarse, damping ) ) );
+        const SpMatrixRowMajor ap = mat * *prolongation;
+        SpMatrixRowMajorPtr coarse( new SpMatrixRowMajor(
+            SpMatrixRowMajor( prolongation->transpose() ) * ap ) );
+
+        matrices.push_back(coarse);
+        transfers.push_back(prolongation);
+        offsets.push_back(coarseOffsets);
+    }
+
+    gsAlgebraicMultiGrid result;
+    result.m_matrices.assign( matrices.rbegin(), matrices.rend() );
+    result.m_transferMatrices.assign( transfers.rbegin(), transfers.rend() );
+    result.m_blockOffsets.assign( offsets.rbegin(), offsets.rend() );
+    return result;
+}
+
+template <typename T>
+gsAlgebraicMultiGrid<T> gsAlgebraicMultiGrid<T>::build(
+    const gsSparseSystem<T>& system,
+    const gsOptionList& options
+    )
+{
+    const index_t nBlocks = system.numColBlocks();
+    std::vector<index_t> blockOffsets(nBlocks+1, 0);
+    for (index_t c = 0; c < nBlocks; ++c)
+        blockOffsets[c+1] = blockOffsets[c] + system.colMapper(c).freeSize();
+    return build( system.matrix(), blockOffsets, options );
+}
+
+template <typename T>
+gsOptionList gsAlgebraicMultiGrid<T>::defaultOptions()
+{
+    gsOptionList opt = gsMultiGridOp<T>::defaultOptions();
+    opt.addReal  ("StrengthThreshold"           , "Threshold for strong connections |a_ij| >= theta sqrt(|a_ii a_jj|)", 0.08     );
+    opt.addReal  ("ProlongationDamping"         , "Damping of the Jacobi smoothing of the prolongation, "
+                                                  "relative to the spectral radius of D^{-1}A",              4./3.      );
+    opt.addInt   ("CoarseSize"                  , "Stop coarsening if at most this number of unknowns is left", 200     );
+    opt.addInt   ("MaxLevels"                   , "Maximum number of levels",                                 10        );
+    opt.addString("Smoother"                    , "Smoother (Chebyshev, MultiColorGaussSeidel or Jacobi)",    "Chebyshev");
+    opt.addInt   ("ChebyshevDegree"             , "Degree of the Chebyshev polynomial",                       2         );
+    opt.addReal  ("ChebyshevRatio"              , "Ratio of the largest and the smallest eigenvalue the "
+                                                  "Chebyshev smoother is adapted to",                         30        );
+    opt.addReal  ("Damping"                     , "Damping parameter of the Jacobi smoother",                 0.5       );
+    return opt;
+}
+
+template <typename T>
+typename gsMultiGridOp<T>::Ptr gsAlgebraicMultiGrid<T>::makeMultiGridOp( const gsOptionList& options ) const
+{
+    typedef typename gsLinearOperator<T>::Ptr OpPtr;
+
+    const index_t n = numLevels();
+    std::vector<OpPtr> ops(n), prolongation(n-1), restriction(n-1);
+    for (index_t l = 0; l < n; ++l)
+        ops[l] = makeMatrixOp( m_matrices[l] );
+    for (index_t l = 0; l < n-1; ++l)
+    {
+        prolongation[l] = makeMatrixOp( m_transferMatrices[l] );
+        // The restriction is stored explicitly such that it can be applied row-wise in parallel
+        restriction[l]  = makeMatrixOp( SpMatrixRowMajor( m_transferMatrices[l]->transpose() ).moveToPtr() );
+    }
+
+    typename gsMultiGridOp<T>::Ptr mg = gsMultiGridOp<T>::make(
+        ops, prolongation, restriction, makeSparseLUSolver( *m_matrices[0] ) );
+    mg->setOptions(options);
+
+    const std::string smoother = options.askString( "Smoother", "Chebyshev" );
+    for (index_t l = 1; l < n; ++l)
+    {
+        typename gsPreconditionerOp<T>::Ptr sm;
+        if ( smoother == "Chebyshev" )
+            sm = makeChebyshevOp( m_matrices[l], options.askInt( "ChebyshevDegree", 2 ),
+                                  options.askReal( "ChebyshevRatio", 30 ) );
+        else if ( smoother == "MultiColorGaussSeidel" )
+            // The matrices are symmetric, so the column-major copy holds the same rows
+            sm = makeSymmetricMultiColorGaussSeidelOp( SpMatrixPtr( SpMatrix( *m_matrices[l] ).moveToPtr() ) );
+        else if ( smoother == "Jacobi" )
+            sm = makeJacobiOp( m_matrices[l], options.askReal( "Damping", 0.5 ) );
+        else
+            GISMO_ERROR( "gsAlgebraicMultiGrid: Unknown smoother \"" << smoother << "\"." );
+        sm->setOptions(options);
+        mg->setSmoother(l, sm);
+    }
+    return mg;
+}
+
+template <typename T>
+T gsAlgebraicMultiGrid<T>::operatorComplexity() const
+{
+    T nnz = 0;
+    for (size_t l = 0; l < m_matrices.size(); ++l)
+        nnz += m_matrices[l]->nonZeros();
+    return nnz / m_matrices.back()->nonZeros();
+}
+
+template <typename T>
+void gsAlgebraicMultiGrid<T>::aggregate(
+    const SpMatrixRowMajor& matrix,
+    const std::vector<index_t>& blockOffsets,
+    T theta,
+    std::vector<index_t>& aggregate,
+    std::vector<index_t>& coarseBlockOffsets
+    )
+{
+    const index_t n       = matrix.rows();
+    const index_t nBlocks = blockOffsets.size() - 1;
+
+    std::vector<index_t> blockOf(n);
+    for (index_t b = 0; b < nBlocks; ++b)
+        std::fill( blockOf.begin() + blockOffsets[b], blockOf.begin() + blockOffsets[b+1], b );
+
+    bool equalBlocks = nBlocks > 1;
+    for (index_t b = 1; b < nBlocks && equalBlocks; ++b)
+        equalBlocks = ( blockOffsets[b+1] - blockOffsets[b] == blockOffsets[1] );
+
+    // If all blocks have the same size, the unknowns with the same index
+    // within their blocks form a node. The coupling of two nodes is the
+    // Frobenius norm of the corresponding submatrix. Otherwise, every
+    // unknown is a node and the couplings between the blocks are ignored.
+    SpMatrixRowMajor nodeMatrix;
+    if (equalBlocks)
+    {
+        const index_t nNodes = blockOffsets[1];
+        gsSparseEntries<T> entries;
+        entries.reserve( matrix.nonZeros() );
+        for (index_t i = 0; i < n; ++i)
+            for (typename SpMatrixRowMajor::InnerIterator it(matrix, i); it; ++it)
+                entries.add( i % nNodes, it.index() % nNodes, it.value() * it.value() );
+        nodeMatrix.resize(nNodes, nNodes);
+        nodeMatrix.setFromTriplets( entries.begin(), entries.end() );
+        nodeMatrix.coeffs() = nodeMatrix.coeffs().sqrt();
+        std::fill( blockOf.begin(), blockOf.end(), 0 );
+    }
+    const SpMatrixRowMajor & mat = equalBlocks ? nodeMatrix : matrix;
+    const index_t nNodes = mat.rows();
+
+    gsVector<T> diag(nNodes);
+    for (index_t i = 0; i < nNodes; ++i)
+        diag[i] = math::abs( mat.coeff(i,i) );
+
+    // The strong connections, stored in compressed row format
+    std::vector<index_t> strongPtr(nNodes+1, 0), strong;
+#   pragma omp parallel for
+    for (index_t i = 0; i < nNodes; ++i)
+    {
+        index_t count = 0;
+        for (typename SpMatrixRowMajor::InnerIterator it(mat, i); it; ++it)
+            if ( it.index() != i && blockOf[it.index()] == blockOf[i]
+                 && math::abs( it.value() ) >= theta * math::sqrt( diag[i] * diag[it.index()] ) )
+                ++count;
+        strongPtr[i+1] = count;
+    }
+    for (index_t i = 0; i < nNodes; ++i)
+        strongPtr[i+1] += strongPtr[i];
+    strong.resize( strongPtr[nNodes] );
+#   pragma omp parallel for
+    for (index_t i = 0; i < nNodes; ++i)
+    {
+        index_t k = strongPtr[i];
+        for (typename SpMatrixRowMajor::InnerIterator it(mat, i); it; ++it)
+            if ( it.index() != i && blockOf[it.index()] == blockOf[i]
+                 && math::abs( it.value() ) >= theta * math::sqrt( diag[i] * diag[it.index()] ) )
+                strong[k++] = it.index();
+    }
+
+    // Phase 1: Nodes whose strong neighbors are all free form an
+    // aggregate together with their neighbors
+    std::vector<index_t> agg(nNodes, -1);
+    index_t nAgg = 0;
+    for (index_t i = 0; i < nNodes; ++i)
+    {
+        if ( agg[i] != -1 || strongPtr[i] == strongPtr[i+1] )
+            continue;
+        bool free = true;
+        for (index_t k = strongPtr[i]; k < strongPtr[i+1] && free; ++k)
+            free = ( agg[strong[k]] == -1 );
+        if (!free)
+            continue;
+        agg[i] = nAgg;
+        for (index_t k = strongPtr[i]; k < strongPtr[i+1]; ++k)
+            agg[strong[k]] = nAgg;
+        ++nAgg;
+    }
+
+    // Phase 2: The remaining nodes join an aggregate of a strong neighbor
+    const std::vector<index_t> firstAgg = agg;
+    for (index_t i = 0; i < nNodes; ++i)
+    {
+        if ( agg[i] != -1 )
+            continue;
+        for (index_t k = strongPtr[i]; k < strongPtr[i+1]; ++k)
+            if ( firstAgg[strong[k]] != -1 )
+            {
+                agg[i] = firstAgg[strong[k]];
+                break;
+            }
+    }
+
+    // Phase 3: The nodes that are still left form new aggregates with
+    // their free strong neighbors
+    for (index_t i = 0; i < nNodes; ++i)
+    {
+        if ( agg[i] != -1 )
+            continue;
+        agg[i] = nAgg;
+        for (index_t k = strongPtr[i]; k < strongPtr[i+1]; ++k)
+            if ( agg[strong[k]] == -1 )
+                agg[strong[k]] = nAgg;
+        ++nAgg;
+    }
+
+    aggregate.resize(n);
+    coarseBlockOffsets.resize(nBlocks+1);
+    if (equalBlocks)
+    {
+        // The aggregates are the same for all blocks
+        for (index_t i = 0; i < n; ++i)
+            aggregate[i] = ( i / nNodes ) * nAgg + agg[i % nNodes];
+        for (index_t b = 0; b <= nBlocks; ++b)
+            coarseBlockOffsets[b] = b * nAgg;
+    }
+    else
+    {
+        // The aggregates do not cross the blocks; they are numbered such
+        // that the coarse unknowns keep the block structure
+        std::vector<index_t> aggBlock(nAgg);
+        for (index_t i = 0; i < n; ++i)
+            aggBlock[agg[i]] = blockOf[i];
+        std::fill( coarseBlockOffsets.begin(), coarseBlockOffsets.end(), 0 );
+        for (index_t a = 0; a < nAgg; ++a)
+            ++coarseBlockOffsets[aggBlock[a]+1];
+        for (index_t b = 0; b < nBlocks; ++b)
+            coarseBlockOffsets[b+1] += coarseBlockOffsets[b];
+        std::vector<index_t> next( coarseBlockOffsets.begin(), coarseBlockOffsets.end() - 1 );
+        std::vector<index_t> renumber(nAgg);
+        for (index_t a = 0; a < nAgg; ++a)
+            renumber[a] = next[aggBlock[a]]++;
+        for (index_t i = 0; i < n; ++i)
+            aggregate[i] = renumber[agg[i]];
+    }
+}
+
+template <typename T>
+typename gsAlgebraicMultiGrid<T>::SpMatrixRowMajor gsAlgebraicMultiGrid<T>::smoothedProlongation(
+    const SpMatrixRowMajor& matrix,
+    const std::vector<index_t>& aggregate,
+    index_t nCoarse,
+    T damping
+    )
+{
+    const index_t n = matrix.rows();
+
+    // Estimate the spectral radius of D^{-1}A with a few steps of the power
+    // method. The start vector is fixed, so that the hierarchy is reproducible
+    gsVector<T> diag = matrix.diagonal();
+    diag = ( diag.array() == (T)0 ).select( (T)1, diag );
+    gsMatrix<T> x(n,1), y;
+    for (index_t i = 0; i < n; ++i)
+        x(i,0) = math::sin( (T)(i+1) );
+    T rho = 0;
+    for (index_t k = 0; k < 10; ++k)
+    {
+        x /= x.norm();
+        y.noalias() = matrix * x;
+        x.array() = y.array() / diag.array();
+        rho = x.norm();
+    }
+    const T omega = damping / rho;
+
+    // Row i of the prolongation is e_{agg(i)} - omega/a_ii sum_j a_ij e_{agg(j)}
+    std::vector< std::vector< std::pair<index_t,T> > > rows(n);
+#   pragma omp parallel for
+    for (index_t i = 0; i < n; ++i)
+    {
+        std::vector< std::pair<index_t,T> > & row = rows[i];
+        const T d = matrix.coeff(i,i);
+        row.push_back( std::make_pair( aggregate[i], (T)1 ) );
+        if ( d != 0 )
+            for (typename SpMatrixRowMajor::InnerIterator it(matrix, i); it; ++it)
+                row.push_back( std::make_pair( aggregate[it.index()], - omega / d * it.value() ) );
+        std::sort( row.begin(), row.end() );
+        size_t last = 0;
+        for (size_t k = 1; k < row.size(); ++k)
+        {
+            if ( row[k].first == row[last].first )
+                row[last].second += row[k].second;
+            else
+                row[++last] = row[k];
+        }
+        row.resize(last+1);
+    }
+
+    gsVector<index_t> rowSizes(n);
+    for (index_t i = 0; i < n; ++i)
+        rowSizes[i] = rows[i].size();
+    SpMatrixRowMajor result(n, nCoarse);
+    result.reserve(rowSizes);
+    for (index_t i = 0; i < n; ++i)
+        for (size_t k = 0; k < rows[i].size(); ++k)
+            result.insert( i, rows[i][k].first ) = rows[i][k].second;
+    result.makeCompressed();
+    return result;
+}
+
+} // namespace gismo
@@ -67,38 +67,6 @@ namespace bspline
         }
     }
 
-    /// Evaluation for degree 1 B-spline basis
-    template <class T, typename KnotIterator, typename Derived>
-    void evalDeg1Basis(  const T & u,
-                         const KnotIterator knot,
-                         Eigen::MatrixBase<Derived> const & result )
-    {
-        result(0,0) =  u       - (*knot+1);
-        result(1,0) =  (*knot) - u        ;
-        const T dn  = (*knot)  - (*knot+1) ;
-        if( dn !=  0.0 )
-            result.array /= dn;
-    }
-    
-    /// Evaluation for degree 2 B-spline basis
-    template <class T, typename KnotIterator, typename Derived>
-    void evalDeg2Basis(  const T & u,
-                         const KnotIterator knot,
-                         Eigen::MatrixBase<Derived> const & result )
-    {
-        
-    }
-    
-    /// Evaluation for degree 3 B-spline basis
-    template <class T, typename KnotIterator, typename MatrixType>
-    void evalDeg3Basis(  const T & u,
-                         const KnotIterator knot,
-                         MatrixType & result )
-    {
-        
-    }
-    
-
     /// Input: parameter position \a u, KnotIterator \a knot identifying the active interval,
     /// degree \a deg, Output: table \a N.
     /// Computes deBoor table used in Algorithm A2.5 in NURBS book.
@@ -15,6 +15,7 @@
 
 #include <gsNurbs/gsBSpline.h>
 #include <gsNurbs/gsBSplineAlgorithms.h>
+#include <gsNurbs/gsBSplineKernels.h>
 
 #include <gsNurbs/gsDeboor.hpp>
 #include <gsNurbs/gsBoehm.h>
@@ -261,69 +262,11 @@ void gsTensorBSplineBasis<1,T>::eval_into(const gsMatrix<T> & u, gsMatrix<T>& re
 {
     result.resize(m_p+1, u.cols() );
 
-#if (FALSE)
-
-    typename KnotVectorType::const_iterator kspan;
-
-    // Low degree specializations
-    switch (m_p)
-    {
-    case 0: // constant B-splines
-        result.setOnes();
+    // Fixed-degree kernels
+    T * const out[1] = { result.data() };
+    if ( bspline::evalAllDersKernel(m_knots, m_p, u, 0, out) )
         return;
 
-    case 1:
-        for (index_t v = 0; v < u.cols(); ++v) // for all columns of u
-            if ( ! inDomain( u(0,v) ) )
-                result.col(v).setZero();
-            else
-            {
-                kspan = m_knots.findspanIter ( u(0,v) );
-                bspline::evalDeg1Basis( u(0,v), kspan, m_p, result.col(v) );
-            }
-        return;
-    case 2:
-        for (index_t v = 0; v < u.cols(); ++v) // for all columns of u
-            if ( ! inDomain( u(0,v) ) )
-                result.col(v).setZero();
-            else
-            {
-                kspan = m_knots.findspanIter ( u(0,v) );
-                bspline::evalDeg2Basis( u(0,v), kspan, m_p, result.col(v) );
-            }
-        return;
-    case 3:
-        for (index_t v = 0; v < u.cols(); ++v) // for all columns of u
-            if ( ! inDomain( u(0,v) ) )
-                result.col(v).setZero();
-            else
-            {
-                kspan = m_knots.findspanIter ( u(0,v) );
-                bspline::evalDeg3Basis( u(0,v), kspan, m_p, result.col(v) );
-            }
-        return;
-    };
-
-    STACK_ARRAY(T, left, m_p + 1);
-    STACK_ARRAY(T, right, m_p + 1);
-
-    for (index_t v = 0; v < u.cols(); ++v) // for all columns of u
-    {
-        // Check if the point is in the domain
-        if ( ! inDomain( u(0,v) ) )
-        {
-            // gsWarn<< "Point "<< u(0,v) <<" not in the BSpline domain.\n";
-            result.col(v).setZero();
-        }
-        else
-        {   // Locate the point in the knot-vector
-            kspan = m_knots.findspanIter ( u(0,v) );
-            // Run evaluation algorithm
-            bspline::evalBasis( u(0,v), kspan, m_p, left, right, result.col(v) );
-        }
-    }
-
-#endif
 //#if (FALSE)
     STACK_ARRAY(T, left, m_p + 1);
     STACK_ARRAY(T, right, m_p + 1);
@@ -604,6 +547,11 @@ void gsTensorBSplineBasis<1,T>::deriv_into(const gsMatrix<T> & u, gsMatrix<T>& r
 
     result.resize( m_p + 1, u.cols() ) ;
 
+    // Fixed-degree kernels
+    T * const out[2] = { NULL, result.data() };
+    if ( bspline::evalAllDersKernel(m_knots, m_p, u, 1, out) )
+        return;
+
     for (index_t v = 0; v < u.cols(); ++v) // for all columns of u
     {
         // Check if the point is in the domain
@@ -661,6 +609,12 @@ template <class T> inline
 void gsTensorBSplineBasis<1,T>::deriv2_into(const gsMatrix<T> & u,
                                             gsMatrix<T>& result ) const
 {
+    // Fixed-degree kernels
+    result.resize( m_p + 1, u.cols() ) ;
+    T * const out[3] = { NULL, NULL, result.data() };
+    if ( bspline::evalAllDersKernel(m_knots, m_p, u, 2, out) )
+        return;
+
     std::vector<gsMatrix<T> > ev;
     this->evalAllDers_into(u, 2, ev);
     result.swap(ev[2]);
@@ -907,6 +861,16 @@ evalAllDers_into(const gsMatrix<T> & u, int n,
     for(int k=0; k<=n; k++)
         result[k].resize(m_p + 1, u.cols());
 
+    // Fixed-degree kernels
+    if ( n <= bspline::kernelMaxDerivative )
+    {
+        T * out[bspline::kernelMaxDerivative+1];
+        for(int k=0; k<=n; k++)
+            out[k] = result[k].data();
+        if ( bspline::evalAllDersKernel(m_knots, m_p, u, n, out) )
+            return;
+    }
+
 #if FALSE
 
     const int pn = m_p - n;
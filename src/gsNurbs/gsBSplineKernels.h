@@ -0,0 +1,255 @@
+/** @file gsBSplineKernels.h
+
+    @brief Evaluation kernels for B-spline bases of fixed degree
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsNurbs/gsKnotVector.h>
+
+namespace gismo
+{
+
+namespace bspline
+{
+
+/// Number of points that are evaluated simultaneously by the kernels
+enum { kernelBatchSize = 8 };
+
+/// Largest degree and largest derivative order for which kernels exist
+enum { kernelMaxDegree = 8, kernelMaxDerivative = 3 };
+
+/**
+   @brief Evaluates the values and derivatives up to order \a N of the
+   B-spline basis functions of degree \a P, which are active at the points
+   \a u, for one batch of at most \a kernelBatchSize points.
+
+   This is Algorithm A2.3 of the NURBS book with compile-time degree and
+   derivative order. The innermost loops run over the points of the batch,
+   so they can be vectorized by the compiler.
+
+   \param u     the points
+   \param span  for each point, the index of the knot starting its knot span
+   \param npts  the number of points (at most \a kernelBatchSize)
+   \param knots the knot values
+   \param out   for each order k, the column-major (P+1) x npts output, or
+                zero if the order k is not wanted
+
+   \ingroup Nurbs
+*/
+template <short_t P, short_t N, class T>
+void evalAllDersBatch(const T * u, const index_t * span, const index_t npts,
+                      const T * knots, T * const out[])
+{
+    enum { B = kernelBatchSize, P1 = P + 1 };
+
+    // Pad the batch with the last point, so all loops have a fixed length
+    T uu[B];
+    index_t sp[B];
+    for (index_t b = 0; b < B; ++b)
+    {
+        const index_t c = (b < npts ? b : npts - 1);
+        uu[b] = u[c];
+        sp[b] = span[c];
+    }
+
+    // ndu[j][r] for r < j are the knot differences, ndu[r][j] for r <= j
+    // the basis functions of degree j
+    T ndu[P1][P1][B], left[P1][B], right[P1][B], saved[B];
+
+    for (index_t b = 0; b < B; ++b)
+        ndu[0][0][b] = 1;
+
+    for (short_t j = 1; j <= P; ++j)
+    {
+        for (index_t b = 0; b < B; ++b)
+        {
+            left [j][b] = uu[b] - knots[sp[b] + 1 - j];
+            right[j][b] = knots[sp[b] + j] - uu[b];
+            saved[b]    = 0;
+        }
+        for (short_t r = 0; r < j; ++r)
+            for (index_t b = 0; b < B; ++b)
+            {
+                ndu[j][r][b]   = right[r+1][b] + left[j-r][b];
+                const T temp   = ndu[r][j-1][b] / ndu[j][r][b];
+                ndu[r][j][b]   = saved[b] + right[r+1][b] * temp;
+                saved[b]       = left[j-r][b] * temp;
+            }
+        for (index_t b = 0; b < B; ++b)
+            ndu[j][j][b] = saved[b];
+    }
+
+    if (out[0])
+        for (index_t b = 0; b < npts; ++b)
+            for (short_t j = 0; j <= P; ++j)
+                out[0][b * P1 + j] = ndu[j][P][b];
+
+    if (N == 0)
+        return;
+
+    // factor[k] = P! / (P-k)!
+    T factor[N+1];
+    factor[0] = 1;
+    for (short_t k = 1; k <= N; ++k)
+        factor[k] = factor[k-1] * (P - k + 1);
+
+    T a[2][P1][B], d[B];
+    for (short_t r = 0; r <= P; ++r)
+    {
+        short_t s1 = 0, s2 = 1;
+        for (index_t b = 0; b < B; ++b)
+            a[0][0][b] = 1;
+
+        for (short_t k = 1; k <= N; ++k)
+        {
+            if (k > P) // derivatives of order larger than the degree vanish
+            {
+                if (out[k])
+                    for (index_t b = 0; b < npts; ++b)
+                        out[k][b * P1 + r] = 0;
+                continue;
+            }
+
+            const short_t rk = r - k, pk = P - k;
+            for (index_t b = 0; b < B; ++b)
+                d[b] = 0;
+
+            if (r >= k)
+                for (index_t b = 0; b < B; ++b)
+                {
+                    a[s2][0][b] = a[s1][0][b] / ndu[pk+1][rk][b];
+                    d[b] = a[s2][0][b] * ndu[rk][pk][b];
+                }
+
+            const short_t j1 = ( rk >= -1  ? 1   : -rk   );
+            const short_t j2 = ( r-1 <= pk ? k-1 : P - r );
+            for (short_t j = j1; j <= j2; ++j)
+                for (index_t b = 0; b < B; ++b)
+                {
+                    a[s2][j][b] = (a[s1][j][b] - a[s1][j-1][b]) / ndu[pk+1][rk+j][b];
+                    d[b] += a[s2][j][b] * ndu[rk+j][pk][b];
+                }
+
+            if (r <= pk)
+                for (index_t b = 0; b < B; ++b)
+                {
+                    a[s2][k][b] = -a[s1][k-1][b] / ndu[pk+1][r][b];
+                    d[b] += a[s2][k][b] * ndu[r][pk][b];
+                }
+
+            if (out[k])
+                for (index_t b = 0; b < npts; ++b)
+                    out[k][b * P1 + r] = factor[k] * d[b];
+
+            std::swap(s1, s2);
+        }
+    }
+}
+
+/// Applies the kernel of degree \a P and derivative order \a N to all points
+template <short_t P, short_t N, class T>
+void evalAllDersKernel(const gsMatrix<T> & u, const std::vector<index_t> & span,
+                       const T * knots, T * const out[])
+{
+    const index_t npts = u.cols();
+#   pragma omp parallel for if ( npts > 64 * kernelBatchSize )
+    for (index_t b0 = 0; b0 < npts; b0 += kernelBatchSize)
+    {
+        T * outB[N+1];
+        for (short_t k = 0; k <= N; ++k)
+            outB[k] = ( out[k] ? out[k] + b0 * (P+1) : NULL );
+        evalAllDersBatch<P,N,T>(u.data() + b0, &span[b0],
+                                math::min((index_t)kernelBatchSize, npts - b0),
+                                knots, outB);
+    }
+}
+
+/// Dispatches the derivative order at run time
+template <short_t P, class T>
+void evalAllDersKernel(const gsMatrix<T> & u, const std::vector<index_t> & span,
+                       const T * knots, int n, T * const out[])
+{
+    switch (n)
+    {
+    case 0: evalAllDersKernel<P,0,T>(u, span, knots, out); break;
+    case 1: evalAllDersKernel<P,1,T>(u, span, knots, out); break;
+    case 2: evalAllDersKernel<P,2,T>(u, span, knots, out); break;
+    case 3: evalAllDersKernel<P,3,T>(u, span, knots, out); break;
+    default: GISMO_ERROR("No B-spline kernel for derivative order "<< n);
+    }
+}
+
+/**
+   @brief Evaluates the values and derivatives up to order \a n of the
+   B-spline basis of degree \a deg with knot vector \a kv, which are
+   active at the points \a u, with the fixed-degree kernels.
+
+   The degree and the derivative order are dispatched at run time. The
+   output \a out[k] points to the column-major (deg+1) x u.cols() storage
+   for the derivatives of order k; it can be zero if that order is not
+   wanted. Points outside the domain get zero values.
+
+   Returns false (and does nothing) if there is no kernel for \a deg and
+   \a n, see \a kernelMaxDegree and \a kernelMaxDerivative.
+
+   \ingroup Nurbs
+*/
+template <class T>
+bool evalAllDersKernel(const gsKnotVector<T> & kv, short_t deg, const gsMatrix<T> & u,
+                       int n, T * const out[])
+{
+    if ( deg < 1 || deg > kernelMaxDegree || n < 0 || n > kernelMaxDerivative
+         || 0 == u.cols() )
+        return false;
+
+    GISMO_ASSERT( u.rows() == 1 , "The B-spline kernels accept points with one coordinate.");
+
+    // Locate the points; points outside the domain are evaluated in
+    // the first span and set to zero afterwards
+    const T a = *(kv.begin() + deg), b = *(kv.end() - deg - 1);
+    const index_t npts = u.cols();
+    std::vector<index_t> span(npts);
+    bool outside = false;
+    for (index_t v = 0; v < npts; ++v)
+    {
+        if ( u(0,v) < a || u(0,v) > b )
+        {
+            span[v] = deg;
+            outside = true;
+        }
+        else
+            span[v] = kv.iFind( u(0,v) ) - kv.begin();
+    }
+
+    const T * knots = &(*kv.begin());
+    switch (deg)
+    {
+    case 1: evalAllDersKernel<1,T>(u, span, knots, n, out); break;
+    case 2: evalAllDersKernel<2,T>(u, span, knots, n, out); break;
+    case 3: evalAllDersKernel<3,T>(u, span, knots, n, out); break;
+    case 4: evalAllDersKernel<4,T>(u, span, knots, n, out); break;
+    case 5: evalAllDersKernel<5,T>(u, span, knots, n, out); break;
+    case 6: evalAllDersKernel<6,T>(u, span, knots, n, out); break;
+    case 7: evalAllDersKernel<7,T>(u, span, knots, n, out); break;
+    case 8: evalAllDersKernel<8,T>(u, span, knots, n, out); break;
+    }
+
+    if (outside)
+        for (index_t v = 0; v < npts; ++v)
+            if ( u(0,v) < a || u(0,v) > b )
+                for (int k = 0; k <= n; ++k)
+                    if (out[k])
+                        std::fill(out[k] + v * (deg+1), out[k] + (v+1) * (deg+1), T(0));
+    return true;
+}
+
+} // namespace bspline
+
+} // namespace gismo
@@ -47,10 +47,19 @@ public:
 
         typename gsKnotVector<T>::knotContainer knotValues;
 
-        std::istringstream str;
-        str.str( node->value() );
-        for (T knot; gsGetReal(str, knot);)
-            knotValues.push_back(knot);
+        if ( parseFast<T>() )
+        {
+            const char * str = node->value();
+            for (double knot; parseReal(str, knot);)
+                knotValues.push_back( static_cast<T>(knot) );
+        }
+        else
+        {
+            std::istringstream str;
+            str.str( node->value() );
+            for (T knot; gsGetReal(str, knot);)
+                knotValues.push_back(knot);
+        }
 
         result = gsKnotVector<T>(give(knotValues), p);
     }
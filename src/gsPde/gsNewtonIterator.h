@@ -15,6 +15,8 @@
 #pragma once
 
 #include <gsAssembler/gsAssembler.h>
+#include <gsSolver/gsGMRes.h>
+#include <gsUtils/gsStopwatch.h>
 
 
 namespace gismo
@@ -22,6 +24,17 @@ namespace gismo
 
 /** 
     @brief Performs Newton iterations to solve a nonlinear system of PDEs.
+
+    By default, every iteration factorizes the Jacobian from scratch. As
+    the sparsity pattern usually does not change, \ref setReusePattern
+    allows to do the ordering and the symbolic analysis only once and the
+    numeric factorization afterwards. Moreover,
+    \ref setRefactorizationInterval allows to keep the factorization for
+    several iterations (modified Newton) and \ref setInexactNewton allows
+    to solve the linear systems with GMRES, preconditioned with the
+    (frozen) factorization (inexact Newton). The times for assembling and
+    for factorizing are recorded per iteration, see \ref assemblyTimes and
+    \ref factorizationTimes.
     
     \tparam T coefficient type
     
@@ -41,6 +54,12 @@ public:
       m_numIterations(0),
       m_maxIterations(100),
       m_tolerance(1e-12),
+      m_reusePattern(false),
+      m_refactorizationInterval(1),
+      m_inexact(false),
+      m_krylovTolerance(1e-2),
+      m_sinceFactorization(-1),
+      m_numFactorizations(0),
       m_converged(false)
     { 
 
@@ -51,6 +70,12 @@ public:
       m_numIterations(0),
       m_maxIterations(100),
       m_tolerance(1e-12),
+      m_reusePattern(false),
+      m_refactorizationInterval(1),
+      m_inexact(false),
+      m_krylovTolerance(1e-2),
+      m_sinceFactorization(-1),
+      m_numFactorizations(0),
       m_converged(false)
     { 
 
@@ -94,6 +119,41 @@ public:
     /// \brief Set the tolerance for convergence
     void setTolerance(T tol) {m_tolerance = tol;}
 
+    /// \brief If true, the ordering and the symbolic analysis of the
+    /// Jacobian are only done once; afterwards only the numeric
+    /// factorization is computed (default: false)
+    ///
+    /// The analysis is repeated if the sparsity pattern of the Jacobian
+    /// changes.
+    void setReusePattern(bool reuse) {m_reusePattern = reuse;}
+
+    /// \brief Set the number of iterations the factorization is kept
+    ///
+    /// For 1 (default), the Jacobian is factorized in every iteration
+    /// (Newton's method); for larger values, the factorization is only
+    /// renewed every \a nIter iterations (modified Newton method).
+    void setRefactorizationInterval(index_t nIter) {m_refactorizationInterval = nIter;}
+
+    /// \brief If true, the linear systems are solved with GMRES,
+    /// preconditioned with the latest factorization (default: false)
+    ///
+    /// If GMRES does not reach the relative tolerance \ref setKrylovTolerance,
+    /// the Jacobian is factorized and the system is solved directly.
+    void setInexactNewton(bool inexact) {m_inexact = inexact;}
+
+    /// \brief Set the relative tolerance for GMRES in the inexact Newton method
+    void setKrylovTolerance(T tol) {m_krylovTolerance = tol;}
+
+    /// \brief Returns the time for assembling the linear system in each iteration
+    const std::vector<T> & assemblyTimes() const {return m_assemblyTimes;}
+
+    /// \brief Returns the time for factorizing the Jacobian in each
+    /// iteration (zero if the factorization was kept)
+    const std::vector<T> & factorizationTimes() const {return m_factorizationTimes;}
+
+    /// \brief Returns the number of factorizations computed
+    index_t numFactorizations() const {return m_numFactorizations;}
+
 protected:
 
     virtual void solveLinearProblem(gsMatrix<T> &updateVector);
@@ -101,6 +161,29 @@ protected:
     virtual void solveLinearProblem(const gsMultiPatch<T> & currentSol, gsMatrix<T> &updateVector);
 
     virtual T getResidue() {return m_assembler.rhs().norm();}
+
+    /// \brief Computes the update for the assembled system according to
+    /// the chosen strategy and records the timings
+    void computeUpdate(gsMatrix<T> &updateVector, T assemblyTime);
+
+    /// \brief Factorizes the current Jacobian
+    void factorize();
+
+private:
+
+    /// The factorization stored in m_solver as gsLinearOperator
+    class FactorizationOp GISMO_FINAL : public gsLinearOperator<T>
+    {
+    public:
+        explicit FactorizationOp(const gsNewtonIterator& it) : m_it(it) {}
+        void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+        { x = m_it.m_solver.solve(input); }
+        index_t rows() const { return m_it.m_assembler.matrix().rows(); }
+        index_t cols() const { return m_it.m_assembler.matrix().cols(); }
+    private:
+        const gsNewtonIterator& m_it;
+    };
+
 protected:
 
     /// \brief gsAssemblerBase object to generate the linear system
@@ -130,6 +213,30 @@ protected:
     /// \brief Tolerance value to decide convergence
     T       m_tolerance;
 
+    /// \brief Do the symbolic analysis only once
+    bool    m_reusePattern;
+
+    /// \brief Number of iterations the factorization is kept
+    index_t m_refactorizationInterval;
+
+    /// \brief Solve the linear systems with preconditioned GMRES
+    bool    m_inexact;
+
+    /// \brief Relative tolerance for GMRES
+    T       m_krylovTolerance;
+
+    /// \brief Outer and inner indices of the analyzed Jacobian
+    std::vector<index_t> m_patternOuter, m_patternInner;
+
+    /// \brief Iterations since the last factorization (-1: none yet)
+    index_t m_sinceFactorization;
+
+    /// \brief Number of factorizations computed
+    index_t m_numFactorizations;
+
+    /// \brief Assembly and factorization times per iteration
+    std::vector<T> m_assemblyTimes, m_factorizationTimes;
+
 protected:
 
     /// \brief Convergence result
@@ -154,14 +261,15 @@ template <class T>
 void gsNewtonIterator<T>::solveLinearProblem(gsMatrix<T>& updateVector)
 {
     // Construct the linear system
+    gsStopwatch time;
     m_assembler.assemble();
+    const T assemblyTime = time.stop();
 
     // gsDebugVar( m_assembler.matrix().toDense() );
     // gsDebugVar( m_assembler.rhs().transpose() );
 
     // Compute the newton update
-    m_solver.compute( m_assembler.matrix() );
-    updateVector = m_solver.solve( m_assembler.rhs() );
+    computeUpdate(updateVector, assemblyTime);
     
     // gsDebugVar(updateVector);
 }
@@ -170,18 +278,92 @@ template <class T>
 void gsNewtonIterator<T>::solveLinearProblem(const gsMultiPatch<T> & currentSol, gsMatrix<T>& updateVector)
 {
     // Construct linear system for next iteration
+    gsStopwatch time;
     m_assembler.assemble(currentSol);
+    const T assemblyTime = time.stop();
 
     // gsDebugVar( m_assembler.matrix().toDense() );
     // gsDebugVar( m_assembler.rhs().transpose() );
     
     // Compute the newton update
-    m_solver.compute( m_assembler.matrix() );
-    updateVector = m_solver.solve( m_assembler.rhs() );
+    computeUpdate(updateVector, assemblyTime);
 
     // gsDebugVar(updateVector);
 }
 
+template <class T>
+void gsNewtonIterator<T>::factorize()
+{
+    const gsSparseMatrix<T> & mat = m_assembler.matrix();
+    if (!m_reusePattern)
+        m_solver.compute(mat);
+    else
+    {
+        // The pattern is analyzed again only if it changed
+        const index_t * outer = mat.outerIndexPtr();
+        const index_t * inner = mat.innerIndexPtr();
+        const size_t nOuter = mat.outerSize() + 1, nInner = mat.nonZeros();
+        if ( m_numFactorizations == 0 || !mat.isCompressed()
+             || m_patternOuter.size() != nOuter || m_patternInner.size() != nInner
+             || !std::equal(outer, outer + nOuter, m_patternOuter.begin())
+             || !std::equal(inner, inner + nInner, m_patternInner.begin()) )
+        {
+            m_solver.analyzePattern(mat);
+            if ( mat.isCompressed() )
+            {
+                m_patternOuter.assign(outer, outer + nOuter);
+                m_patternInner.assign(inner, inner + nInner);
+            }
+            else
+            {
+                m_patternOuter.clear();
+                m_patternInner.clear();
+            }
+        }
+        m_solver.factorize(mat);
+    }
+    m_sinceFactorization = 0;
+    ++m_numFactorizations;
+}
+
+template <class T>
+void gsNewtonIterator<T>::computeUpdate(gsMatrix<T> &updateVector, T assemblyTime)
+{
+    gsStopwatch time;
+    T factorizationTime = 0;
+
+    // In the modified Newton method, the factorization is kept for
+    // several iterations
+    if ( m_sinceFactorization < 0 || ++m_sinceFactorization >= m_refactorizationInterval )
+    {
+        factorize();
+        factorizationTime = time.stop();
+    }
+
+    if (m_inexact)
+    {
+        gsGMRes<T> solver( m_assembler.matrix(), memory::make_shared( new FactorizationOp(*this) ) );
+        solver.setTolerance(m_krylovTolerance);
+        updateVector.setZero(m_assembler.rhs().rows(), m_assembler.rhs().cols());
+        solver.solve( m_assembler.rhs(), updateVector );
+
+        // If the frozen factorization is no good preconditioner any more,
+        // we factorize the current Jacobian
+        if ( solver.error() > m_krylovTolerance && m_sinceFactorization > 0 )
+        {
+            time.restart();
+            factorize();
+            factorizationTime = time.stop();
+            updateVector = m_solver.solve( m_assembler.rhs() );
+        }
+    }
+    else
+        updateVector = m_solver.solve( m_assembler.rhs() );
+
+    m_assemblyTimes.push_back(assemblyTime);
+    m_factorizationTimes.push_back(factorizationTime);
+}
+
 
 template <class T> 
 void gsNewtonIterator<T>::solve()
@@ -215,6 +397,10 @@ void gsNewtonIterator<T>::firstIteration()
 {
     // ----- First iteration -----
     m_converged = false;
+    m_sinceFactorization = -1;
+    m_numFactorizations = 0;
+    m_assemblyTimes.clear();
+    m_factorizationTimes.clear();
 
     // Solve 
     solveLinearProblem(m_updateVector);
@@ -232,6 +418,8 @@ void gsNewtonIterator<T>::firstIteration()
 	gsDebug<<"Iteration: "<< 0
                <<", residue: "<< m_residue
                <<", update norm: "<< m_updnorm
+               <<", assembly time: "<< m_assemblyTimes.back()
+               <<", factorization time: "<< m_factorizationTimes.back()
                <<"\n";
 }
 
@@ -251,6 +439,8 @@ void gsNewtonIterator<T>::nextIteration()
     gsDebug<<"Iteration: "<< m_numIterations
            <<", residue: "<< m_residue
            <<", update norm: "<< m_updnorm
+           <<", assembly time: "<< m_assemblyTimes.back()
+           <<", factorization time: "<< m_factorizationTimes.back()
            <<"\n";
 }
 
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <gsSolver/gsLinearOperator.h>
+#include <gsMpi/gsMpi.h>
 
 namespace gismo
 {
@@ -44,6 +45,13 @@ namespace gismo
 ///
 /// but much faster.
 ///
+/// If G+Smo is compiled with OpenMP, the subspaces can be distributed
+/// among the threads, see \ref setParallel.
+///
+/// The subspaces might also be distributed among the processes of an MPI
+/// communicator (see \ref setCommunicator). Then, every process only holds
+/// the subspaces it owns and the results are summed up over all processes.
+///
 /// @ingroup Solvers
 
 template<class T>
@@ -65,7 +73,7 @@ public:
     typedef memory::unique_ptr<gsAdditiveOp> uPtr;
 
     /// Default Constructor
-    gsAdditiveOp() : m_transfers(), m_ops() {}
+    gsAdditiveOp() : m_transfers(), m_ops(), m_parallel(false) {}
 
     /// @brief Constructor
     ///
@@ -74,7 +82,7 @@ public:
     /// @param transfers  transfer matrices \f$ T_i \f$
     /// @param ops        local operators \f$ A_i \f$
     gsAdditiveOp(TransferContainer transfers, OpContainer ops)
-    : m_transfers(), m_ops(give(ops))
+    : m_transfers(), m_ops(give(ops)), m_parallel(false)
     {
         const size_t sz = transfers.size();
         m_transfers.reserve(sz);
@@ -99,7 +107,7 @@ public:
     /// @param transfers  transfer matrices \f$ T_i \f$
     /// @param ops        local operators \f$ A_i \f$
     gsAdditiveOp(TransferPtrContainer transfers, OpContainer ops)
-    : m_transfers(give(transfers)), m_ops(give(ops))
+    : m_transfers(give(transfers)), m_ops(give(ops)), m_parallel(false)
     {
 #ifndef NDEBUG
         GISMO_ASSERT( m_transfers.size() == m_ops.size(), "Sizes do not agree" );
@@ -167,6 +175,26 @@ public:
                        "Dimensions of the operators do not fit." );
     }
 
+    /// @brief Sets the communicator if the subspaces are distributed among processes
+    ///
+    /// Then, every process only holds the subspaces it owns. The input of
+    /// \ref apply has to be the same on all processes; the result is summed
+    /// up over all processes, so it is the same on all processes as well.
+    void setCommunicator(const gsMpiComm& comm)   { m_comm = comm; }
+
+    /// Returns the communicator
+    const gsMpiComm& communicator() const        { return m_comm; }
+
+    /// @brief Applies the operators of the subspaces concurrently if G+Smo
+    /// is compiled with OpenMP
+    ///
+    /// This is only allowed if the operators \f$ A_i \f$ are distinct objects
+    /// which can be applied concurrently, so it is off by default.
+    void setParallel(bool parallel = true)       { m_parallel = parallel; }
+
+    /// Returns true if the subspaces are handled concurrently
+    bool parallel() const                        { return m_parallel; }
+
     void apply(const gsMatrix<T>& input, gsMatrix<T>& x) const;
 
     index_t rows() const
@@ -184,6 +212,8 @@ public:
 protected:
     TransferPtrContainer m_transfers;   ///< Transfer matrices
     OpContainer m_ops;                  ///< Operators to be applied in the subspaces
+    gsMpiComm m_comm;                   ///< Communicator for distributed subspaces
+    bool m_parallel;                    ///< Apply the subspaces concurrently
 
 };
 
@@ -22,14 +22,41 @@ void gsAdditiveOp<T>::apply(const gsMatrix<T>& input, gsMatrix<T>& x) const
     x.setZero( input.rows(), input.cols() );
 
     const index_t n = m_ops.size();
-    gsMatrix<T> res_local, corr_local;
 
-    for (index_t i=0; i<n; ++i)
+    std::string error; // raised after the parallel region
+#   pragma omp parallel if ( m_parallel && n > 1 )
     {
-        res_local.noalias() = m_transfers[i]->transpose()*input;
-        m_ops[i]->apply(res_local, corr_local);
-        x.noalias() += *(m_transfers[i])*corr_local;
+        // Every thread accumulates the contributions of its subspaces;
+        // these are summed up afterwards
+        gsMatrix<T> res_local, corr_local, x_local;
+        x_local.setZero( input.rows(), input.cols() );
+
+#       pragma omp for schedule(dynamic)
+        for (index_t i=0; i<n; ++i)
+        {
+            try
+            {
+                res_local.noalias() = m_transfers[i]->transpose()*input;
+                m_ops[i]->apply(res_local, corr_local);
+                x_local.noalias() += *(m_transfers[i])*corr_local;
+            }
+            catch (std::exception & e)
+            {
+#               pragma omp critical (gsAdditiveOp_error)
+                if ( error.empty() )
+                    error = e.what();
+            }
+        }
+
+#       pragma omp critical (gsAdditiveOp_apply)
+        x += x_local;
     }
+    if ( !error.empty() )
+        throw std::runtime_error(error);
+
+    // Sum up the contributions of the subspaces owned by the other processes
+    if (m_comm.size() > 1)
+        m_comm.sum(x.data(), static_cast<int>(x.size()));
 }
 
 } // namespace gismo
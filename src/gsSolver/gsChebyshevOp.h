@@ -0,0 +1,233 @@
+/** @file gsChebyshevOp.h
+
+    @brief Chebyshev polynomial preconditioner and smoother.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsSolver/gsPreconditioner.h>
+#include <gsSolver/gsSimplePreconditioners.h>
+#include <gsSolver/gsConjugateGradient.h>
+
+namespace gismo
+{
+
+/// @brief Chebyshev preconditioner
+///
+/// One step applies the Chebyshev iteration of the given degree to the
+/// Jacobi preconditioned system \f$ D^{-1}A \f$, where the polynomial is
+/// adapted to the interval \f$ [\lambda_{\min},\lambda_{\max}] \f$.
+/// Only matrix-vector products and vector updates are needed.
+///
+/// The bounds are estimated on construction with a few steps of the
+/// Jacobi preconditioned conjugate gradient method (Lanczos estimates).
+/// As the estimate of \f$ \lambda_{\max} \f$ is from below, it is
+/// enlarged by ten percent. If the option "ChebyshevRatio" is positive,
+/// \f$ \lambda_{\min} \f$ is set to \f$ \lambda_{\max} \f$ divided by
+/// that ratio, so only the upper part of the spectrum is damped. This is
+/// the choice for a multigrid smoother. Otherwise, the estimated
+/// smallest eigenvalue is used, which is the choice for a stand-alone
+/// preconditioner.
+///
+/// The matrix is assumed to be symmetric positive definite.
+///
+/// \ingroup Solver
+template <typename MatrixType>
+class gsChebyshevOp GISMO_FINAL : public gsPreconditionerOp<typename MatrixType::Scalar>
+{
+    typedef memory::shared_ptr<MatrixType>          MatrixPtr;
+    typedef typename MatrixType::Nested             NestedMatrix;
+
+public:
+    /// Scalar type
+    typedef typename MatrixType::Scalar T;
+
+    /// Shared pointer for gsChebyshevOp
+    typedef memory::shared_ptr< gsChebyshevOp > Ptr;
+
+    /// Unique pointer for gsChebyshevOp
+    typedef memory::unique_ptr< gsChebyshevOp > uPtr;
+
+    /// Base class
+    typedef gsPreconditionerOp<T> Base;
+
+    /// Constructor with given matrix
+    explicit gsChebyshevOp(const MatrixType& _mat, index_t _degree = 2, T _ratio = 30)
+    : m_mat(), m_expr(_mat.derived()), m_degree(_degree), m_ratio(_ratio)
+    { init(); }
+
+    /// Constructor with shared pointer to matrix
+    explicit gsChebyshevOp(const MatrixPtr& _mat, index_t _degree = 2, T _ratio = 30)
+    : m_mat(_mat), m_expr(m_mat->derived()), m_degree(_degree), m_ratio(_ratio)
+    { init(); }
+
+    static uPtr make(const MatrixType& _mat, index_t _degree = 2, T _ratio = 30)
+    { return memory::make_unique( new gsChebyshevOp(_mat, _degree, _ratio) ); }
+
+    static uPtr make(const MatrixPtr& _mat, index_t _degree = 2, T _ratio = 30)
+    { return memory::make_unique( new gsChebyshevOp(_mat, _degree, _ratio) ); }
+
+    void step(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT( m_expr.rows() == rhs.rows() && m_expr.cols() == m_expr.rows(),
+                      "Dimensions do not match.");
+
+        gsMatrix<T> res = rhs - m_expr * x;
+        iterate(res, x);
+    }
+
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT( m_expr.rows() == input.rows() && m_expr.cols() == m_expr.rows(),
+                      "Dimensions do not match.");
+
+        x.setZero(input.rows(), input.cols());
+        gsMatrix<T> res = input;
+        iterate(res, x);
+
+        for (index_t k = 1; k < m_num_of_sweeps; ++k)
+            step(input, x);
+    }
+
+    index_t rows() const {return m_expr.rows();}
+    index_t cols() const {return m_expr.cols();}
+
+    /// @brief Estimates the extreme eigenvalues of \f$ D^{-1}A \f$ with
+    /// \a steps steps of the conjugate gradient method
+    void estimateEigenvalues(index_t steps = 10)
+    {
+        const index_t n = m_expr.rows();
+        gsMatrix<T> rhs, x, eigs;
+        // A fixed start vector with components along all eigenvectors,
+        // so that the estimate is reproducible
+        rhs.resize(n,1);
+        for (index_t i = 0; i < n; ++i)
+            rhs(i,0) = math::sin( (T)(i+1) );
+        x.setZero(n,1);
+        gsConjugateGradient<T> cg(m_expr, makeJacobiOp(m_expr));
+        cg.setCalcEigenvalues(true);
+        cg.setMaxIterations( math::min(steps, n) );
+        cg.setTolerance(0);
+        cg.solve(rhs, x);
+        cg.getEigenvalues(eigs);
+        GISMO_ENSURE( eigs.size() > 0, "gsChebyshevOp: The eigenvalue estimation failed." );
+        setEigenvalueBounds( eigs.minCoeff(), (T)(1.1) * eigs.maxCoeff() );
+    }
+
+    /// @brief Sets the interval \f$ [\lambda_{\min},\lambda_{\max}] \f$
+    /// bounding the spectrum of \f$ D^{-1}A \f$
+    ///
+    /// If the ratio is positive, \a lmin is ignored.
+    void setEigenvalueBounds(T lmin, T lmax)
+    {
+        m_lmin = lmin;
+        m_lmax = lmax;
+    }
+
+    /// Returns the lower end of the interval the polynomial is adapted to
+    T minEigenvalue() const { return m_ratio > 0 ? m_lmax / m_ratio : m_lmin; }
+
+    /// Returns the upper bound of the spectrum of \f$ D^{-1}A \f$
+    T maxEigenvalue() const { return m_lmax; }
+
+    /// Set the ratio of the largest and the smallest eigenvalue
+    void setRatio(const T ratio)         { m_ratio = ratio;   }
+
+    /// Set the degree of the Chebyshev polynomial
+    void setDegree(const index_t degree) { m_degree = degree; }
+
+    /// Get the degree of the Chebyshev polynomial
+    index_t degree() const               { return m_degree;   }
+
+    /// Get the default options as gsOptionList object
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt ( "ChebyshevDegree", "Degree of the Chebyshev polynomial", 2 );
+        opt.addReal( "ChebyshevRatio", "Ratio of the largest and the smallest eigenvalue the Chebyshev "
+                                       "polynomial is adapted to; if not positive, the estimated "
+                                       "smallest eigenvalue is used", 30 );
+        return opt;
+    }
+
+    /// Set options based on a gsOptionList object
+    virtual void setOptions(const gsOptionList & opt)
+    {
+        Base::setOptions(opt);
+        m_degree = opt.askInt( "ChebyshevDegree", m_degree );
+        m_ratio  = opt.askReal( "ChebyshevRatio", m_ratio );
+    }
+
+    /// Returns the matrix
+    NestedMatrix matrix() const { return m_expr; }
+
+    /// Returns a shared pinter to the matrix
+    MatrixPtr    matrixPtr() const {
+        GISMO_ENSURE( m_mat, "A shared pointer is only available if it was provided to gsChebyshevOp." );
+        return m_mat;
+    }
+
+    typename gsLinearOperator<T>::Ptr underlyingOp() const { return makeMatrixOp(m_mat); }
+
+private:
+
+    void init()
+    {
+        m_dinv = m_expr.diagonal();
+        m_dinv = m_dinv.cwiseInverse();
+        estimateEigenvalues();
+    }
+
+    // Chebyshev iteration (Saad, Iterative methods for sparse linear
+    // systems, Alg. 12.1) for the residual res of the initial guess x
+    void iterate(gsMatrix<T> & res, gsMatrix<T> & x) const
+    {
+        const T lmin  = minEigenvalue();
+        const T theta = (m_lmax + lmin) / 2;
+        const T delta = (m_lmax - lmin) / 2;
+        const T sigma = theta / delta;
+        T rho = 1 / sigma;
+
+        gsMatrix<T> d = m_dinv.asDiagonal() * res / theta;
+        for (index_t k = 1; ; ++k)
+        {
+            x += d;
+            if ( k >= m_degree ) break;
+            res.noalias() -= m_expr * d;
+            const T rho_new = 1 / (2 * sigma - rho);
+            d *= rho_new * rho;
+            d.noalias() += (2 * rho_new / delta) * (m_dinv.asDiagonal() * res);
+            rho = rho_new;
+        }
+    }
+
+private:
+    const MatrixPtr m_mat;  ///< Shared pointer to matrix (if needed)
+    NestedMatrix    m_expr; ///< Nested Eigen expression
+    using Base::m_num_of_sweeps;
+    gsMatrix<T> m_dinv;     ///< Inverse of the diagonal
+    index_t m_degree;
+    T m_ratio, m_lmin, m_lmax;
+};
+
+/// @brief Returns a smart pointer to a Chebyshev operator referring on \a mat
+/// \relates gsChebyshevOp
+template <class Derived>
+typename gsChebyshevOp<Derived>::uPtr makeChebyshevOp(const Eigen::EigenBase<Derived>& mat, index_t degree = 2,
+                                                      typename Derived::Scalar ratio = 30)
+{ return gsChebyshevOp<Derived>::make(mat.derived(), degree, ratio); }
+
+/// @brief Returns a smart pointer to a Chebyshev operator referring on \a mat
+/// \relates gsChebyshevOp
+template <class Derived>
+typename gsChebyshevOp<Derived>::uPtr makeChebyshevOp(const memory::shared_ptr<Derived>& mat, index_t degree = 2,
+                                                      typename Derived::Scalar ratio = 30)
+{ return gsChebyshevOp<Derived>::make(mat, degree, ratio); }
+
+} // namespace gismo
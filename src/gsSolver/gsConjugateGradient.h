@@ -24,6 +24,10 @@ namespace gismo
 /// general preconditioners and better iteration control. Also capable of using
 /// a gsLinearOperator as matrix.
 ///
+/// For several right-hand sides, the columns are iterated
+/// simultaneously, each with its own step sizes. The eigenvalue
+/// estimates refer to the first column.
+///
 /// \ingroup Solver
 template<class T = real_t>
 class gsConjugateGradient : public gsIterativeSolver<T>
@@ -105,7 +109,7 @@ private:
     VectorType m_res;
     VectorType m_update;
     VectorType m_tmp;
-    T m_abs_new;
+    gsMatrix<T> m_abs_new;
 
     bool m_calcEigenvals;
 
@@ -34,19 +34,19 @@ bool gsConjugateGradient<T>::initIteration( const typename gsConjugateGradient<T
         return true;
 
     int n = m_mat->cols();
-    int m = 1;                                                          // == rhs.cols();
+    int m = rhs.cols();
     m_tmp.resize(n,m);
     m_update.resize(n,m);
 
     m_mat->apply(x,m_tmp);                                              // apply the system matrix
     m_res = rhs - m_tmp;                                                // initial residual
 
-    m_error = m_res.norm() / m_rhs_norm;
+    m_error = Base::columnErrors(m_res).maxCoeff();
     if (m_error < m_tol)
         return true;
 
     m_precond->apply(m_res,m_update);                                   // initial search direction
-    m_abs_new = m_res.col(0).dot(m_update.col(0));                      // the square of the absolute value of r scaled by invM
+    m_abs_new = m_res.cwiseProduct(m_update).colwise().sum();           // the square of the absolute value of r scaled by invM
 
     return false;
 }
@@ -56,29 +56,37 @@ bool gsConjugateGradient<T>::step( typename gsConjugateGradient<T>::VectorType&
 {
     m_mat->apply(m_update,m_tmp);                                      // apply system matrix
 
-    T alpha = m_abs_new / m_update.col(0).dot(m_tmp.col(0));           // the amount we travel on dir
+    // The coefficients of each column; a column with vanishing
+    // search direction has converged and is not updated anymore
+    gsMatrix<T> alpha = m_update.cwiseProduct(m_tmp).colwise().sum();
+    for (index_t j = 0; j != alpha.cols(); ++j)
+        alpha(0,j) = ( 0 == alpha(0,j) ? 0 : m_abs_new(0,j) / alpha(0,j) );  // the amount we travel on dir
     if (m_calcEigenvals)
-        m_delta.back()+=(1./alpha);
+        m_delta.back()+=(1./alpha(0,0));
 
-    x += alpha * m_update;                                             // update solution
-    m_res -= alpha * m_tmp;                                            // update residual
+    x += m_update * alpha.asDiagonal();                                // update solution
+    m_res -= m_tmp * alpha.asDiagonal();                               // update residual
 
-    m_error = m_res.norm() / m_rhs_norm;
+    m_error = Base::columnErrors(m_res).maxCoeff();
     if (m_error < m_tol)
         return true;
 
     m_precond->apply(m_res, m_tmp);                                    // approximately solve for "A tmp = residual"
 
-    T abs_old = m_abs_new;
+    const gsMatrix<T> abs_old = m_abs_new;
 
-    m_abs_new = m_res.col(0).dot(m_tmp.col(0));                        // update the absolute value of r
-    T beta = m_abs_new / abs_old;                                      // calculate the Gram-Schmidt value used to create the new search direction
-    m_update = m_tmp + beta * m_update;                                // update search direction
+    m_abs_new = m_res.cwiseProduct(m_tmp).colwise().sum();             // update the absolute value of r
+    gsMatrix<T> beta(1, m_abs_new.cols());                             // calculate the Gram-Schmidt value used to create the new search direction
+    for (index_t j = 0; j != beta.cols(); ++j)
+        beta(0,j) = ( 0 == abs_old(0,j) ? 0 : m_abs_new(0,j) / abs_old(0,j) );
+    m_update = m_tmp + m_update * beta.asDiagonal();                   // update search direction
 
-    if (m_calcEigenvals)
+    // The diagonal entry of the next row is completed in the next step,
+    // so the row is not started in the last one
+    if (m_calcEigenvals && m_num_iter < m_max_iters)
     {
-        m_gamma.push_back(-math::sqrt(beta)/alpha);
-        m_delta.push_back(beta/alpha);
+        m_gamma.push_back(-math::sqrt(beta(0,0))/alpha(0,0));
+        m_delta.push_back(beta(0,0)/alpha(0,0));
     }
     return false;
 }
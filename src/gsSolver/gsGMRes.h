@@ -19,6 +19,10 @@ namespace gismo
 
 /// @brief The generalized minimal residual (GMRES) method.
 ///
+/// For several right-hand sides, the columns are iterated
+/// simultaneously, each one in its own Krylov space; a column stops
+/// growing its space once it has converged.
+///
 /// \ingroup Solver
 template<class T = real_t>
 class gsGMRes : public gsIterativeSolver<T>
@@ -77,13 +81,17 @@ private:
     using Base::m_num_iter;
     using Base::m_rhs_norm;
     using Base::m_error;
+    using Base::m_rhs_norms;
 
 
-    gsMatrix<T> tmp, g, g_tmp, h_tmp, y, w;
+    gsMatrix<T> tmp, y, w;
     gsMatrix<T> residual;
-    gsMatrix<T> H_prev, H, Omega, Omega_prev, Omega_tmp, Omega_prev_tmp;
-    std::vector< gsMatrix<T> > v;
-    T beta;
+    gsMatrix<T> g;                  // Rotated right-hand sides of the least squares problems, one column per rhs
+    gsMatrix<T> cs, sn;             // Givens rotations, one column per rhs
+    gsMatrix<T> m_errors;           // Errors of the columns
+    std::vector< gsMatrix<T> > H;   // Triangular factors of the Hessenberg matrices, one per rhs
+    std::vector< gsMatrix<T> > v;   // Krylov vectors, one column per rhs
+    std::vector<index_t> m_dim;     // Dimension of the Krylov space of converged columns, or -1
 };
 
 } // namespace gismo
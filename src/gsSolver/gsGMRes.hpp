@@ -11,8 +11,6 @@
     Author(s): J. Sogn
 */
 
-// TODO: Fix matrices sizes such that we don't resize on every iteration! (default can be 100 + 100 +...)
-
 namespace gismo
 {
 
@@ -23,20 +21,26 @@ bool gsGMRes<T>::initIteration( const typename gsGMRes<T>::VectorType& rhs,
     if (Base::initIteration(rhs,x))
         return true;
 
+    const index_t m = rhs.cols();
     m_mat->apply(x,tmp);
     tmp = rhs - tmp;
     m_precond->apply(tmp, residual);
-    beta = residual.norm(); // This is  ||r||
+    const gsMatrix<T> beta = residual.colwise().norm(); // This is  ||r||
 
-    m_error = beta/m_rhs_norm;
+    m_errors = beta.cwiseQuotient(m_rhs_norms);
+    m_error = m_errors.maxCoeff();
     if(m_error < m_tol)
         return true;
 
-    v.push_back(residual/beta);
-    g.setZero(2,1);
-    g(0,0) = beta;
-    Omega = gsMatrix<T>::Identity(2, 2);
-    Omega_prev = gsMatrix<T>::Identity(2, 2);
+    v.clear();
+    v.push_back( residual * ( beta.array() == 0 ).select( (T)0, beta.array().inverse() ).matrix().asDiagonal() );
+    g = beta;
+    cs.resize(0,m);
+    sn.resize(0,m);
+    H.assign(m, gsMatrix<T>());
+    m_dim.assign(m, -1);
+    for (index_t j = 0; j != m; ++j)
+        if (m_errors(0,j) < m_tol) m_dim[j] = 0; // nothing to do for this column
 
     return false;
 }
@@ -44,39 +48,31 @@ bool gsGMRes<T>::initIteration( const typename gsGMRes<T>::VectorType& rhs,
 template<class T>
 void gsGMRes<T>::finalizeIteration( typename gsGMRes<T>::VectorType& x )
 {
-    //Remove last row of H and g
-    H.resize(m_num_iter,m_num_iter);
-    H = H_prev.block(0,0,m_num_iter,m_num_iter);
-    g_tmp.resize(m_num_iter,1);
-    g_tmp = g.block(0,0,m_num_iter,1);
-
-    //Solve H*y = g;
-    solveUpperTriangular(H, g_tmp);
-
-    //Create the matrix from the column matrix in v.
-    gsMatrix<T> V(m_mat->rows(),m_num_iter);
-    for (index_t k = 0; k< m_num_iter; ++k)
+    for (size_t j = 0; j != m_dim.size(); ++j)
     {
-        V.col(k) = v[k];
+        const index_t k = ( -1 == m_dim[j] ? m_num_iter : m_dim[j] );
+        if (0 == k) continue;
+
+        //Solve H*y = g;
+        solveUpperTriangular(H[j].topLeftCorner(k,k), g.col(j).head(k));
+
+        //Update solution
+        for (index_t i = 0; i < k; ++i)
+            x.col(j) += y(i,0) * v[i].col(j);
     }
-    //Update solution
-    x += V*y;
 
     // cleanup temporaries
     tmp.clear();
     g.clear();
-    g_tmp.clear();
-    h_tmp.clear();
     y.clear();
     w.clear();
     residual.clear();
-    H_prev.clear();
+    cs.clear();
+    sn.clear();
+    m_errors.clear();
     H.clear();
-    Omega.clear();
-    Omega_prev.clear();
-    Omega_tmp.clear();
-    Omega_prev_tmp.clear();
     v.clear();
+    m_dim.clear();
 }
 
 template<class T>
@@ -84,65 +80,73 @@ bool gsGMRes<T>::step( typename gsGMRes<T>::VectorType& )
 {
     // The iterate x is never updated! Use finalizeIteration to obtain x.
     const index_t k = m_num_iter-1;
-    H.setZero(k+2,k+1);
-    h_tmp.setZero(k+2,1);
-
-    if (k != 0)
-    {
-        H.block(0,0,k+1,k) = H_prev;
-    }
+    const index_t m = v[k].cols();
 
-    Omega = gsMatrix<T>::Identity(k+2, k+2);
     m_mat->apply(v[k],tmp);
     m_precond->apply(tmp, w);
 
-    for (index_t i = 0; i< k+1; ++i)
+    g.conservativeResize(k+2, Eigen::NoChange);
+    g.row(k+1).setZero();
+    cs.conservativeResize(k+1, Eigen::NoChange);
+    sn.conservativeResize(k+1, Eigen::NoChange);
+    cs.row(k).setOnes();
+    sn.row(k).setZero();
+
+    // Each column has its own Krylov space
+    gsMatrix<T> h(k+2,1);
+    for (index_t j = 0; j != m; ++j)
     {
-        h_tmp(i,0) = (w.transpose()*v[i]).value(); //Typo h_l,k
-        w = w - h_tmp(i,0)*v[i];
+        if (-1 != m_dim[j]) // converged
+        {
+            w.col(j).setZero();
+            continue;
+        }
+
+        // Arnoldi process, modified Gram-Schmidt
+        for (index_t i = 0; i< k+1; ++i)
+        {
+            h(i,0) = w.col(j).dot(v[i].col(j));
+            w.col(j) -= h(i,0) * v[i].col(j);
+        }
+        h(k+1,0) = w.col(j).norm();
+        if (0 != h(k+1,0))
+            w.col(j) /= h(k+1,0);
+
+        // Apply the previous rotations to h
+        for (index_t i = 0; i< k; ++i)
+        {
+            const T hi = cs(i,j)*h(i,0) + sn(i,j)*h(i+1,0);
+            h(i+1,0)   =-sn(i,j)*h(i,0) + cs(i,j)*h(i+1,0);
+            h(i,0)     = hi;
+        }
+
+        //Find coef in rotation matrix
+        const T r = math::sqrt(h(k,0)*h(k,0) + h(k+1,0)*h(k+1,0));
+        if (0 != r)
+        {
+            cs(k,j) = h(k,0)/r;
+            sn(k,j) = h(k+1,0)/r;
+        }
+        h(k,0) = r;
+
+        //Rotate g
+        g(k+1,j) =-sn(k,j)*g(k,j);
+        g(k,j)   = cs(k,j)*g(k,j);
+
+        H[j].conservativeResize(k+1,k+1);
+        H[j].row(k).setZero();
+        H[j].col(k) = h.topRows(k+1);
+
+        m_errors(0,j) = math::abs(g(k+1,j)) / m_rhs_norms(0,j);
+        if (m_errors(0,j) < m_tol || 0 == h(k+1,0) || 0 == r) // converged or breakdown
+            m_dim[j] = k+1;
     }
-    h_tmp(k+1,0) = w.norm();
-
-  //  if (math::abs(h_tmp(k+1,0)) < 1e-16) //If exact solution
-  //      return true;
-
-    v.push_back(w/h_tmp(k+1,0));
-
-    h_tmp = Omega_prev*h_tmp;
-    H.block(0,k,k+2,1) = h_tmp;
-
-    //Find coef in rotation matrix
-    T sk = H(k+1,k)/(math::sqrt(H(k,k)*H(k,k) + H(k+1,k)*H(k+1,k)));
-    T ck = H(k,  k)/(math::sqrt(H(k,k)*H(k,k) + H(k+1,k)*H(k+1,k)));
-    Omega(k,k)   = ck; Omega(k,k+1)   = sk;
-    Omega(k+1,k) =-sk; Omega(k+1,k+1) = ck;
-
-    //Rotate H and g
-    H = Omega*H;
-    H_prev = H;
-    g_tmp.setZero(k+2,1);
-    if (k != 0)
-        g_tmp.block(0,0,k+1,1) = g;
-    else
-        g_tmp = g;
-    g.noalias() = Omega * g_tmp;
-
-    T residualNorm2 = g(k+1,0)*g(k+1,0);
-    m_error = math::sqrt(residualNorm2) / m_rhs_norm;
-    if(m_error < m_tol)
-        return true;
-
-    //Resize rotation product
-    Omega_prev_tmp.setZero(k+3,k+3);
-    Omega_prev_tmp.block(0,0,k+2,k+2) = Omega_prev;
-    Omega_prev_tmp(k+2,k+2) = 1;
 
-    Omega_tmp.setZero(k+3,k+3);
-    Omega_tmp.block(0,0,k+2,k+2) = Omega;
-    Omega_tmp(k+2,k+2) = 1;
+    v.push_back(w);
 
-    Omega_prev = Omega_tmp*Omega_prev_tmp;
-    return false;
+    m_error = m_errors.maxCoeff();
+    return m_error < m_tol
+        || std::find(m_dim.begin(), m_dim.end(), -1) == m_dim.end(); // all columns are done
 }
 
 }
@@ -24,7 +24,7 @@ bool gsGradientMethod<T>::initIteration( const typename gsGradientMethod<T>::Vec
     m_mat->apply(x,m_tmp);
     m_res = rhs - m_tmp;
 
-    m_error = m_res.norm() / m_rhs_norm;
+    m_error = Base::columnErrors(m_res).maxCoeff();
     return m_error < m_tol;
 
 }
@@ -35,15 +35,21 @@ bool gsGradientMethod<T>::step( typename gsGradientMethod<T>::VectorType& x )
     m_precond->apply(m_res,m_update);
     m_mat->apply(m_update,m_tmp);
 
-    T step_size;
+    gsMatrix<T> step_size;
     if (m_adapt_step_size)
-        step_size = m_tmp.col(0).dot(m_res.col(0)) / m_tmp.col(0).dot(m_tmp.col(0));
+    {
+        // For each column
+        step_size = m_tmp.cwiseProduct(m_res).colwise().sum();
+        const gsMatrix<T> norm2 = m_tmp.colwise().squaredNorm();
+        for (index_t j = 0; j != step_size.cols(); ++j)
+            step_size(0,j) = ( 0 == norm2(0,j) ? 0 : step_size(0,j) / norm2(0,j) );
+    }
     else
-        step_size = m_step_size;
+        step_size.setConstant(1, m_res.cols(), m_step_size);
 
-    x += step_size * m_update;
-    m_res -= step_size * m_tmp;
-    m_error = m_res.norm() / m_rhs_norm;
+    x += m_update * step_size.asDiagonal();
+    m_res -= m_tmp * step_size.asDiagonal();
+    m_error = Base::columnErrors(m_res).maxCoeff();
     return m_error < m_tol;
 }
 
@@ -21,6 +21,11 @@ namespace gismo
 {
 /// @brief Abstract class for iterative solvers.
 ///
+/// The right-hand side may have several columns. Then all columns
+/// are solved for simultaneously: the operator and the
+/// preconditioner are applied to blocks of vectors, while every
+/// column has its own iteration coefficients.
+///
 /// \ingroup Solver
 template<class T=real_t>
 class gsIterativeSolver
@@ -109,7 +114,8 @@ public:
     /// @brief Solves the linear system and stores the solution in \a x
     ///
     /// Solves the linear system of equations
-    /// @param[in]     rhs      the right hand side of the linear system
+    /// @param[in]     rhs      the right hand side of the linear system,
+    ///                         or several right hand sides as columns
     /// @param[in,out] x        starting value; the solution is stored in here
     void solve( const VectorType& rhs, VectorType& x )
     {
@@ -171,8 +177,6 @@ public:
     /// Init the iteration
     virtual bool initIteration( const VectorType& rhs, VectorType& x )
     {
-        GISMO_ASSERT( rhs.cols() == 1,
-                      "Iterative solvers only work for single column right-hand side." );
         GISMO_ASSERT( rhs.rows() == m_mat->rows(),
                       "The right-hand side does not match the matrix: "
                       << rhs.rows() <<"!="<< m_mat->rows() );
@@ -180,6 +184,10 @@ public:
         m_num_iter = 0;
 
         m_rhs_norm = rhs.norm();
+        m_rhs_norms = rhs.colwise().norm();
+        for (index_t j = 0; j != m_rhs_norms.cols(); ++j)
+            if (0 == m_rhs_norms(0,j)) // zero columns: relative to the whole rhs
+                m_rhs_norms(0,j) = (0 == m_rhs_norm ? (T)1 : m_rhs_norm);
 
         if (0 == m_rhs_norm) // special case of zero rhs
         {
@@ -192,8 +200,9 @@ public:
             x.setZero(rhs.rows(), rhs.cols());
         else
         {
-            GISMO_ASSERT( x.cols() == 1,
-                      "Iterative solvers only work for single right-hand side and solution." );
+            GISMO_ASSERT( x.cols() == rhs.cols(),
+                      "The initial guess does not match the right-hand side: "
+                      << x.cols() <<"!="<< rhs.cols() );
             GISMO_ASSERT( x.rows() == m_mat->cols(),
                       "The initial guess does not match the matrix: "
                       << x.rows() <<"!="<< m_mat->cols() );
@@ -228,7 +237,8 @@ public:
     /// @brief The relative residual error of the current iterate
     ///
     /// This is the Euclidean norm of the residual, devided by the Euclidean
-    /// norm of the right-hand side.
+    /// norm of the right-hand side. For several right-hand sides, this is
+    /// the largest relative error of the columns.
     T error() const                                            { return m_error; }
 
     /// The chosen tolerance for the error criteria on the relative residual error
@@ -248,6 +258,13 @@ public:
         return os.str();
     }
 
+protected:
+
+    /// @brief Returns the relative errors of the columns of the
+    /// residual \a res, as a row vector
+    gsMatrix<T> columnErrors( const VectorType& res ) const
+    { return res.colwise().norm().cwiseQuotient(m_rhs_norms); }
+
 protected:
     const LinOpPtr m_mat;             ///< The matrix/operator to be solved for
     LinOpPtr       m_precond;         ///< The preconditioner
@@ -255,6 +272,7 @@ protected:
     T              m_tol;             ///< The tolerance for m_error to be reached
     index_t        m_num_iter;        ///< The number of iterations performed
     T              m_rhs_norm;        ///< The norm of the right-hand-side
+    gsMatrix<T>    m_rhs_norms;       ///< The norms of the columns of the right-hand-side
     T              m_error;           ///< The relative error as absolute_error/m_rhs_norm
 };
 
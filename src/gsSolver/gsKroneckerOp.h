@@ -13,6 +13,7 @@
 #pragma once
 
 #include <gsSolver/gsLinearOperator.h>
+#include <gsUtils/gsThreaded.h>
 
 namespace gismo
 {
@@ -23,6 +24,15 @@ namespace gismo
 ///
 /// where \f$ A \otimes B = ( a_{11} B \  a_{12} B \ ... ;  a_{21} B \  a_{22} B \ ... ; ... ) \f$.
 ///
+/// The operators are applied one after the other to the input, which is
+/// seen as a tensor. After every application, the mode of the tensor that
+/// was acted on is moved to the end by cache-blocked transposes, which
+/// are distributed among the threads. The object keeps one set of buffers
+/// per thread between calls, so repeated applications to inputs of the
+/// same size do not allocate memory, provided that the operators are
+/// square. Since the buffers belong to the calling thread, the operator
+/// can be applied concurrently.
+///
 /// \ingroup Solver
 template <class T>
 class gsKroneckerOp GISMO_FINAL : public gsLinearOperator<T>
@@ -81,8 +91,15 @@ public:
     /// Apply provided linear operators without the need of creating an object
     static void apply(const std::vector<BasePtr> & ops, const gsMatrix<T> & input, gsMatrix<T> & x);
 
+private:
+    // Applies the operators using the given buffers
+    static void apply(const std::vector<BasePtr> & ops, const gsMatrix<T> & input, gsMatrix<T> & x,
+                      gsMatrix<T> & q, gsMatrix<T> & temp);
+
 private:
     std::vector<BasePtr> m_ops;
+    mutable util::gsThreaded<gsMatrix<T> > m_q;    ///< Workspace of apply (one per thread)
+    mutable util::gsThreaded<gsMatrix<T> > m_temp; ///< Workspace of apply (one per thread)
 };
 
 }
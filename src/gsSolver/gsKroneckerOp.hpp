@@ -15,8 +15,47 @@ namespace gismo
 {
 
 /// @cond
+namespace internal
+{
+
+// Transposes the n column-major matrices of size rows x cols stored
+// one after the other at src and writes the results to dst. The
+// matrices are split into square blocks that fit into the cache, which
+// are distributed among the threads.
+template <typename T>
+void kroneckerTranspose(const T * src, index_t rows, index_t cols, index_t n, T * dst)
+{
+    const index_t bs = 32;
+    const index_t nbr = (rows + bs - 1) / bs, nbc = (cols + bs - 1) / bs;
+    const index_t nb = nbr * nbc;
+    const index_t total = n * nb;
+
+#   pragma omp parallel for if ( rows * cols * n > 32768 )
+    for (index_t b = 0; b < total; ++b)
+    {
+        const index_t k  = b / nb;
+        const index_t i0 = ( (b % nb) % nbr ) * bs;
+        const index_t j0 = ( (b % nb) / nbr ) * bs;
+        const index_t ni = math::min(bs, rows - i0);
+        const index_t nj = math::min(bs, cols - j0);
+        gsAsConstMatrix<T> in (src + k * rows * cols, rows, cols);
+        gsAsMatrix<T>      out(dst + k * rows * cols, cols, rows);
+        out.block(j0, i0, nj, ni) = in.block(i0, j0, ni, nj).transpose();
+    }
+}
+
+} // namespace internal
+
 template <typename T>
 void gsKroneckerOp<T>::apply(const std::vector<typename gsLinearOperator<T>::Ptr> & ops, const gsMatrix<T> & input, gsMatrix<T> & x)
+{
+    gsMatrix<T> q, temp;
+    apply(ops, input, x, q, temp);
+}
+
+template <typename T>
+void gsKroneckerOp<T>::apply(const std::vector<typename gsLinearOperator<T>::Ptr> & ops, const gsMatrix<T> & input, gsMatrix<T> & x,
+                             gsMatrix<T> & q, gsMatrix<T> & temp)
 {
     GISMO_ASSERT( !ops.empty(), "Zero-term Kronecker product" );
     const index_t nrOps = ops.size();
@@ -27,24 +66,19 @@ void gsKroneckerOp<T>::apply(const std::vector<typename gsLinearOperator<T>::Ptr
         return;
     }
 
-    //index_t rows = 1; // we don't compute rows as we do not need it
     index_t sz = 1;
 
     for (index_t i = 0; i < nrOps; ++i)
-    {
-        //rows *= ops[i]->rows();
         sz *= ops[i]->cols();
-    }
 
     GISMO_ASSERT (sz == input.rows(), "The input matrix has wrong size.");
     const index_t n = input.cols();
 
-    // Note: algorithm relies on col-major matrices
-    gsMatrix<T, Dynamic, Dynamic, ColMajor> q0, q1;
-    gsMatrix<T> temp;
+    // Note: algorithm relies on col-major matrices. Resizing to the same
+    // number of entries keeps the data, so the buffers are reshaped in place.
 
     // size: sz x n
-    q0 = input;
+    q = input;
 
     for (index_t i = nrOps - 1; i >= 0; --i)
     {
@@ -54,38 +88,40 @@ void gsKroneckerOp<T>::apply(const std::vector<typename gsLinearOperator<T>::Ptr
         const index_t r_i  = sz / cols_i;
 
         // Re-order right-hand sides
-        q0.resize(cols_i, n * r_i);
+        q.resize(cols_i, n * r_i);
 
         // Apply operator
-        ops[i]->apply(q0, temp);
+        ops[i]->apply(q, temp);
         GISMO_ASSERT (temp.rows() == rows_i && temp.cols() == n * r_i, "The linear operator returned a matrix with unexpected size.");
 
-        // Transpose solution component-wise
-        if (n == 1)
-            q1 = temp.transpose();
-        else
-        {
-            q1.resize(r_i, n * rows_i);
-            for (index_t k = 0; k != n; ++k)
-                q1.middleCols(k*rows_i, rows_i) = temp.middleCols(k*r_i, r_i).transpose();
-        }
-
-        q1.swap( q0 ); // move solution as next right-hand side
+        // Transpose solution component-wise; it is the next right-hand
+        // side, or the result in the last step
+        gsMatrix<T> & next = ( i == 0 ? x : q );
+        next.resize(r_i, n * rows_i);
+        internal::kroneckerTranspose(temp.data(), rows_i, r_i, n, next.data());
+
         sz = ( sz / cols_i) * rows_i; // update now the dimensionality such that in the end sz = rows
         //sz % cols_i == 0, since sz *= ops[i]->cols();
     }
 
-    //GISMO_ASSERT (sz == rows, "Internal error."); // see one above
-
-    q0.resize(sz, n);
-    x.swap( q0 );
+    x.resize(sz, n);
 }
 /// @endcond
 
 template <typename T>
 void gsKroneckerOp<T>::apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
 {
-    apply(m_ops, input, x);
+#   ifdef _OPENMP
+    // In nested regions the thread number does not identify the
+    // calling thread, so the buffers of the object cannot be used
+    if ( omp_get_level() > 1 ||
+         omp_get_thread_num() >= static_cast<int>(m_q.size()) )
+    {
+        apply(m_ops, input, x);
+        return;
+    }
+#   endif
+    apply(m_ops, input, x, m_q.mine(), m_temp.mine());
 }
 
 template <typename T>
@@ -18,6 +18,9 @@ namespace gismo
 {
 
 /** @brief The minimal residual (MinRes) method.
+  *
+  * For several right-hand sides, the columns are iterated
+  * simultaneously, each with its own Lanczos coefficients.
   *
   * \ingroup Solver
   */
@@ -99,10 +102,12 @@ private:
                      wPrev, w, wNew, AwPrev, Aw, AwNew,
                      zNew, z, Az;
 
-    T eta,
-           gammaPrev, gamma, gammaNew,
-           sPrev, s, sNew,
-           cPrev, c, cNew;
+    // Coefficients of each column, as row vectors
+    gsMatrix<T> eta,
+                gammaPrev, gamma, gammaNew,
+                sPrev, s, sNew,
+                cPrev, c, cNew,
+                m_errors;
 
     bool m_inexact_residual;
 };
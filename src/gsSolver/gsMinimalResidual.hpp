@@ -21,7 +21,7 @@ bool gsMinimalResidual<T>::initIteration( const typename gsMinimalResidual<T>::V
     //if (Base::initIteration(rhs,x)) return true; // z will not be initialized!
 
     int n = m_mat->cols();
-    int m = 1; // = rhs.cols();
+    int m = rhs.cols();
 
     vPrev.setZero(n,m); vNew.setZero(n,m);
     wPrev.setZero(n,m); w.setZero(n,m); wNew.setZero(n,m);
@@ -31,17 +31,19 @@ bool gsMinimalResidual<T>::initIteration( const typename gsMinimalResidual<T>::V
     m_mat->apply(x,negResidual);
     negResidual -= rhs;
 
-    m_error = negResidual.norm() / m_rhs_norm;
+    m_errors = Base::columnErrors(negResidual);
+    m_error = m_errors.maxCoeff();
     if (m_error < m_tol)
         return true;
 
     v = -negResidual;
     m_precond->apply(v, z);
 
-    gammaPrev = 1; gamma = math::sqrt(z.col(0).dot(v.col(0))); gammaNew = 1;
+    // The coefficients are row vectors, with one entry per column
+    gammaPrev.setOnes(1,m); gamma = z.cwiseProduct(v).colwise().sum().cwiseSqrt(); gammaNew.setOnes(1,m);
     eta = gamma;
-    sPrev = 0; s = 0; sNew = 0;
-    cPrev = 1; c = 1; cNew = 1;
+    sPrev.setZero(1,m); s.setZero(1,m); sNew.setZero(1,m);
+    cPrev.setOnes(1,m); c.setOnes(1,m); cNew.setOnes(1,m);
 
     return false;
 }
@@ -49,32 +51,39 @@ bool gsMinimalResidual<T>::initIteration( const typename gsMinimalResidual<T>::V
 template<class T>
 bool gsMinimalResidual<T>::step( typename gsMinimalResidual<T>::VectorType& x )
 {
-    z /= gamma;
+    // Columns with vanishing coefficients have converged; they are
+    // kept fixed by using zero instead of 1/0
+    const gsMatrix<T> gammaInv = ( gamma.array() == 0 ).select( (T)0, gamma.array().inverse() ).matrix();
+    z = z * gammaInv.asDiagonal();
     m_mat->apply(z,Az);
 
-    T delta = z.col(0).dot(Az.col(0));
-    vNew = Az - (delta/gamma)*v - (gamma/gammaPrev)*vPrev;
+    const gsMatrix<T> delta = z.cwiseProduct(Az).colwise().sum();
+    const gsMatrix<T> gammaRatio = ( gammaPrev.array() == 0 ).select( (T)0, gamma.array() / gammaPrev.array() ).matrix();
+    vNew = Az - v * delta.cwiseProduct(gammaInv).asDiagonal() - vPrev * gammaRatio.asDiagonal();
     m_precond->apply(vNew, zNew);
-    gammaNew = math::sqrt(zNew.col(0).dot(vNew.col(0)));
-    const T a0 = c*delta - cPrev*s*gamma;
-    const T a1 = math::sqrt(a0*a0 + gammaNew*gammaNew);
-    const T a2 = s*delta + cPrev*c*gamma;
-    const T a3 = sPrev*gamma;
-    cNew = a0/a1;
-    sNew = gammaNew/a1;
-    wNew = (z - a3*wPrev - a2*w)/a1;
+    gammaNew = zNew.cwiseProduct(vNew).colwise().sum().cwiseSqrt();
+    const gsMatrix<T> a0 = ( c.array()*delta.array() - cPrev.array()*s.array()*gamma.array() ).matrix();
+    const gsMatrix<T> a1 = ( a0.array().square() + gammaNew.array().square() ).sqrt().matrix();
+    const gsMatrix<T> a2 = ( s.array()*delta.array() + cPrev.array()*c.array()*gamma.array() ).matrix();
+    const gsMatrix<T> a3 = sPrev.cwiseProduct(gamma);
+    const gsMatrix<T> a1Inv = ( a1.array() == 0 ).select( (T)0, a1.array().inverse() ).matrix();
+    cNew = a0.cwiseProduct(a1Inv);
+    sNew = gammaNew.cwiseProduct(a1Inv);
+    wNew = (z - wPrev*a3.asDiagonal() - w*a2.asDiagonal()) * a1Inv.asDiagonal();
     if (!m_inexact_residual)
-        AwNew = (Az - a3*AwPrev - a2*Aw)/a1;
-    x += cNew*eta*wNew;
+        AwNew = (Az - AwPrev*a3.asDiagonal() - Aw*a2.asDiagonal()) * a1Inv.asDiagonal();
+    const gsMatrix<T> update = cNew.cwiseProduct(eta);
+    x += wNew * update.asDiagonal();
     if (!m_inexact_residual)
-        negResidual += cNew*eta*AwNew;
+        negResidual += AwNew * update.asDiagonal();
 
     if (m_inexact_residual)
-        m_error *= math::abs(sNew); // see https://eigen.tuxfamily.org/dox-devel/unsupported/MINRES_8h_source.html
+        m_errors = m_errors.cwiseProduct(sNew.cwiseAbs()); // see https://eigen.tuxfamily.org/dox-devel/unsupported/MINRES_8h_source.html
     else
-        m_error = negResidual.norm() / m_rhs_norm;
+        m_errors = Base::columnErrors(negResidual);
+    m_error = m_errors.maxCoeff();
 
-    eta = -sNew*eta;
+    eta = -sNew.cwiseProduct(eta);
 
     // Test for convergence
     if (m_error < m_tol)
@@ -86,9 +95,9 @@ bool gsMinimalResidual<T>::step( typename gsMinimalResidual<T>::VectorType& x )
     if (!m_inexact_residual)
         { AwPrev.swap(Aw); Aw.swap(AwNew); } // for us the same as: AwPrev = Aw; Aw = AwNew;
     z.swap(zNew);                    // for us the same as: z = zNew;
-    gammaPrev = gamma; gamma = gammaNew;
-    sPrev = s; s = sNew;
-    cPrev = c; c = cNew;
+    gammaPrev.swap(gamma); gamma.swap(gammaNew);
+    sPrev.swap(s); s.swap(sNew);
+    cPrev.swap(c); c.swap(cNew);
     return false;
 }
 
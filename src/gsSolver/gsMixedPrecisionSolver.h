@@ -0,0 +1,292 @@
+/** @file gsMixedPrecisionSolver.h
+
+    @brief Direct solver with a low precision factorization and iterative refinement.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsSolver/gsLinearOperator.h>
+#include <gsSolver/gsGMRes.h>
+#include <gsIO/gsOptionList.h>
+
+namespace gismo
+{
+
+/// @brief Direct solver that factorizes in low precision and recovers the
+/// full accuracy by iterative refinement
+///
+/// The matrix is factorized by the sparse solver \a Solver in the scalar
+/// type \a LowT (usually single precision). This roughly halves the memory
+/// for the fill-in and reduces the time for the factorization. The accuracy
+/// of the full scalar type \a T is then recovered either by
+///
+/// - classical iterative refinement (\a refinement): the correction for the
+///   residual, computed in full precision, is obtained with the low
+///   precision factorization, or by
+/// - GMRES-IR (\a gmres): the correction is obtained by applying
+///   \a gsGMRes to the full precision system, preconditioned with the low
+///   precision factorization. This also converges for matrices whose
+///   condition number is too large for classical refinement.
+///
+/// If the factorization fails in low precision (e.g., since the entries
+/// are out of range), the matrix is factorized in full precision right
+/// away. If the refinement stagnates, i.e., one step does not reduce the
+/// residual at least by the factor "StagnationRatio", or if the tolerance
+/// is not reached within "MaxIterations" steps, the matrix is factorized
+/// in full precision and the system is solved directly. The full precision
+/// factorization is then used for all subsequent calls of \ref solve until
+/// \ref compute is called again.
+///
+/// The solver keeps a copy of the matrix in full precision to compute the
+/// residuals.
+///
+/// \code
+///    gsMixedPrecisionSolver<> solver(mat);
+///    solver.setTolerance(1e-12);
+///    gsMatrix<> x = solver.solve(rhs);
+/// \endcode
+///
+/// \ingroup Solver
+template <typename T = real_t, typename LowT = float,
+          template<typename> class Solver = gsEigenSparseLU>
+class gsMixedPrecisionSolver : public gsSparseSolver<T>
+{
+public:
+    typedef typename gsSparseSolver<T>::MatrixT MatrixT;
+    typedef typename gsSparseSolver<T>::VectorT VectorT;
+    typedef gsSparseMatrix<LowT>                LowMatrixT;
+    typedef gsMatrix<LowT>                      LowVectorT;
+
+    /// The methods to recover the full accuracy
+    enum method
+    {
+        refinement = 0, ///< Classical iterative refinement
+        gmres      = 1  ///< GMRES preconditioned with the low precision factorization
+    };
+
+private:
+    /// The low precision factorization as \a gsLinearOperator in full precision
+    class LowPrecisionOp GISMO_FINAL : public gsLinearOperator<T>
+    {
+    public:
+        explicit LowPrecisionOp(const gsMixedPrecisionSolver& solver) : m_solver(solver) {}
+
+        void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+        { x = m_solver.lowPrecisionSolve(input); }
+
+        index_t rows() const { return m_solver.m_matrix->rows(); }
+        index_t cols() const { return m_solver.m_matrix->cols(); }
+
+    private:
+        const gsMixedPrecisionSolver& m_solver;
+    };
+
+public:
+
+    /// Default constructor. The matrix is provided by \ref compute
+    gsMixedPrecisionSolver()
+    : m_method(refinement), m_max_iters(20), m_tol(1e-10), m_stagnation(0.5),
+      m_fullPrecision(false), m_success(false), m_num_iter(0), m_error(-1)
+    { }
+
+    /// Constructor taking the matrix to be factorized
+    explicit gsMixedPrecisionSolver(const MatrixT& matrix)
+    : m_method(refinement), m_max_iters(20), m_tol(1e-10), m_stagnation(0.5),
+      m_fullPrecision(false), m_success(false), m_num_iter(0), m_error(-1)
+    { compute(matrix); }
+
+    /// @brief Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt;
+        opt.addInt   ("Method"           , "Method to recover the full accuracy "
+                                           "(0: iterative refinement, 1: GMRES-IR)", refinement );
+        opt.addInt   ("MaxIterations"    , "Maximum number of refinement steps "
+                                           "and of GMRES iterations per step",   20         );
+        opt.addReal  ("Tolerance"        , "Tolerance for the error criteria on the "
+                                           "relative residual error",             1e-10      );
+        opt.addReal  ("StagnationRatio"  , "Fall back to full precision if a refinement "
+                                           "step does not reduce the residual by this factor", 0.5 );
+        return opt;
+    }
+
+    /// @brief Set the options based on a gsOptionList
+    gsMixedPrecisionSolver& setOptions(const gsOptionList & opt)
+    {
+        m_method           = static_cast<method>(opt.askInt("Method", m_method));
+        m_max_iters        = opt.askInt   ("MaxIterations"    , m_max_iters        );
+        m_tol              = opt.askReal  ("Tolerance"        , m_tol              );
+        m_stagnation       = opt.askReal  ("StagnationRatio"  , m_stagnation       );
+        return *this;
+    }
+
+    /// @brief Factorizes the matrix in low precision
+    ///
+    /// If this fails, the matrix is factorized in full precision.
+    gsMixedPrecisionSolver& compute(const MatrixT& matrix)
+    {
+        GISMO_ASSERT(matrix.rows() == matrix.cols(), "Need square matrix");
+        m_matrix = memory::make_shared( new MatrixT(matrix) );
+        m_fullSolver.reset();
+        m_fullPrecision = false;
+
+        const LowMatrixT lowMatrix = matrix.template cast<LowT>();
+        m_lowSolver.compute(lowMatrix);
+        if (!m_lowSolver.succeed())
+            computeFullPrecision();
+        return *this;
+    }
+
+    /// @brief Solves for the given right-hand side(s) up to the tolerance
+    VectorT solve(const VectorT& rhs) const
+    {
+        GISMO_ASSERT(m_matrix, "gsMixedPrecisionSolver: No matrix given. Forgot to call compute()?");
+        GISMO_ASSERT(rhs.rows() == m_matrix->rows(), "The right-hand side does not match the matrix: "
+                     << rhs.rows() << "!=" << m_matrix->rows() );
+
+        m_num_iter = 0;
+        VectorT x;
+        if (!m_fullPrecision)
+        {
+            solveRefinement(rhs, x);
+        }
+
+        if (m_fullPrecision)
+        {
+            x = m_fullSolver->solve(rhs);
+            m_error = relativeError(rhs, x);
+            m_success = m_fullSolver->succeed();
+        }
+        return x;
+    }
+
+    /// Returns true if the last call of \ref solve reached the tolerance
+    /// (or if the full precision solver succeeded)
+    bool succeed() const                           { return m_success; }
+
+    /// Returns true if the matrix has been factorized in full precision
+    bool usesFullPrecision() const                 { return m_fullPrecision; }
+
+    /// The number of refinement steps of the last call of \ref solve
+    index_t iterations() const                     { return m_num_iter; }
+
+    /// The largest relative residual error of the columns after the last call of \ref solve
+    T error() const                                { return m_error; }
+
+    /// Set the method to recover the full accuracy (default: refinement)
+    void setMethod(method m)                       { m_method = m; }
+
+    /// Set the maximum number of refinement steps and of GMRES iterations per step (default: 20)
+    void setMaxIterations(index_t max_iters)       { m_max_iters = max_iters; }
+
+    /// Set the tolerance for the error criteria on the relative residual error (default: 1e-10)
+    void setTolerance(T tol)                       { m_tol = tol; }
+
+    /// The chosen tolerance for the error criteria on the relative residual error
+    T tolerance() const                            { return m_tol; }
+
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsMixedPrecisionSolver (" << (m_method == gmres ? "GMRES-IR" : "iterative refinement")
+           << ", " << (m_fullPrecision ? "full" : "low") << " precision factorization)\n";
+        return os;
+    }
+
+private:
+
+    /// Factorizes the stored matrix in full precision
+    void computeFullPrecision() const
+    {
+        m_fullSolver.reset( new Solver<T>(*m_matrix) );
+        m_fullPrecision = true;
+    }
+
+    /// Applies the low precision factorization
+    VectorT lowPrecisionSolve(const VectorT& rhs) const
+    {
+        const LowVectorT lowRhs = rhs.template cast<LowT>();
+        return m_lowSolver.solve(lowRhs).template cast<T>();
+    }
+
+    /// The largest relative residual error of the columns; zero columns
+    /// are taken relative to the whole right-hand side
+    T relativeError(const VectorT& rhs, const VectorT& x) const
+    {
+        const T rhsNorm = rhs.norm();
+        const VectorT res = rhs - (*m_matrix) * x;
+        T result = 0;
+        for (index_t j = 0; j < rhs.cols(); ++j)
+        {
+            T colNorm = rhs.col(j).norm();
+            if (0 == colNorm) colNorm = (0 == rhsNorm ? (T)1 : rhsNorm);
+            result = math::max(result, res.col(j).norm() / colNorm);
+        }
+        return result;
+    }
+
+    /// Computes the correction for the given residual
+    VectorT correction(const VectorT& res) const
+    {
+        if (m_method != gmres)
+            return lowPrecisionSolve(res);
+
+        // The inner GMRES solver only needs to reduce the residual up to
+        // the overall tolerance
+        const typename gsLinearOperator<T>::Ptr matOp = makeMatrixOp(m_matrix);
+        const typename gsLinearOperator<T>::Ptr precOp = memory::make_shared( new LowPrecisionOp(*this) );
+        gsGMRes<T> solver(matOp, precOp);
+        solver.setMaxIterations(m_max_iters);
+        solver.setTolerance( math::min( (T)(0.5), m_tol / m_error ) );
+        VectorT x;
+        solver.solve(res, x);
+        return x;
+    }
+
+    /// Iterative refinement, where the corrections are computed by \ref correction
+    void solveRefinement(const VectorT& rhs, VectorT& x) const
+    {
+        x = lowPrecisionSolve(rhs);
+        m_error = relativeError(rhs, x);
+
+        while (m_error > m_tol && m_num_iter < m_max_iters)
+        {
+            ++m_num_iter;
+            x += correction( rhs - (*m_matrix) * x );
+            const T newError = relativeError(rhs, x);
+            // Also catches a factorization producing non-finite values
+            if ( !(newError <= m_stagnation * m_error) )
+            {
+                m_error = newError;
+                break;
+            }
+            m_error = newError;
+        }
+
+        m_success = m_error <= m_tol;
+        if (!m_success)
+            computeFullPrecision();
+    }
+
+private:
+    memory::shared_ptr<MatrixT> m_matrix;        ///< The matrix in full precision
+    Solver<LowT>                m_lowSolver;     ///< The low precision factorization
+    mutable memory::unique_ptr< Solver<T> > m_fullSolver; ///< The full precision factorization (fallback)
+
+    method                      m_method;        ///< The method to recover the full accuracy
+    index_t                     m_max_iters;     ///< The maximum number of refinement steps
+    T                           m_tol;           ///< The tolerance for the relative residual error
+    T                           m_stagnation;    ///< The required reduction per refinement step
+
+    mutable bool                m_fullPrecision; ///< True iff the full precision factorization is used
+    mutable bool                m_success;       ///< True iff the last solve reached the tolerance
+    mutable index_t             m_num_iter;      ///< The number of iterations of the last solve
+    mutable T                   m_error;         ///< The relative residual error of the last solve
+};
+
+} // namespace gismo
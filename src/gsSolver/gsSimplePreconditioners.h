@@ -24,6 +24,11 @@ template<typename T>
 void gaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatrix<T>& f);
 template<typename T>
 void reverseGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatrix<T>& f);
+template<typename T>
+void matrixColoring(const gsSparseMatrix<T> & A, std::vector<index_t>& colorPtr, std::vector<index_t>& rows);
+template<typename T>
+void multiColorGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatrix<T>& f,
+                                const std::vector<index_t>& colorPtr, const std::vector<index_t>& rows, bool reverse);
 } // namespace internal
 
 /// @brief Richardson preconditioner
@@ -180,9 +185,9 @@ public:
         GISMO_ASSERT( m_expr.rows() == rhs.rows() && m_expr.cols() == m_expr.rows(),
                       "Dimensions do not match.");
 
-        GISMO_ASSERT( rhs.cols() == 1, "This operator is only implemented for a single right-hand side." );
-
-        x.array() += m_tau * ( rhs - m_expr * x ).array() / m_expr.diagonal().array();
+        gsMatrix<T> dinv = m_expr.diagonal();
+        dinv = m_tau * dinv.cwiseInverse();
+        x += dinv.asDiagonal() * ( rhs - m_expr * x );
     }
 
     // We use our own apply implementation as we can save one multiplication. This is important if the number
@@ -192,13 +197,14 @@ public:
         GISMO_ASSERT( m_expr.rows() == input.rows() && m_expr.cols() == m_expr.rows(),
                       "Dimensions do not match.");
 
-        GISMO_ASSERT( input.cols() == 1, "This operator is only implemented for a single right-hand side." );
+        gsMatrix<T> dinv = m_expr.diagonal();
+        dinv = m_tau * dinv.cwiseInverse();
 
         // For the first sweep, we do not need to multiply with the matrix
-        x.array() = m_tau * input.array() / m_expr.diagonal().array();
+        x.noalias() = dinv.asDiagonal() * input;
 
         for (index_t k = 1; k < m_num_of_sweeps; ++k)
-            x.array() += m_tau * ( input - m_expr * x ).array() / m_expr.diagonal().array();
+            x += dinv.asDiagonal() * ( input - m_expr * x );
     }
 
     index_t rows() const {return m_expr.rows();}
@@ -388,6 +394,130 @@ template <class Derived>
 typename gsGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::uPtr makeSymmetricGaussSeidelOp(const memory::shared_ptr<Derived>& mat)
 { return gsGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::make(mat); }
 
+/// @brief Multicolor Gauss-Seidel preconditioner
+///
+/// The unknowns are colored such that no two unknowns of the same color
+/// are coupled by the matrix. The sweep visits the colors one after the
+/// other; the rows of one color are updated in parallel (if OpenMP is
+/// enabled). The coloring is computed greedily from the sparsity
+/// pattern, visiting the unknowns in their natural order, so the
+/// number of colors is at most the maximal number of nonzeros per
+/// row. For spline discretizations this depends on the degree, but
+/// not on the number of unknowns.
+///
+/// `ordering` can be `gsGaussSeidel::forward`, `gsGaussSeidel::reverse` or
+/// `gsGaussSeidel::symmetric`, and refers to the order of the colors.
+///
+/// \ingroup Solver
+template <typename MatrixType, gsGaussSeidel::ordering ordering = gsGaussSeidel::forward>
+class gsMultiColorGaussSeidelOp GISMO_FINAL : public gsPreconditionerOp<typename MatrixType::Scalar>
+{
+    typedef memory::shared_ptr<MatrixType>          MatrixPtr;
+    typedef typename MatrixType::Nested             NestedMatrix;
+
+public:
+    /// Scalar type
+    typedef typename MatrixType::Scalar T;
+
+    /// Shared pointer for gsMultiColorGaussSeidelOp
+    typedef memory::shared_ptr< gsMultiColorGaussSeidelOp > Ptr;
+
+    /// Unique pointer for gsMultiColorGaussSeidelOp
+    typedef memory::unique_ptr< gsMultiColorGaussSeidelOp > uPtr;
+
+    /// Base class
+    typedef gsPreconditionerOp<T> Base;
+
+    /// Constructor with given matrix
+    explicit gsMultiColorGaussSeidelOp(const MatrixType& _mat)
+    : m_mat(), m_expr(_mat.derived())
+    { internal::matrixColoring<T>(m_expr, m_colorPtr, m_rows); }
+
+    /// Constructor with shared pointer to matrix
+    explicit gsMultiColorGaussSeidelOp(const MatrixPtr& _mat)
+    : m_mat(_mat), m_expr(m_mat->derived())
+    { internal::matrixColoring<T>(m_expr, m_colorPtr, m_rows); }
+
+    static uPtr make(const MatrixType& _mat)
+    { return memory::make_unique( new gsMultiColorGaussSeidelOp(_mat) ); }
+
+    static uPtr make(const MatrixPtr& _mat)
+    { return memory::make_unique( new gsMultiColorGaussSeidelOp(_mat) ); }
+
+    void step(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        if (ordering == gsGaussSeidel::forward )
+            internal::multiColorGaussSeidelSweep<T>(m_expr,x,rhs,m_colorPtr,m_rows,false);
+        if (ordering == gsGaussSeidel::reverse )
+            internal::multiColorGaussSeidelSweep<T>(m_expr,x,rhs,m_colorPtr,m_rows,true);
+        if (ordering == gsGaussSeidel::symmetric )
+        {
+            internal::multiColorGaussSeidelSweep<T>(m_expr,x,rhs,m_colorPtr,m_rows,false);
+            internal::multiColorGaussSeidelSweep<T>(m_expr,x,rhs,m_colorPtr,m_rows,true);
+        }
+    }
+
+    void stepT(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        if ( ordering == gsGaussSeidel::forward )
+            internal::multiColorGaussSeidelSweep<T>(m_expr,x,rhs,m_colorPtr,m_rows,true);
+        if ( ordering == gsGaussSeidel::reverse )
+            internal::multiColorGaussSeidelSweep<T>(m_expr,x,rhs,m_colorPtr,m_rows,false);
+        if ( ordering == gsGaussSeidel::symmetric )
+        {
+            internal::multiColorGaussSeidelSweep<T>(m_expr,x,rhs,m_colorPtr,m_rows,false);
+            internal::multiColorGaussSeidelSweep<T>(m_expr,x,rhs,m_colorPtr,m_rows,true);
+        }
+    }
+
+    index_t rows() const {return m_expr.rows();}
+    index_t cols() const {return m_expr.cols();}
+
+    /// Returns the number of colors
+    index_t numColors() const { return m_colorPtr.size() - 1; }
+
+    /// Returns the matrix
+    NestedMatrix matrix() const { return m_expr; }
+
+    /// Returns a shared pinter to the matrix
+    MatrixPtr    matrixPtr() const {
+        GISMO_ENSURE( m_mat, "A shared pointer is only available if it was provided to gsMultiColorGaussSeidelOp." );
+        return m_mat;
+    }
+
+    typename gsLinearOperator<T>::Ptr underlyingOp() const { return makeMatrixOp(m_mat); }
+
+private:
+    const MatrixPtr m_mat;  ///< Shared pointer to matrix (if needed)
+    NestedMatrix    m_expr; ///< Nested Eigen expression
+    std::vector<index_t> m_colorPtr; ///< Rows of color c are m_rows[m_colorPtr[c]], ..., m_rows[m_colorPtr[c+1]-1]
+    std::vector<index_t> m_rows;     ///< Rows sorted by color
+};
+
+/// @brief Returns a smart pointer to a multicolor Gauss-Seidel operator referring on \a mat
+/// \relates gsMultiColorGaussSeidelOp
+template <class Derived>
+typename gsMultiColorGaussSeidelOp<Derived>::uPtr makeMultiColorGaussSeidelOp(const Eigen::EigenBase<Derived>& mat)
+{ return gsMultiColorGaussSeidelOp<Derived>::make(mat.derived()); }
+
+/// @brief Returns a smart pointer to a multicolor Gauss-Seidel operator referring on \a mat
+/// \relates gsMultiColorGaussSeidelOp
+template <class Derived>
+typename gsMultiColorGaussSeidelOp<Derived>::uPtr makeMultiColorGaussSeidelOp(const memory::shared_ptr<Derived>& mat)
+{ return gsMultiColorGaussSeidelOp<Derived>::make(mat); }
+
+/// @brief Returns a smart pointer to a symmetric multicolor Gauss-Seidel operator referring on \a mat
+/// \relates gsMultiColorGaussSeidelOp
+template <class Derived>
+typename gsMultiColorGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::uPtr makeSymmetricMultiColorGaussSeidelOp(const Eigen::EigenBase<Derived>& mat)
+{ return gsMultiColorGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::make(mat.derived()); }
+
+/// @brief Returns a smart pointer to a symmetric multicolor Gauss-Seidel operator referring on \a mat
+/// \relates gsMultiColorGaussSeidelOp
+template <class Derived>
+typename gsMultiColorGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::uPtr makeSymmetricMultiColorGaussSeidelOp(const memory::shared_ptr<Derived>& mat)
+{ return gsMultiColorGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::make(mat); }
+
 } // namespace gismo
 
 #ifndef GISMO_BUILD_LIB
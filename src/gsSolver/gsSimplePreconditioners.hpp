@@ -23,9 +23,8 @@ void gaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatri
     GISMO_ASSERT( A.rows() == x.rows() && x.rows() == f.rows() && A.cols() == A.rows() && x.cols() == f.cols(),
         "Dimensions do not match.");
 
-    GISMO_ASSERT( f.cols() == 1, "This operator is only implemented for a single right-hand side." );
-
     // A is supposed to be symmetric, so it doesn't matter if it's stored in row- or column-major order
+    for (index_t j = 0; j < f.cols(); ++j) // sweep over each right-hand side
     for (int i = 0; i < A.outerSize(); ++i)
     {
         T diag = 0;
@@ -33,12 +32,12 @@ void gaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatri
 
         for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
         {
-            sum += it.value() * x( it.index() );        // compute A.x
+            sum += it.value() * x( it.index(), j );     // compute A.x
             if (it.index() == i)
                 diag = it.value();
         }
 
-        x(i) += (f(i) - sum) / diag;
+        x(i,j) += (f(i,j) - sum) / diag;
     }
 }
 
@@ -48,9 +47,8 @@ void reverseGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const
     GISMO_ASSERT( A.rows() == x.rows() && x.rows() == f.rows() && A.cols() == A.rows() && x.cols() == f.cols(),
         "Dimensions do not match.");
 
-    GISMO_ASSERT( f.cols() == 1, "This operator is only implemented for a single right-hand side." );
-
     // A is supposed to be symmetric, so it doesn't matter if it's stored in row- or column-major order
+    for (index_t j = 0; j < f.cols(); ++j) // sweep over each right-hand side
     for (int i = A.outerSize() - 1; i >= 0; --i)
     {
         T diag = 0;
@@ -58,12 +56,86 @@ void reverseGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const
 
         for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
         {
-            sum += it.value() * x( it.index() );        // compute A.x
+            sum += it.value() * x( it.index(), j );     // compute A.x
             if (it.index() == i)
                 diag = it.value();
         }
 
-        x(i) += (f(i) - sum) / diag;
+        x(i,j) += (f(i,j) - sum) / diag;
+    }
+}
+
+template<typename T>
+void matrixColoring(const gsSparseMatrix<T> & A, std::vector<index_t>& colorPtr, std::vector<index_t>& rows)
+{
+    GISMO_ASSERT( A.cols() == A.rows(), "Dimensions do not match.");
+
+    // Greedy coloring of the graph of the matrix. A is supposed to be
+    // symmetric, so the neighbours of i are the entries of its outer vector.
+    const index_t n = A.outerSize();
+    std::vector<index_t> color(n, -1), mark;
+    index_t numColors = 0;
+    for (index_t i = 0; i < n; ++i)
+    {
+        for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
+            if ( color[it.index()] != -1 )
+                mark[color[it.index()]] = i;
+
+        index_t c = 0;
+        while ( c < numColors && mark[c] == i ) ++c;
+        if ( c == numColors )
+        {
+            ++numColors;
+            mark.push_back(-1);
+        }
+        color[i] = c;
+    }
+
+    // Sort the rows by color
+    colorPtr.assign(numColors + 1, 0);
+    for (index_t i = 0; i < n; ++i)
+        ++colorPtr[color[i] + 1];
+    for (index_t c = 0; c < numColors; ++c)
+        colorPtr[c + 1] += colorPtr[c];
+    rows.resize(n);
+    mark.assign(colorPtr.begin(), colorPtr.end() - 1);
+    for (index_t i = 0; i < n; ++i)
+        rows[mark[color[i]]++] = i;
+}
+
+template<typename T>
+void multiColorGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatrix<T>& f,
+                                const std::vector<index_t>& colorPtr, const std::vector<index_t>& rows, bool reverse)
+{
+    GISMO_ASSERT( A.rows() == x.rows() && x.rows() == f.rows() && A.cols() == A.rows() && x.cols() == f.cols(),
+        "Dimensions do not match.");
+    GISMO_ASSERT( static_cast<index_t>(rows.size()) == A.outerSize(), "The coloring does not match the matrix.");
+
+    const index_t numColors = colorPtr.size() - 1;
+    for (index_t k = 0; k < numColors; ++k)
+    {
+        const index_t c = reverse ? numColors - 1 - k : k;
+
+        // The rows of one color are not coupled, so they can be updated in parallel
+#       pragma omp parallel for
+        for (index_t r = colorPtr[c]; r < colorPtr[c+1]; ++r)
+        {
+            const index_t i = rows[r];
+            for (index_t j = 0; j < f.cols(); ++j) // sweep over each right-hand side
+            {
+                T diag = 0;
+                T sum  = 0;
+
+                for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
+                {
+                    sum += it.value() * x( it.index(), j );     // compute A.x
+                    if (it.index() == i)
+                        diag = it.value();
+                }
+
+                x(i,j) += (f(i,j) - sum) / diag;
+            }
+        }
     }
 }
 
@@ -9,6 +9,9 @@ namespace internal
 
 TEMPLATE_INST void gaussSeidelSweep(const gsSparseMatrix<real_t> & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f);
 TEMPLATE_INST void reverseGaussSeidelSweep(const gsSparseMatrix<real_t> & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f);
+TEMPLATE_INST void matrixColoring(const gsSparseMatrix<real_t> & A, std::vector<index_t>& colorPtr, std::vector<index_t>& rows);
+TEMPLATE_INST void multiColorGaussSeidelSweep(const gsSparseMatrix<real_t> & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f,
+                                              const std::vector<index_t>& colorPtr, const std::vector<index_t>& rows, bool reverse);
 
 } // namespace internal
 
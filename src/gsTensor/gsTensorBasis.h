@@ -263,6 +263,19 @@ public:
     // Evaluates the second derivatives of the non-zero basis functions at value u.
     virtual void deriv2_into(const gsMatrix<T> & u, gsMatrix<T>& result ) const;
 
+    /// @brief Evaluates the nonzero basis functions and their derivatives
+    /// up to order \a n at the Cartesian grid of points with coordinate
+    /// vectors \a coords.
+    ///
+    /// Every univariate basis is evaluated once per coordinate, and the
+    /// tensor-product values are formed by sum factorisation. The result
+    /// is the same as evalAllDers_into(gsPointGrid(coords), n, result).
+    /// The evaluation functions above detect such grids, e.g. the
+    /// quadrature nodes given by gsQuadRule::mapTo, and call this
+    /// function automatically.
+    void evalAllDersGrid_into(const std::vector<gsVector<T> > & coords, int n,
+                              std::vector<gsMatrix<T> >& result) const;
+
 private:
     // Internal function
     //
@@ -279,6 +292,21 @@ private:
                    const gsVector<unsigned, d> & size,
                    gsMatrix<T>& result);
 
+    // Internal function
+    //
+    // Computes the derivatives of order k on a grid of points, from the
+    // univariate values[i], i = 0,...,d-1, evaluated at the coordinates
+    // of direction i. The layout is the one of evalAllDers_into.
+    static void gridDers_into(const std::vector< gsMatrix<T> > values[],
+                              int k, gsMatrix<T>& result);
+
+    // Internal function
+    //
+    // Writes the Kronecker product f[d-1] x ... x f[0] into the rows
+    // offset, offset + stride, offset + 2*stride, ... of result.
+    static void gridProduct_into(const gsMatrix<T> * f[], gsMatrix<T>& result,
+                                 index_t stride, index_t offset);
+
 public:
     // see gsBasis for doxygen documentation
     // Evaluate the i-th basis function derivative at all columns of
@@ -20,6 +20,7 @@
 #include <gsCore/gsBoundary.h>
 #include <gsUtils/gsMesh/gsMesh.h>
 #include <gsCore/gsGeometry.h>
+#include <gsUtils/gsPointGrid.h>
 //#include <gsUtils/gsSortedVector.h>
 
 
@@ -505,7 +506,16 @@ void gsTensorBasis<d,T>::eval_into(const gsMatrix<T> & u,
     GISMO_ASSERT( u.rows() == d, 
                   "Attempted to evaluate the tensor-basis on points with the wrong dimension" );
 
-    /// \todo more efficient ?
+    // Points on a Cartesian grid
+    std::vector<gsVector<T> > coords;
+    if ( d > 1 && gsPointGridCoordinates(u, coords) )
+    {
+        std::vector< gsMatrix<T> > values[d];
+        for (short_t i = 0; i < d; ++i)
+            m_bases[i]->evalAllDers_into( coords[i].transpose(), 0, values[i] );
+        gridDers_into(values, 0, result);
+        return;
+    }
 
     gsMatrix<T> ev[d];
     gsVector<unsigned, d> v, size;
@@ -596,6 +606,16 @@ void gsTensorBasis<d,T>::deriv_into(const gsMatrix<T> & u,
 {
     std::vector<gsMatrix<T> > values[d];
 
+    // Points on a Cartesian grid
+    std::vector<gsVector<T> > coords;
+    if ( d > 1 && gsPointGridCoordinates(u, coords) )
+    {
+        for (short_t i = 0; i < d; ++i)
+            m_bases[i]->evalAllDers_into( coords[i].transpose(), 1, values[i] );
+        gridDers_into(values, 1, result);
+        return;
+    }
+
     gsVector<unsigned, d> v, size;
 
     index_t nb = 1;
@@ -641,6 +661,14 @@ void gsTensorBasis<d,T>::evalAllDers_into(const gsMatrix<T> & u, int n,
         return;
     }
 
+    // Points on a Cartesian grid
+    std::vector<gsVector<T> > coords;
+    if ( d > 1 && gsPointGridCoordinates(u, coords) )
+    {
+        evalAllDersGrid_into(coords, n, result);
+        return;
+    }
+
     std::vector< gsMatrix<T> >values[d];
     gsVector<unsigned, d> v, nb_cwise;
     result.resize(n+1);
@@ -731,6 +759,17 @@ void gsTensorBasis<d,T>::deriv2_into(const gsMatrix<T> & u,
                                            gsMatrix<T> & result ) const
 {
     std::vector< gsMatrix<T> >values[d];
+
+    // Points on a Cartesian grid
+    std::vector<gsVector<T> > coords;
+    if ( d > 1 && gsPointGridCoordinates(u, coords) )
+    {
+        for (short_t i = 0; i < d; ++i)
+            m_bases[i]->evalAllDers_into( coords[i].transpose(), 2, values[i] );
+        gridDers_into(values, 2, result);
+        return;
+    }
+
     gsVector<unsigned, d> v, nb_cwise;
 
     unsigned nb = 1;
@@ -792,6 +831,121 @@ void gsTensorBasis<d,T>::deriv2_tp(const std::vector< gsMatrix<T> > values[],
 }
 
 
+template<short_t d, class T>
+void gsTensorBasis<d,T>::evalAllDersGrid_into(const std::vector<gsVector<T> > & coords, int n,
+                                              std::vector<gsMatrix<T> >& result) const
+{
+    GISMO_ASSERT( coords.size() == static_cast<size_t>(d),
+                  "Expecting one coordinate vector per direction." );
+    GISMO_ASSERT(n>-2, "gsTensorBasis::evalAllDersGrid() is implemented only for n>-2: -1 means no value, 0 values only, ... " );
+
+    // Evaluate every univariate basis once per coordinate
+    std::vector< gsMatrix<T> > values[d];
+    for (short_t i = 0; i < d; ++i)
+        m_bases[i]->evalAllDers_into( coords[i].transpose(), n, values[i] );
+
+    result.resize(n+1);
+    for (int k = 0; k <= n; ++k)
+        gridDers_into(values, k, result[k]);
+}
+
+template<short_t d, class T>
+void gsTensorBasis<d,T>::gridDers_into(const std::vector< gsMatrix<T> > values[],
+                                       const int k, gsMatrix<T>& result)
+{
+    index_t nb = 1, np = 1;
+    const gsMatrix<T> * f[d];
+    for (short_t i = 0; i < d; ++i)
+    {
+        nb *= values[i][0].rows();
+        np *= values[i][0].cols();
+        f[i] = &values[i][0];
+    }
+
+    if (0 == k) // values
+    {
+        result.resize(nb, np);
+        gridProduct_into(f, result, 1, 0);
+    }
+    else if (1 == k) // gradients
+    {
+        result.resize(d*nb, np);
+        for (short_t i = 0; i < d; ++i)
+        {
+            f[i] = &values[i][1];
+            gridProduct_into(f, result, d, i);
+            f[i] = &values[i][0];
+        }
+    }
+    else if (2 == k) // pure second derivatives, then the mixed ones in lex order
+    {
+        const index_t stride = d + d*(d-1)/2;
+        result.resize(stride*nb, np);
+        index_t m = d;
+        for (short_t i = 0; i < d; ++i)
+        {
+            f[i] = &values[i][2];
+            gridProduct_into(f, result, stride, i);
+            f[i] = &values[i][1];
+            for (short_t l = i+1; l < d; ++l)
+            {
+                f[l] = &values[l][1];
+                gridProduct_into(f, result, stride, m++);
+                f[l] = &values[l][0];
+            }
+            f[i] = &values[i][0];
+        }
+    }
+    else // all partial derivatives of order k, as compositions of k
+    {
+        const index_t stride = numCompositions(k, d);
+        result.resize(stride*nb, np);
+        gsVector<unsigned, d> cc;
+        firstComposition(k, d, cc);
+        index_t m = 0;
+        do
+        {
+            for (short_t i = 0; i < d; ++i)
+                f[i] = &values[i][cc[i]];
+            gridProduct_into(f, result, stride, m++);
+        } while (nextComposition(cc));
+    }
+}
+
+template<short_t d, class T>
+void gsTensorBasis<d,T>::gridProduct_into(const gsMatrix<T> * f[], gsMatrix<T>& result,
+                                          const index_t stride, const index_t offset)
+{
+    // Kronecker product f[d-1] x ... x f[1] x f[0], built up one
+    // direction at a time, so every entry costs one multiplication
+    gsMatrix<T> cur, next;
+    if (1 == d)
+        cur.setOnes(1,1);
+    else
+        cur = *f[0];
+    for (short_t i = 1; i + 1 < d; ++i)
+    {
+        const gsMatrix<T> & fi = *f[i];
+        next.resize(cur.rows() * fi.rows(), cur.cols() * fi.cols());
+        for (index_t j = 0; j < fi.cols(); ++j)
+            for (index_t v = 0; v < fi.rows(); ++v)
+                next.block(v * cur.rows(), j * cur.cols(), cur.rows(), cur.cols()).noalias()
+                    = fi(v,j) * cur;
+        cur.swap(next);
+    }
+
+    // The last direction is written into every stride-th row of result
+    typedef Eigen::Stride<Eigen::Dynamic,Eigen::Dynamic> Strides;
+    const gsMatrix<T> & fl = *f[d-1];
+    Eigen::Map<typename gsMatrix<T>::Base, 0, Strides>
+        out(result.data() + offset, cur.rows() * fl.rows(), cur.cols() * fl.cols(),
+            Strides(result.rows(), stride));
+    for (index_t j = 0; j < fl.cols(); ++j)
+        for (index_t v = 0; v < fl.rows(); ++v)
+            out.block(v * cur.rows(), j * cur.cols(), cur.rows(), cur.cols()).noalias()
+                = fl(v,j) * cur;
+}
+
 template<short_t d, class T>
 void gsTensorBasis<d,T>::refineElements(std::vector<index_t> const & elements)
 {
@@ -0,0 +1,163 @@
+/** @file gsBoundingBoxTree.h
+
+    @brief Provides a bounding volume hierarchy of axis-aligned boxes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+
+namespace gismo
+{
+
+/**
+   \brief A bounding volume hierarchy over a set of axis-aligned
+   boxes, for finding the boxes that contain a given point.
+
+   The tree is built once by splitting the boxes recursively at the
+   median of their centers, along the direction of largest extent.
+   The nodes are stored in a flat array.
+
+   \ingroup Utils
+*/
+template<class T>
+class gsBoundingBoxTree
+{
+public:
+
+    /// Builds the tree of the boxes whose lower and upper corners are
+    /// the columns of \a lower and \a upper
+    gsBoundingBoxTree(const gsMatrix<T> & lower, const gsMatrix<T> & upper,
+                      const index_t leafSize = 4)
+    : m_lower(lower), m_upper(upper), m_leafSize(leafSize)
+    {
+        GISMO_ASSERT(lower.rows() == upper.rows() && lower.cols() == upper.cols(),
+                     "Dimensions of the box corners do not match");
+        const index_t n = lower.cols();
+        m_perm.resize(n);
+        for (index_t i = 0; i != n; ++i)
+            m_perm[i] = i;
+        if ( 0 == n ) return;
+
+        m_nodes.reserve( 2 * n / m_leafSize + 1 );
+        m_nodes.push_back( Node() );
+        m_nlower.resize(lower.rows(), 2 * n);
+        m_nupper.resize(lower.rows(), 2 * n);
+        build(0, 0, n);
+        m_nlower.conservativeResize(Eigen::NoChange, m_nodes.size());
+        m_nupper.conservativeResize(Eigen::NoChange, m_nodes.size());
+    }
+
+    /// Returns the number of boxes
+    index_t size() const { return m_lower.cols(); }
+
+    /// Returns the number of nodes of the tree
+    index_t numNodes() const { return m_nodes.size(); }
+
+    /// Appends to \a result the indices of the boxes which contain
+    /// the point \a pt
+    template<class Derived>
+    void query(const Eigen::MatrixBase<Derived> & pt, std::vector<index_t> & result) const
+    {
+        if ( m_nodes.empty() ) return;
+        index_t stack[64]; // twice the maximum depth of a median split tree
+        index_t top = 0;
+        stack[top++] = 0;
+        while ( top )
+        {
+            const index_t c = stack[--top];
+            const Node & node = m_nodes[c];
+            if ( (pt.array() < m_nlower.col(c).array()).any() ||
+                 (pt.array() > m_nupper.col(c).array()).any() )
+                continue;
+
+            if ( -1 == node.child )
+            {
+                for (index_t i = node.first; i != node.last; ++i)
+                {
+                    const index_t b = m_perm[i];
+                    if ( (pt.array() >= m_lower.col(b).array()).all() &&
+                         (pt.array() <= m_upper.col(b).array()).all() )
+                        result.push_back(b);
+                }
+            }
+            else
+            {
+                stack[top++] = node.child;
+                stack[top++] = node.child + 1;
+            }
+        }
+    }
+
+private:
+
+    // Sets the box of node \a c to the boxes [first,last) and splits
+    // it if it holds more than m_leafSize boxes
+    void build(const index_t c, const index_t first, const index_t last)
+    {
+        m_nodes[c].first = first;
+        m_nodes[c].last  = last;
+        m_nodes[c].child = -1;
+
+        m_nlower.col(c) = m_lower.col(m_perm[first]);
+        m_nupper.col(c) = m_upper.col(m_perm[first]);
+        for (index_t i = first + 1; i != last; ++i)
+        {
+            m_nlower.col(c) = m_nlower.col(c).cwiseMin( m_lower.col(m_perm[i]) );
+            m_nupper.col(c) = m_nupper.col(c).cwiseMax( m_upper.col(m_perm[i]) );
+        }
+
+        if ( last - first <= m_leafSize )
+            return;
+
+        // Split at the median center along the longest direction
+        index_t dir;
+        (m_nupper.col(c) - m_nlower.col(c)).maxCoeff(&dir);
+        const index_t mid = first + (last - first) / 2;
+        std::nth_element(m_perm.begin() + first, m_perm.begin() + mid,
+                         m_perm.begin() + last, CenterLess(*this, dir));
+
+        const index_t child = m_nodes.size();
+        m_nodes[c].child = child;
+        m_nodes.resize(child + 2);
+        build(child    , first, mid );
+        build(child + 1, mid  , last);
+    }
+
+    struct Node
+    {
+        index_t child; // index of the first child, the second is next to it, -1 for leaves
+        index_t first, last; // range of boxes in m_perm
+    };
+
+    struct CenterLess
+    {
+        CenterLess(const gsBoundingBoxTree & tree, const index_t dir)
+        : m_tree(tree), m_dir(dir) { }
+
+        bool operator()(const index_t a, const index_t b) const
+        {
+            return m_tree.m_lower(m_dir, a) + m_tree.m_upper(m_dir, a) <
+                m_tree.m_lower(m_dir, b) + m_tree.m_upper(m_dir, b);
+        }
+
+        const gsBoundingBoxTree & m_tree;
+        index_t m_dir;
+    };
+
+private:
+
+    gsMatrix<T> m_lower, m_upper;   // the boxes
+    gsMatrix<T> m_nlower, m_nupper; // the boxes of the nodes
+    std::vector<index_t> m_perm;    // boxes sorted by node
+    std::vector<Node> m_nodes;
+    index_t m_leafSize;
+};
+
+} // namespace gismo
@@ -110,6 +110,57 @@ gsMatrix<T> gsPointGrid(CwiseContainer const & cwise)
     return rvo;
 }
 
+/// @brief Recovers the coordinate vectors \a cwise of a Cartesian grid
+/// of points \a pts, i.e., the inverse of gsPointGrid(cwise, pts).
+///
+/// The points must be ordered lexicographically, with the first
+/// coordinate running fastest, and coincide exactly with the grid
+/// values, as is the case for tensor-product quadrature nodes.
+/// Returns false (and leaves \a cwise in an unspecified state) if \a
+/// pts is not such a grid.
+template<class T>
+bool gsPointGridCoordinates(gsMatrix<T> const & pts, std::vector<gsVector<T> > & cwise)
+{
+    const index_t d = pts.rows(), np = pts.cols();
+    if (0 == np)
+        return false;
+    cwise.resize(d);
+
+    // The number of points in direction i is the number of steps of
+    // size stride (the product of the preceding numbers) before a
+    // coordinate of a later direction changes
+    index_t stride = 1;
+    for (index_t i = 0; i < d; ++i)
+    {
+        index_t n = 1;
+        if (i + 1 == d)
+            n = np / stride;
+        else
+            while ( n * stride < np &&
+                    pts.col(n * stride).tail(d-i-1) == pts.col(0).tail(d-i-1) )
+                ++n;
+
+        cwise[i].resize(n);
+        for (index_t j = 0; j < n; ++j)
+            cwise[i][j] = pts(i, j * stride);
+        stride *= n;
+    }
+    if (stride != np)
+        return false;
+
+    // Check all points against the grid
+    stride = 1;
+    for (index_t i = 0; i < d; ++i)
+    {
+        const index_t n = cwise[i].size();
+        for (index_t c = 0; c < np; ++c)
+            if ( pts(i,c) != cwise[i][(c / stride) % n] )
+                return false;
+        stride *= n;
+    }
+    return true;
+}
+
 
 } // namespace gismo
 
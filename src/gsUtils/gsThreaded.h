@@ -50,6 +50,9 @@ public:
 
     /// Assigning to the local data
     C& operator = (C other) { return m_array[omp_get_thread_num()] = give(other); }
+
+    /// Returns the number of copies of the data
+    size_t size() const { return m_array.size(); }
 #else
     /// Casting to the local data
     operator C&()             { return m_c; }
@@ -61,6 +64,9 @@ public:
     
     /// Assigning to the local data
     C& operator = (C other) { return m_c = give(other); }
+
+    /// Returns the number of copies of the data
+    size_t size() const { return 1; }
 #endif
     
 };//gsThreaded
@@ -0,0 +1,104 @@
+/** @file gsBSplineBasis_test.cpp
+
+    @brief Tests the evaluation of univariate B-spline bases
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "gismo_unittest.h"
+
+SUITE(gsBSplineBasis_test)
+{
+
+TEST(evalAllDers_kernels)
+{
+    // Evaluation points inside the elements, so that the central
+    // differences below stay within one knot span
+    gsMatrix<> u(1,5);
+    u << 0.05, 0.3, 0.45, 0.7, 0.95;
+    const real_t h = 1e-5;
+    gsMatrix<> up = u.array() + h, um = u.array() - h;
+
+    for (index_t p = 1; p <= 8; ++p)
+    {
+        gsKnotVector<> kv(0, 1, 4, p+1); // 5 uniform knot spans
+        gsBSplineBasis<> basis(kv);
+
+        std::vector<gsMatrix<> > ev, evp, evm;
+        basis.evalAllDers_into(u , 3, ev );
+        basis.evalAllDers_into(up, 3, evp);
+        basis.evalAllDers_into(um, 3, evm);
+
+        // Partition of unity
+        CHECK( (ev[0].colwise().sum().array() - 1).abs().maxCoeff() < 1e-12 );
+        for (index_t k = 1; k <= 3; ++k)
+            CHECK( ev[k].colwise().sum().cwiseAbs().maxCoeff() < 1e-8 );
+
+        // Every derivative is the derivative of the previous order
+        for (index_t k = 1; k <= 3; ++k)
+        {
+            gsMatrix<> fd = (evp[k-1] - evm[k-1]) / (2*h);
+            CHECK( (fd - ev[k]).cwiseAbs().maxCoeff()
+                   < 1e-4 * (1 + ev[k].cwiseAbs().maxCoeff()) );
+        }
+
+        // The single evaluation functions agree
+        gsMatrix<> vals, ders, ders2;
+        basis.eval_into(u, vals);
+        basis.deriv_into(u, ders);
+        basis.deriv2_into(u, ders2);
+        CHECK( (vals  - ev[0]).cwiseAbs().maxCoeff() < 1e-12 );
+        CHECK( (ders  - ev[1]).cwiseAbs().maxCoeff() < 1e-10 * (1 + ev[1].cwiseAbs().maxCoeff()) );
+        CHECK( (ders2 - ev[2]).cwiseAbs().maxCoeff() < 1e-10 * (1 + ev[2].cwiseAbs().maxCoeff()) );
+    }
+
+    // Points outside the domain give zero values
+    gsBSplineBasis<> basis(gsKnotVector<>(0, 1, 3, 4));
+    gsMatrix<> out(1,2);
+    out << -0.5, 1.5;
+    std::vector<gsMatrix<> > ev;
+    basis.evalAllDers_into(out, 2, ev);
+    for (index_t k = 0; k <= 2; ++k)
+        CHECK( ev[k].isZero() );
+}
+
+TEST(evalAllDers_tensorGrid)
+{
+    gsKnotVector<> kv(0, 1, 3, 4);
+    gsTensorBSplineBasis<3> basis(kv, kv, kv);
+
+    // Quadrature nodes of one element form a Cartesian grid
+    gsGaussRule<> rule(basis, 1, 1);
+    gsVector<> lo(3), up(3);
+    lo << 0.25, 0.5, 0; up << 0.5, 0.75, 0.25;
+    gsMatrix<> nodes;
+    gsVector<> weights;
+    rule.mapTo(lo, up, nodes, weights);
+
+    std::vector<gsVector<> > coords;
+    CHECK( gsPointGridCoordinates(nodes, coords) );
+    CHECK( 3 == (index_t)coords.size() && 4 == coords[1].size() );
+    CHECK( gsPointGrid<real_t>(coords) == nodes );
+
+    // Swapping two points destroys the grid structure
+    gsMatrix<> scattered = nodes;
+    scattered.col(0).swap(scattered.col(1));
+    CHECK( !gsPointGridCoordinates(scattered, coords) );
+
+    // Grid and point-wise evaluation agree
+    std::vector<gsMatrix<> > evg, evs;
+    basis.evalAllDers_into(nodes, 3, evg);
+    basis.evalAllDers_into(scattered, 3, evs);
+    for (index_t k = 0; k <= 3; ++k)
+    {
+        evs[k].col(0).swap(evs[k].col(1));
+        CHECK( evg[k].rows() == evs[k].rows() );
+        CHECK( (evg[k] - evs[k]).cwiseAbs().maxCoeff() < 1e-12 * (1 + evs[k].cwiseAbs().maxCoeff()) );
+    }
+}
+
+}
@@ -41,4 +41,66 @@ SUITE(gsExprAssembler_test)
                     const real_t v = ev.value();
                     CHECK( v*v < 1e-10 );
                 }
+
+         TEST(ParallelAssembly)
+                {
+                    // The parallel element loop must give the same
+                    // system as the sequential one, bit by bit, and
+                    // agree with the visitor-based assembler
+                    gsMultiPatch<> patches = gsNurbsCreator<>::BSplineSquareGrid(2,2,0.5);
+                    gsMultiBasis<> mb(patches);
+                    mb.setDegree(3);
+                    mb.uniformRefine();
+                    mb.uniformRefine();
+
+                    gsFunctionExpr<> ff("2*pi^2*sin(pi*x)*sin(pi*y)", 2);
+                    gsFunctionExpr<> gg("sin(pi*x)*sin(pi*y)", 2);
+                    gsBoundaryConditions<> bc;
+                    for (gsMultiPatch<>::const_biterator
+                             bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+                        bc.addCondition(*bit, condition_type::neumann, &gg);
+                    bc.setGeoMap(patches);
+
+                    gsSparseMatrix<> K[2], S[2];
+                    gsMatrix<>       f[2], fv[2];
+                    for (index_t i = 0; i!=2; ++i)
+                    {
+                        gsExprAssembler<> A(1,1);
+                        A.options().setSwitch("Parallel", 1==i);
+                        A.setIntegrationElements(mb);
+                        gsExprAssembler<>::geometryMap G = A.getMap(patches);
+                        gsExprAssembler<>::space u = A.getSpace(mb);
+                        gsExprAssembler<>::variable f_ = A.getCoeff(ff, G);
+                        u.setup(bc, dirichlet::interpolation, 0);
+                        A.initSystem();
+
+                        A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G),
+                                    u * f_ * meas(G) );
+                        S[i]  = A.matrix();
+                        fv[i] = A.rhs();
+                        gsExprAssembler<>::variable g_N = A.getBdrFunction();
+                        A.assembleRhsBc(u * g_N.val() * nv(G).norm(), bc.neumannSides() );
+                        A.assembleInterface( u * u.tr() * nv(G).norm() );
+
+                        K[i] = A.matrix();
+                        f[i] = A.rhs();
+                    }
+
+                    // Reference stiffness matrix and load vector
+                    gsGenericAssembler<> ref(patches, mb,
+                                             gsGenericAssembler<>::defaultOptions(), &bc);
+                    const gsMatrix<> Sref = ref.assembleStiffness().toDense();
+                    const gsMatrix<> fref = ref.assembleMoments(ff);
+                    for (index_t i = 0; i!=2; ++i)
+                    {
+                        CHECK( (S[i].toDense() - Sref).norm() < 1e-10 * Sref.norm() );
+                        CHECK( (fv[i] - fref).norm() < 1e-10 * fref.norm() );
+                    }
+                    // The load integrates to the integral of ff over the unit square
+                    CHECK_CLOSE( fref.sum(), (real_t)8, 1e-6 );
+
+                    CHECK( K[0].nonZeros() == K[1].nonZeros() );
+                    CHECK( (K[0].toDense() - K[1].toDense()).cwiseAbs().maxCoeff() == 0 );
+                    CHECK( (f[0] - f[1]).cwiseAbs().maxCoeff() == 0 );
+                }
         }
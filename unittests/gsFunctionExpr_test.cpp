@@ -0,0 +1,108 @@
+/** @file gsFunctionExpr_test.cpp
+
+    @brief Tests the evaluation of gsFunctionExpr by the interpreter,
+    concurrently, and by the compiled kernels.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+**/
+
+#include "gismo_unittest.h"
+
+SUITE(gsFunctionExpr_test)
+{
+
+TEST(concurrent_eval)
+{
+    gsFunctionExpr<real_t> f("sin(pi*x)*cos(y)+t", "x^2*y", 2);
+    f.set_t(1);
+
+    gsMatrix<real_t> pts(2, 20);
+    for (index_t i = 0; i != pts.size(); ++i)
+        pts.at(i) = (real_t)(i) / (real_t)(pts.size());
+
+    gsMatrix<real_t> ref;
+    f.eval_into(pts, ref);
+
+    // Every thread evaluates on its own copy of the parsed expressions
+    gsMatrix<real_t> val(2, 40);
+#   pragma omp parallel for
+    for (index_t k = 0; k < 40; ++k)
+    {
+        gsMatrix<real_t> tmp;
+        f.eval_into(pts.col(k % 20), tmp);
+        val.col(k) = tmp;
+    }
+    CHECK( val.leftCols(20) == ref );
+    CHECK( val.rightCols(20) == ref );
+
+    // Nested regions, whether the inner ones are active or not
+    val.setZero();
+#   pragma omp parallel for
+    for (index_t k = 0; k < 4; ++k)
+    {
+#       pragma omp parallel for
+        for (index_t j = 0; j < 10; ++j)
+        {
+            gsMatrix<real_t> tmp;
+            f.eval_into(pts.col((10 * k + j) % 20), tmp);
+            val.col(10 * k + j) = tmp;
+        }
+    }
+    CHECK( val.leftCols(20) == ref );
+    CHECK( val.rightCols(20) == ref );
+}
+
+TEST(compiled_kernels)
+{
+    gsFunctionExpr<real_t> f("sin(pi*x)*exp(-y)+t*x^3", "atan2(y,x)/sqrt(1+x*y)", 2);
+    f.set_t(2);
+
+    gsMatrix<real_t> pts(2, 7);
+    pts << 0.1, 0.2, 0.3, 0.5, 0.7, 0.8, 0.9,
+           0.9, 0.4, 0.6, 0.5, 0.2, 0.1, 0.3;
+
+    gsMatrix<real_t> v0, d0, h0, v1, d1, h1;
+    f.eval_into  (pts, v0);
+    f.deriv_into (pts, d0);
+    f.deriv2_into(pts, h0);
+
+    if ( !f.compile() ) // no runtime compiler available
+        return;
+    CHECK(f.isCompiled());
+
+    f.eval_into  (pts, v1);
+    f.deriv_into (pts, d1);
+    f.deriv2_into(pts, h1);
+
+    // The interpreter uses finite differences for the derivatives
+    CHECK( (v1 - v0).cwiseAbs().maxCoeff() < 1e-10 );
+    CHECK( (d1 - d0).cwiseAbs().maxCoeff() < 1e-5  );
+    CHECK( (h1 - h0).cwiseAbs().maxCoeff() < 1e-3  );
+
+    // Exact derivatives of the first component
+    for (index_t p = 0; p != pts.cols(); ++p)
+    {
+        const real_t x = pts(0,p), y = pts(1,p);
+        CHECK_CLOSE( EIGEN_PI*math::cos(EIGEN_PI*x)*math::exp(-y) + 6*x*x, d1(0,p), 1e-12);
+        CHECK_CLOSE(-math::sin(EIGEN_PI*x)*math::exp(-y), d1(1,p), 1e-12);
+        CHECK_CLOSE(-EIGEN_PI*EIGEN_PI*math::sin(EIGEN_PI*x)*math::exp(-y) + 12*x, h1(0,p), 1e-11);
+        CHECK_CLOSE( math::sin(EIGEN_PI*x)*math::exp(-y), h1(1,p), 1e-12);
+        CHECK_CLOSE(-EIGEN_PI*math::cos(EIGEN_PI*x)*math::exp(-y), h1(2,p), 1e-12);
+    }
+
+    // Parameters are read at evaluation time
+    f.set_t(0);
+    f.eval_into(pts, v1);
+    CHECK_CLOSE(math::sin(EIGEN_PI*0.1)*math::exp(-0.9), v1(0,0), 1e-12);
+
+    // Unsupported syntax falls back to the interpreter
+    gsFunctionExpr<real_t> g("if(x<0.5,x,1-x)", 1);
+    CHECK(!g.compile());
+    CHECK(!g.isCompiled());
+}
+
+}
@@ -47,6 +47,26 @@ void poissonDiscretization(gsSparseMatrix<> &mat, gsMatrix<> &rhs, index_t N)
     mat.makeCompressed();
 }
 
+//Several right-hand sides: the Poisson rhs, a constant and a zero column
+gsMatrix<> multipleRhs(const gsMatrix<> &rhs)
+{
+    gsMatrix<> result(rhs.rows(), 3);
+    result.col(0) = rhs;
+    result.col(1).setOnes();
+    result.col(2).setZero();
+    return result;
+}
+
+//The largest relative residual of the columns
+real_t columnwiseError(const gsSparseMatrix<> &mat, const gsMatrix<> &rhs, const gsMatrix<> &x)
+{
+    const gsMatrix<> res = mat*x-rhs;
+    real_t result = res.col(2).norm(); // zero column
+    for (index_t j = 0; j < 2; ++j)
+        result = math::max(result, res.col(j).norm()/rhs.col(j).norm());
+    return result;
+}
+
 SUITE(gsIterativeSolvers_test)
 {
 
@@ -327,4 +347,241 @@ SUITE(gsIterativeSolvers_test)
         CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
     }
 
+    TEST(Gradient_multiple_rhs_test)
+    {
+        index_t          N = 10;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.25);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+        rhs = multipleRhs(rhs);
+
+        gsGradientMethod<> solver(mat);
+        solver.setMaxIterations(400);
+        solver.setTolerance(tol);
+
+        x.setZero(N,3);
+        solver.solve(rhs,x);
+
+        CHECK( columnwiseError(mat, rhs, x) <= tol );
+    }
+
+    TEST(CG_multiple_rhs_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+        rhs = multipleRhs(rhs);
+
+        gsConjugateGradient<> solver(mat, makeJacobiOp(mat));
+        solver.setMaxIterations(N);
+        solver.setTolerance(tol);
+
+        x.setZero(N,3);
+        solver.solve(rhs,x);
+
+        CHECK( columnwiseError(mat, rhs, x) <= tol );
+        CHECK( solver.iterations() <= N );
+    }
+
+    TEST(MinRes_multiple_rhs_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+        rhs = multipleRhs(rhs);
+
+        gsMinimalResidual<> solver(mat);
+        solver.setMaxIterations(N);
+        solver.setTolerance(tol);
+
+        x.setZero(N,3);
+        solver.solve(rhs,x);
+
+        CHECK( columnwiseError(mat, rhs, x) <= tol );
+    }
+
+    TEST(GMRes_multiple_rhs_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+        rhs = multipleRhs(rhs);
+
+        gsGMRes<> solver(mat);
+        solver.setMaxIterations(N);
+        solver.setTolerance(tol);
+
+        // Nonzero initial guess
+        x.setOnes(N,3);
+        solver.solve(rhs,x);
+
+        CHECK( columnwiseError(mat, rhs, x) <= tol );
+    }
+
+    TEST(CG_MultiColorGS_test)
+    {
+        index_t          N = 30;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat1, mat;
+        gsMatrix<>       rhs1, rhs;
+        gsMatrix<>       x;
+
+        // Tensor-product matrix with a 9-point stencil: stiffness times mass
+        // plus mass times stiffness, as for bilinear splines
+        poissonDiscretization(mat1, rhs1, N);
+        gsSparseEntries<> entries;
+        for (index_t k1 = 0; k1 < mat1.outerSize(); ++k1)
+            for (gsSparseMatrix<>::InnerIterator it1(mat1,k1); it1; ++it1)
+                for (index_t k2 = 0; k2 < mat1.outerSize(); ++k2)
+                    for (gsSparseMatrix<>::InnerIterator it2(mat1,k2); it2; ++it2)
+                    {
+                        const real_t m1 = it1.row()==it1.col() ? 4./6 : 1./6;
+                        const real_t m2 = it2.row()==it2.col() ? 4./6 : 1./6;
+                        entries.add( it1.row()*N+it2.row(), it1.col()*N+it2.col(),
+                                     it1.value()*m2 + m1*it2.value() );
+                    }
+        mat.resize(N*N,N*N);
+        mat.setFrom(entries);
+        mat.makeCompressed();
+        rhs.setOnes(N*N,1);
+
+        typedef gsMultiColorGaussSeidelOp<gsSparseMatrix<>,gsGaussSeidel::symmetric> MCGS;
+        MCGS::Ptr precon = MCGS::make(mat);
+        CHECK( precon->numColors() <= 9 );
+
+        gsConjugateGradient<> solver(mat,precon);
+        solver.setMaxIterations(N*N);
+        solver.setTolerance(tol);
+        x.setZero(N*N,1);
+        solver.solve(rhs,x);
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
+
+        // The number of iterations is close to the one of the sequential sweep
+        gsConjugateGradient<> solver2(mat,makeSymmetricGaussSeidelOp(mat));
+        solver2.setMaxIterations(N*N);
+        solver2.setTolerance(tol);
+        x.setZero(N*N,1);
+        solver2.solve(rhs,x);
+        CHECK( solver.iterations() <= 2 * solver2.iterations() );
+    }
+
+    TEST(CG_Chebyshev_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+
+        // The spectrum of the Jacobi preconditioned matrix is in (0,2)
+        gsChebyshevOp<gsSparseMatrix<> >::Ptr precon = gsChebyshevOp<gsSparseMatrix<> >::make(mat, 4, 0);
+        CHECK( precon->maxEigenvalue() > 1.8 && precon->maxEigenvalue() < 2.3 );
+        CHECK( precon->minEigenvalue() > 0 && precon->minEigenvalue() < precon->maxEigenvalue() );
+
+        gsConjugateGradient<> solver(mat,precon);
+        solver.setMaxIterations(N);
+        solver.setTolerance(tol);
+
+        x.setZero(N,1);
+        solver.solve(rhs,x);
+
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
+        CHECK( solver.iterations() < N/2 );
+    }
+
+    TEST(MixedPrecision_refinement_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+
+        poissonDiscretization(mat, rhs, N);
+        rhs = multipleRhs(rhs);
+
+        gsMixedPrecisionSolver<> solver(mat);
+        solver.setTolerance(tol);
+        gsMatrix<> x = solver.solve(rhs);
+
+        CHECK( solver.succeed() );
+        CHECK( !solver.usesFullPrecision() );
+        CHECK( solver.iterations() > 0 && solver.iterations() <= 5 );
+        CHECK( columnwiseError(mat, rhs, x) <= tol );
+    }
+
+    TEST(MixedPrecision_GMRES_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+
+        poissonDiscretization(mat, rhs, N);
+        rhs = multipleRhs(rhs);
+
+        gsMixedPrecisionSolver<real_t, float, gsEigenSimplicialLDLT> solver(mat);
+        solver.setMethod(gsMixedPrecisionSolver<real_t, float, gsEigenSimplicialLDLT>::gmres);
+        solver.setTolerance(tol);
+        gsMatrix<> x = solver.solve(rhs);
+
+        CHECK( solver.succeed() );
+        CHECK( !solver.usesFullPrecision() );
+        CHECK( columnwiseError(mat, rhs, x) <= tol );
+    }
+
+    TEST(MixedPrecision_fallback_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+
+        poissonDiscretization(mat, rhs, N);
+
+        // Stagnation: no refinement step can reduce the residual that much
+        gsOptionList opt = gsMixedPrecisionSolver<>::defaultOptions();
+        opt.setReal("Tolerance", tol);
+        opt.setReal("StagnationRatio", 1e-30);
+        gsMixedPrecisionSolver<> solver;
+        solver.setOptions(opt);
+        solver.compute(mat);
+        gsMatrix<> x = solver.solve(rhs);
+        CHECK( solver.usesFullPrecision() );
+        CHECK( solver.succeed() );
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
+
+        // Failure of the factorization: the scaled entries underflow in single precision
+        gsSparseMatrix<> scaled = mat * 1e-50;
+        solver.compute(scaled);
+        CHECK( solver.usesFullPrecision() );
+        x = solver.solve(rhs);
+        CHECK( solver.succeed() );
+        CHECK( (scaled*x-rhs).norm()/rhs.norm() <= tol );
+    }
 }
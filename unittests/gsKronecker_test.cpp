@@ -61,6 +61,74 @@ SUITE(gsKronecker_test)
         CHECK_EQUAL ( y, KP * x );
     }
 
+    // Kronecker product of two dense matrices, entry by entry
+    gsMatrix<> denseKron(const gsMatrix<> & X, const gsMatrix<> & Y)
+    {
+        gsMatrix<> result(X.rows() * Y.rows(), X.cols() * Y.cols());
+        for (index_t i = 0; i < X.rows(); ++i)
+            for (index_t j = 0; j < X.cols(); ++j)
+                result.block(i * Y.rows(), j * Y.cols(), Y.rows(), Y.cols()) = X(i,j) * Y;
+        return result;
+    }
+
+    TEST(gsKroneckerOp_threeFactors)
+    {
+        // Non-square factors and several columns; the operator is applied
+        // twice to check that the persistent buffers are reused correctly
+        gsMatrix<> C = (gsMatrix<>(2,4) <<
+                        1, -2, 0, 3,
+                        4,  1, 2, -1
+            ).finished();
+        gsMatrix<> Bt = B.transpose();
+        gsKroneckerOp<> kron( makeMatrixOp(A), makeMatrixOp(C), makeMatrixOp(Bt) );
+        const gsMatrix<> K = denseKron(denseKron(A, C), Bt);
+        CHECK_EQUAL( kron.rows(), K.rows() );
+        CHECK_EQUAL( kron.cols(), K.cols() );
+
+        gsMatrix<> x, y;
+        for (index_t k = 0; k < 2; ++k)
+        {
+            x.setRandom(K.cols(), 3);
+            kron.apply(x, y);
+            CHECK( (y - K * x).norm() <= 1e-12 * (K * x).norm() );
+        }
+    }
+
+    TEST(gsKroneckerOp_concurrent)
+    {
+        // Every thread applies the same object using its own buffers,
+        // also from nested regions
+        gsMatrix<> Bt = B.transpose();
+        gsKroneckerOp<> kron( makeMatrixOp(A), makeMatrixOp(Bt), makeMatrixOp(A) );
+        const gsMatrix<> K = denseKron(denseKron(A, Bt), A);
+
+        gsMatrix<> x(K.cols(), 16), y(K.rows(), 16), ref;
+        for (index_t c = 0; c != x.cols(); ++c)
+            for (index_t r = 0; r != x.rows(); ++r)
+                x(r, c) = math::sin((real_t)(r + 3 * c + 1));
+        ref = K * x;
+
+#       pragma omp parallel for
+        for (index_t c = 0; c < 8; ++c)
+        {
+            gsMatrix<> yc;
+            kron.apply(x.col(c), yc);
+            y.col(c) = yc;
+        }
+#       pragma omp parallel for
+        for (index_t k = 0; k < 2; ++k)
+        {
+#           pragma omp parallel for
+            for (index_t c = 8 + 4 * k; c < 12 + 4 * k; ++c)
+            {
+                gsMatrix<> yc;
+                kron.apply(x.col(c), yc);
+                y.col(c) = yc;
+            }
+        }
+        CHECK( (y - ref).norm() <= 1e-12 * ref.norm() );
+    }
+
     TEST(DenseKronecker)
     {        
         gsMatrix<> C = A.kron(B);
@@ -0,0 +1,72 @@
+/** @file gsMatrixFreeOp_test.cpp
+
+    @brief Tests the matrix-free operator against the assembled matrix
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "gismo_unittest.h"
+
+namespace {
+
+// Compares the operator with the matrix assembled with the same dof mapper
+void checkMatrixFree(const gsMultiPatch<real_t> & mp, const gsMultiBasis<real_t> & mb,
+                     real_t alpha, real_t beta)
+{
+    gsBoundaryConditions<> bc;
+    gsConstantFunction<> zero(0.0, mp.parDim());
+    for (gsMultiPatch<>::const_biterator bit = mp.bBegin(); bit != mp.bEnd(); ++bit)
+        if ( bit->side().index() == 1 )
+            bc.addCondition(*bit, condition_type::dirichlet, &zero);
+
+    gsGenericAssembler<> assembler(mp, mb, gsGenericAssembler<>::defaultOptions(), &bc);
+    gsSparseMatrix<> K = assembler.assembleStiffness();
+    gsSparseMatrix<> M = assembler.assembleMass();
+    K = beta * K + alpha * M;
+
+    gsDofMapper mapper;
+    mb.getMapper(dirichlet::elimination, iFace::glue, bc, mapper, 0);
+
+    gsMatrixFreeOp<real_t> op(mp, mb, mapper, alpha, beta);
+    CHECK_EQUAL( K.rows(), op.rows() );
+
+    gsMatrix<> x, y;
+    x.setRandom(K.rows(), 2);
+    op.apply(x, y);
+    CHECK( (y - K * x).norm() < 1e-10 * (K * x).norm() );
+
+    gsMatrix<> diag;
+    op.diagonal_into(diag);
+    CHECK( (diag - K.diagonal()).norm() < 1e-10 * diag.norm() );
+}
+
+}
+
+SUITE(gsMatrixFreeOp_test)
+{
+
+TEST(multiPatch2d)
+{
+    gsMultiPatch<> mp(*gsNurbsCreator<>::BSplineQuarterAnnulus(2));
+    mp = mp.uniformSplit();
+    gsMultiBasis<> mb(mp);
+    mb.setDegree(3);
+    mb.uniformRefine();
+    checkMatrixFree(mp, mb, 0, 1);
+    checkMatrixFree(mp, mb, 2, 0.5);
+}
+
+TEST(singlePatch3d)
+{
+    gsMultiPatch<> mp(*gsNurbsCreator<>::BSplineCube(2));
+    mp.patch(0).coefs().col(0).array() += mp.patch(0).coefs().col(1).array().square();
+    gsMultiBasis<> mb(mp);
+    mb.uniformRefine();
+    checkMatrixFree(mp, mb, 1, 1);
+}
+
+}
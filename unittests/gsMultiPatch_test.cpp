@@ -0,0 +1,77 @@
+/** @file gsMultiPatch_test.cpp
+
+    @brief Tests the location of points in a multipatch
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+**/
+
+#include "gismo_unittest.h"
+
+SUITE(gsMultiPatch_test)
+{
+
+TEST(boundingBoxTree)
+{
+    // Unit boxes along the diagonal, each containing the point (i,i)
+    gsMatrix<real_t> lower(2, 100), upper(2, 100);
+    for (index_t i = 0; i != 100; ++i)
+    {
+        lower.col(i).setConstant(i - (real_t)(0.5));
+        upper.col(i).setConstant(i + (real_t)(0.5));
+    }
+    gsBoundingBoxTree<real_t> tree(lower, upper);
+    CHECK_EQUAL( 100, tree.size() );
+
+    std::vector<index_t> result;
+    gsVector<real_t> pt(2);
+    pt << 42, 42.25;
+    tree.query(pt, result);
+    CHECK_EQUAL( 1u, result.size() );
+    CHECK_EQUAL( 42, result.front() );
+
+    result.clear();
+    pt << 42, 45;
+    tree.query(pt, result);
+    CHECK( result.empty() );
+}
+
+TEST(locatePoints)
+{
+    gsMultiPatch<real_t> mp0(*gsNurbsCreator<real_t>::NurbsQuarterAnnulus());
+    gsMultiPatch<real_t> mp = mp0.uniformSplit();
+    mp.patch(1).uniformRefine(3);
+    CHECK_EQUAL( 4u, mp.nPatches() );
+
+    // Points in the interior of the patches
+    gsMatrix<real_t> par(2, 8), points(2, 9);
+    par << 0.1, 0.3, 0.7, 0.9, 0.25, 0.5, 0.75, 0.6,
+           0.2, 0.9, 0.4, 0.6, 0.45, 0.1, 0.55, 0.35;
+    std::vector<index_t> pid(9, -1);
+    for (index_t i = 0; i != 8; ++i)
+    {
+        pid[i] = i % 4;
+        const gsMatrix<real_t> pr = mp.patch(pid[i]).parameterRange();
+        const gsMatrix<real_t> u = pr.col(0).array()
+            + par.col(i).array() * (pr.col(1) - pr.col(0)).array();
+        points.col(i) = mp.patch(pid[i]).eval(u);
+    }
+    // ..and one outside of the domain
+    points.col(8) << 0, 0;
+
+    gsVector<index_t> pids;
+    gsMatrix<real_t> preim;
+    mp.locatePoints(points, pids, preim);
+    CHECK_EQUAL( 9, pids.size() );
+    for (index_t i = 0; i != 8; ++i)
+    {
+        CHECK_EQUAL( pid[i], pids[i] );
+        CHECK( (mp.patch(pids[i]).eval(preim.col(i)) - points.col(i)).norm() < 1e-5 );
+    }
+    CHECK_EQUAL( -1, pids[8] );
+}
+
+}
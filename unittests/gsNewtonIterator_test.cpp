@@ -0,0 +1,109 @@
+/** @file gsNewtonIterator_test.cpp
+
+    @brief Tests the strategies of gsNewtonIterator for the linear systems
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "gismo_unittest.h"
+#include <gsPde/gsNewtonIterator.h>
+
+namespace
+{
+
+// Assembles the Newton system of K u + u^3 = f, where K u = f is the
+// discretized Poisson problem and the cubic term acts on the
+// coefficients of the free dofs
+class gsCubicAssembler : public gsPoissonAssembler<real_t>
+{
+    typedef gsPoissonAssembler<real_t> Base;
+
+public:
+    gsCubicAssembler(const gsMultiPatch<real_t> & mp, const gsMultiBasis<real_t> & mb,
+                     const gsBoundaryConditions<real_t> & bc, const gsFunction<real_t> & f)
+    : Base(mp, mb, bc, f)
+    { }
+
+    using Base::assemble;
+
+    void assemble(const gsMultiPatch<real_t> & curSolution)
+    {
+        // Start from an empty system, assemble() adds to the matrix
+        Base::refresh();
+        Base::assemble();
+
+        const gsDofMapper & mapper = m_system.colMapper(0);
+        const gsMatrix<real_t> & coefs = curSolution.patch(0).coefs();
+        gsMatrix<real_t> u(mapper.freeSize(), 1);
+        for (index_t i = 0; i != coefs.rows(); ++i)
+            if ( mapper.is_free(i, 0) )
+                u(mapper.index(i, 0), 0) = coefs(i, 0);
+
+        gsSparseMatrix<real_t> & J = m_system.matrix();
+        m_system.rhs() -= J * u + u.array().cube().matrix();
+        for (index_t i = 0; i != u.rows(); ++i)
+            J.coeffRef(i, i) += 3 * u(i, 0) * u(i, 0);
+    }
+};
+
+}
+
+SUITE(gsNewtonIterator_test)
+{
+
+TEST(strategies)
+{
+    gsMultiPatch<> mp( *gsNurbsCreator<>::BSplineSquare() );
+    gsMultiBasis<> mb(mp);
+    mb.uniformRefine(3);
+
+    gsConstantFunction<> zero(0.0, 2), f(20.0, 2);
+    gsBoundaryConditions<> bc;
+    for (gsMultiPatch<>::const_biterator bit = mp.bBegin(); bit != mp.bEnd(); ++bit)
+        bc.addCondition(*bit, condition_type::dirichlet, &zero);
+
+    // 0: Newton, 1: reused pattern, 2: modified Newton, 3: inexact Newton
+    gsMatrix<> sol[4];
+    index_t numFact[4], numIter[4];
+    for (index_t k = 0; k != 4; ++k)
+    {
+        gsCubicAssembler assembler(mp, mb, bc, f);
+        gsNewtonIterator<real_t> newton(assembler);
+        newton.setTolerance(1e-10);
+        if ( 1 == k )
+            newton.setReusePattern(true);
+        else if ( 2 == k )
+            newton.setRefactorizationInterval(3);
+        else if ( 3 == k )
+        {
+            newton.setInexactNewton(true);
+            newton.setRefactorizationInterval(100);
+        }
+        newton.solve();
+
+        CHECK( newton.converged() );
+        sol[k] = newton.solution().patch(0).coefs();
+        numFact[k] = newton.numFactorizations();
+        numIter[k] = newton.numIterations();
+    }
+
+    // The solution is not trivial
+    CHECK( sol[0].maxCoeff() > 0.5 );
+
+    for (index_t k = 1; k != 4; ++k)
+        CHECK( (sol[k] - sol[0]).norm() < 1e-8 * sol[0].norm() );
+
+    // Pattern reuse only skips the analysis
+    CHECK_EQUAL( numIter[0], numIter[1] );
+    CHECK_EQUAL( numFact[0], numFact[1] );
+
+    // Modified and inexact Newton save factorizations
+    CHECK( numFact[2] < numFact[0] );
+    CHECK( numFact[3] < numFact[0] );
+}
+
+}
@@ -0,0 +1,146 @@
+/** @file gsParaviewFormat_test.cpp
+
+    @brief Tests the encodings of the data arrays of Paraview files
+    and the concurrent export of multi-patch objects
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+**/
+
+#include "gismo_unittest.h"
+
+namespace
+{
+std::string readFile(const std::string & fn)
+{
+    std::ifstream in(fn.c_str(), std::ios::binary);
+    std::ostringstream res;
+    res << in.rdbuf();
+    return res.str();
+}
+}
+
+SUITE(gsParaviewFormat_test)
+{
+
+TEST(ascii)
+{
+    gsParaviewDataWriter data( (gsParaviewFormat()) );
+    std::vector<int> v(3);
+    v[0] = 1; v[1] = 2; v[2] = 3;
+
+    std::ostringstream out;
+    data.write(out, "Name=\"ids\"", v);
+    data.finish(out);
+    CHECK_EQUAL("<DataArray type=\"Int32\" Name=\"ids\" format=\"ascii\">\n1 2 3 \n</DataArray>\n",
+                out.str());
+    CHECK( data.fileAttributes().find("header_type") == std::string::npos );
+}
+
+TEST(binary)
+{
+    gsParaviewDataWriter data( gsParaviewFormat(gsParaviewFormat::binary) );
+    if ( data.fileAttributes().find("LittleEndian") == std::string::npos )
+        return; // expected strings below
+    std::vector<int> v(3);
+    v[0] = 1; v[1] = 2; v[2] = 3;
+    std::vector<float> w(2);
+    w[0] = 0.5f; w[1] = -2.0f;
+
+    // UInt64 size header followed by the values, base64-encoded
+    std::ostringstream out;
+    data.write(out, "Name=\"ids\"", v);
+    data.write(out, "Name=\"val\"", w);
+    data.finish(out);
+    CHECK_EQUAL("<DataArray type=\"Int32\" Name=\"ids\" format=\"binary\">\n"
+                "DAAAAAAAAAABAAAAAgAAAAMAAAA=\n</DataArray>\n"
+                "<DataArray type=\"Float32\" Name=\"val\" format=\"binary\">\n"
+                "CAAAAAAAAAAAAAA/AAAAwA==\n</DataArray>\n", out.str());
+    CHECK( data.fileAttributes().find("header_type=\"UInt64\"") != std::string::npos );
+}
+
+TEST(double_precision)
+{
+    // Double values are not rounded to single precision
+    std::vector<double> w(1, 12345.678901234);
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(9);
+    gsParaviewDataWriter( (gsParaviewFormat()) ).write(out, "Name=\"val\"", w);
+    CHECK( out.str().find("12345.678901234") != std::string::npos );
+
+    gsParaviewDataWriter data( gsParaviewFormat(gsParaviewFormat::binary) );
+    out.str("");
+    data.write(out, "Name=\"val\"", w);
+    CHECK( out.str().find("<DataArray type=\"Float64\"") == 0 );
+}
+
+TEST(appended_compressed)
+{
+    gsParaviewDataWriter data( gsParaviewFormat(gsParaviewFormat::appended, 9) );
+    CHECK( data.fileAttributes().find("vtkZLibDataCompressor") != std::string::npos );
+
+    // Two blocks of highly compressible data
+    std::vector<float> w(10000, 1.0f);
+    std::ostringstream out;
+    data.write(out, "Name=\"a\"", w);
+    data.write(out, "Name=\"b\"", w);
+    const std::string arrays = out.str();
+    CHECK( arrays.find("format=\"appended\" offset=\"0\"/>") != std::string::npos );
+
+    // Header: number of blocks, block size, size of last block,
+    // compressed size of each block
+    const std::string::size_type pos = arrays.rfind("offset=\"") + 8;
+    const size_t off = atoi(arrays.c_str() + pos);
+
+    data.finish(out);
+    const std::string file = out.str();
+    const std::string::size_type start = file.find("_", arrays.size()) + 1;
+    uint64_t header[5];
+    memcpy(header, file.data() + start, sizeof(header));
+    CHECK_EQUAL(2u    , header[0]);
+    CHECK_EQUAL(32768u, header[1]);
+    CHECK_EQUAL(40000u - 32768u, header[2]);
+    CHECK_EQUAL(off, sizeof(header) + header[3] + header[4]);
+    CHECK( file.size() < 40000 );
+}
+
+TEST(parallel_export)
+{
+    // The patches written concurrently agree with the serial output
+    gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5);
+    gsFunctionExpr<> f("sin(pi*x)*cos(pi*y)", 2);
+    gsField<> field(mp, f);
+    const std::string tmp = gsFileManager::getTempPath();
+    const std::string fn[2] = { tmp + "gsParaview_test_serial",
+                                tmp + "gsParaview_test_parallel" };
+    gsParaviewFormat fmt(gsParaviewFormat::binary);
+    for (index_t k = 0; k != 2; ++k)
+    {
+#       ifdef _OPENMP
+        const int nt = omp_get_max_threads();
+        if ( 0 == k )
+            omp_set_num_threads(1);
+#       endif
+        gsWriteParaview(field, fn[k], 400, true, fmt);
+        gsWriteParaview(mp, fn[k] + "_geo", 400, true, true, fmt);
+#       ifdef _OPENMP
+        omp_set_num_threads(nt);
+#       endif
+    }
+
+    for (index_t i = 0; i != mp.nPatches(); ++i)
+    {
+        const std::string p = util::to_string(i);
+        const std::string s = readFile(fn[0] + p + ".vts");
+        CHECK( !s.empty() );
+        CHECK( s == readFile(fn[1] + p + ".vts") );
+        CHECK( readFile(fn[0] + p + "_mesh.vtp") == readFile(fn[1] + p + "_mesh.vtp") );
+        CHECK( readFile(fn[0] + "_geo_" + p + ".vts") == readFile(fn[1] + "_geo_" + p + ".vts") );
+        CHECK( readFile(fn[0] + "_geo_" + p + "_cnet.vtp") == readFile(fn[1] + "_geo_" + p + "_cnet.vtp") );
+    }
+}
+
+}
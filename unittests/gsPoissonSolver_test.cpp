@@ -143,6 +143,41 @@ void runPoissonSolverTest( dirichlet::strategy Dstrategy, iFace::strategy Istrat
 }
 
 
+void runFixedPatternTest( dirichlet::strategy Dstrategy, iFace::strategy Istrategy )
+{
+    gsMultiPatch<> patches = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5);
+    gsFunctionExpr<> f("2*pi^2*sin(pi*x)*sin(pi*y)", 2);
+    gsFunctionExpr<> g("sin(pi*x)*sin(pi*y)", 2);
+
+    gsBoundaryConditions<> bcInfo;
+    for (gsMultiPatch<>::const_biterator
+             bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+        bcInfo.addCondition(*bit, condition_type::dirichlet, &g);
+
+    gsMultiBasis<> bases(patches);
+    bases.uniformRefine(2);
+
+    gsPoissonAssembler<real_t> poisson(patches, bases, bcInfo, f,
+                                       Dstrategy, Istrategy);
+    // Reference: default assembly
+    poisson.assemble();
+    const gsSparseMatrix<> K = poisson.matrix();
+    const gsMatrix<>       F = poisson.rhs();
+
+    // The first assembly computes the pattern, the second one reuses it
+    poisson.options().setSwitch("FixedPattern", true);
+    poisson.refresh();
+    poisson.assemble();
+    const index_t nz = poisson.matrix().nonZeros();
+    poisson.assemble();
+
+    CHECK( poisson.system().fixedPattern() );
+    CHECK_EQUAL( nz, poisson.matrix().nonZeros() );
+    CHECK_EQUAL( K.nonZeros(), poisson.matrix().nonZeros() );
+    CHECK( (K - poisson.matrix()).norm() < 1e-10 );
+    CHECK( (F - poisson.rhs()).norm() < 1e-10 );
+}
+
 SUITE(gsPoissonSolver_test)
 {
 
@@ -160,6 +195,12 @@ SUITE(gsPoissonSolver_test)
     {
         runPoissonSolverTest(dirichlet::nitsche, iFace::dg);
     }
+
+    TEST(FixedPattern_test)
+    {
+        runFixedPatternTest(dirichlet::elimination, iFace::glue);
+        runFixedPatternTest(dirichlet::nitsche, iFace::dg);
+    }
     
 }
 
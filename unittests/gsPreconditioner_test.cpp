@@ -87,6 +87,18 @@ void runPreconditionerTest( index_t testcase )
         solver.solve(rhs,sol);
         CHECK ( solver.error() <= solver.tolerance() );
     }
+    else if (testcase==4)
+    {
+        gsOptionList amgOpt = gsAlgebraicMultiGrid<>::defaultOptions();
+        amgOpt.setInt( "CoarseSize", 20 );
+        gsAlgebraicMultiGrid<> amg = gsAlgebraicMultiGrid<>::build(mat, amgOpt);
+        CHECK ( amg.numLevels() > 2 );
+        gsConjugateGradient<> solver(mat, amg.makeMultiGridOp(amgOpt));
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 25 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
 }
 
 
@@ -109,6 +121,99 @@ SUITE(gsPreconditioner_test)
     {
         runPreconditionerTest(3);
     }
+    TEST(gsAlgebraicMultiGridPreconditioner_test)
+    {
+        runPreconditionerTest(4);
+    }
+
+    TEST(gsAlgebraicMultiGridBlocks_test)
+    {
+        gsMultiPatch<> mp( *gsNurbsCreator<>::NurbsQuarterAnnulus() );
+        gsMultiBasis<> mb(mp);
+        for (int i = 0; i < 4; ++i)
+            mb.uniformRefine();
+
+        gsConstantFunction<> one(1,mp.geoDim());
+        gsBoundaryConditions<> bc;
+        bc.addCondition( boundary::north, condition_type::dirichlet, &one );
+
+        gsPoissonAssembler<> assembler(mp, mb, bc, one);
+        assembler.assemble();
+        const gsSparseMatrix<> & K = assembler.matrix();
+        const index_t n = K.rows();
+
+        // Two coupled copies of the Poisson problem, i.e., two blocks of
+        // the same size
+        gsSparseMatrix<> mat(2*n, 2*n);
+        {
+            gsSparseEntries<> entries;
+            for (index_t j = 0; j < K.outerSize(); ++j)
+                for (gsSparseMatrix<>::InnerIterator it(K, j); it; ++it)
+                {
+                    entries.add(it.row(),   it.col(),   it.value());
+                    entries.add(it.row()+n, it.col()+n, it.value());
+                    entries.add(it.row(),   it.col()+n, it.value()/4);
+                    entries.add(it.row()+n, it.col(),   it.value()/4);
+                }
+            mat.setFrom(entries);
+        }
+        gsMatrix<> rhs, sol;
+        rhs.setOnes(2*n, 1);
+
+        gsOptionList amgOpt = gsAlgebraicMultiGrid<>::defaultOptions();
+        amgOpt.setInt( "CoarseSize", 20 );
+
+        // The blocks are taken from a gsSparseSystem, so the unknowns are
+        // aggregated node-wise and every coarse level has two blocks of the
+        // same size
+        std::vector<gsDofMapper> mappers(2, assembler.system().colMapper(0));
+        gsVector<index_t> dims(2);
+        dims << 1, 1;
+        gsSparseSystem<> system(mappers, dims);
+        system.matrix() = mat;
+        CHECK_EQUAL( 2, system.numColBlocks() );
+
+        gsAlgebraicMultiGrid<> amg = gsAlgebraicMultiGrid<>::build(system, amgOpt);
+        CHECK ( amg.numLevels() > 2 );
+        for (index_t l = 0; l < amg.numLevels(); ++l)
+        {
+            const std::vector<index_t> & offsets = amg.blockOffsets()[l];
+            CHECK_EQUAL( 3u, offsets.size() );
+            CHECK_EQUAL( offsets[1], offsets[2] - offsets[1] );
+            CHECK_EQUAL( amg.matrices()[l]->rows(), offsets[2] );
+        }
+        CHECK_EQUAL( n, amg.blockOffsets().back()[1] );
+
+        sol.setZero(2*n, 1);
+        gsConjugateGradient<> solver(mat, amg.makeMultiGridOp(amgOpt));
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 25 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+
+        // Blocks of different sizes are aggregated one after the other;
+        // as the coupling between the blocks is ignored, more iterations
+        // are needed
+        std::vector<index_t> blockOffsets(3, 0);
+        blockOffsets[1] = n + n/2;
+        blockOffsets[2] = 2*n;
+        gsAlgebraicMultiGrid<> amg2 = gsAlgebraicMultiGrid<>::build(mat, blockOffsets, amgOpt);
+        CHECK ( amg2.numLevels() > 2 );
+        for (index_t l = 0; l < amg2.numLevels(); ++l)
+        {
+            const std::vector<index_t> & offsets = amg2.blockOffsets()[l];
+            CHECK_EQUAL( 3u, offsets.size() );
+            CHECK ( offsets[0] < offsets[1] && offsets[1] < offsets[2] );
+            CHECK_EQUAL( amg2.matrices()[l]->rows(), offsets[2] );
+        }
+
+        sol.setZero(2*n, 1);
+        gsConjugateGradient<> solver2(mat, amg2.makeMultiGridOp(amgOpt));
+        solver2.setTolerance( 1.e-8 );
+        solver2.setMaxIterations( 40 );
+        solver2.solve(rhs,sol);
+        CHECK ( solver2.error() <= solver2.tolerance() );
+    }
 
     TEST(gsPatchPreconditioner_stiff_test)
     {
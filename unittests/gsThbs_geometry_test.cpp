@@ -134,6 +134,32 @@ std::vector<index_t> random_refinement(int lvl, int max_nb,
 SUITE(gsThbs_geometry_test)
 {
 
+    TEST(gsThbs_refine_boxes)
+    {
+        // refine() with parameter boxes updates the basis like
+        // refineElements() with the corresponding element boxes
+        gsKnotVector<> kv(0, 1, 3, 3);
+        gsTensorBSplineBasis<2> tbasis(kv, kv);
+        gsTHBSplineBasis<2> THB(tbasis), ref(tbasis);
+        const index_t size0 = THB.size();
+
+        gsMatrix<> box(2, 2);
+        box << 0, 0.5, 0, 0.5;
+        THB.refine(box);
+
+        std::vector<index_t> elements(5);
+        elements[0] = 1;
+        elements[1] = elements[2] = 0;
+        elements[3] = elements[4] = 4;
+        ref.refineElements(elements);
+
+        CHECK( THB.size() > size0 );
+        CHECK_EQUAL( ref.size(), THB.size() );
+        CHECK( ref.getXmatrix() == THB.getXmatrix() );
+        CHECK( THB.numTruncated() > 0 );
+        CHECK_EQUAL( ref.numTruncated(), THB.numTruncated() );
+    }
+
     TEST(gsThbs_geometry_test)
     {
     gsVector<index_t> iv1;
@@ -208,4 +234,252 @@ SUITE(gsThbs_geometry_test)
 
     }
 
+    TEST(gsThbs_batched_evaluation)
+    {
+        gsKnotVector<> kv(0, 1, 3, 3);
+        gsTensorBSplineBasis<2> tbasis(kv, kv);
+        gsTHBSplineBasis<2> THB(tbasis);
+        gsMatrix<> box(2, 2);
+        box << 0, 0.5, 0, 0.5;
+        THB.refine(box);
+        box << 0, 0.25, 0.125, 0.375;
+        THB.refine(box);
+        CHECK( THB.numTruncated() > 0 );
+
+        // Quadrature nodes of all elements, as during assembly
+        gsMatrix<> pts(2, 0), nodes;
+        gsVector<> weights;
+        gsGaussRule<> qr(THB, 1.0, 1);
+        gsBasis<>::domainIter domIt = THB.makeDomainIterator();
+        for (; domIt->good(); domIt->next())
+        {
+            qr.mapTo(domIt->lowerCorner(), domIt->upperCorner(), nodes, weights);
+            pts.conservativeResize(2, pts.cols() + nodes.cols());
+            pts.rightCols(nodes.cols()) = nodes;
+        }
+
+        gsMatrix<index_t> act;
+        gsMatrix<> ev, der, der2, single;
+        THB.active_into(pts, act);
+        THB.eval_into(pts, ev);
+        THB.deriv_into(pts, der);
+        THB.deriv2_into(pts, der2);
+
+        // Errors of the values and of the derivatives
+        gsVector<> err = gsVector<>::Zero(3);
+        for (index_t c = 0; c != pts.cols(); ++c)
+            for (index_t j = 0; j != act.rows(); ++j)
+            {
+                if (j != 0 && act(j, c) == 0)
+                    break;
+                THB.evalSingle_into(act(j, c), pts.col(c), single);
+                err[0] = math::max(err[0], math::abs(ev(j, c) - single(0, 0)));
+                THB.derivSingle_into(act(j, c), pts.col(c), single);
+                err[1] = math::max(err[1], (der.block(2*j, c, 2, 1) - single).cwiseAbs().maxCoeff());
+                THB.deriv2Single_into(act(j, c), pts.col(c), single);
+                err[2] = math::max(err[2], (der2.block(3*j, c, 3, 1) - single).cwiseAbs().maxCoeff());
+            }
+
+        // The truncated functions sum their terms in a different order
+        // than de Boor's algorithm, so only the last bits may differ
+        const real_t tol = 8 * std::numeric_limits<real_t>::epsilon();
+        CHECK( err[0] <= tol * ev.cwiseAbs().maxCoeff() );
+        CHECK( err[1] <= tol * der.cwiseAbs().maxCoeff() );
+        CHECK( err[2] <= tol * der2.cwiseAbs().maxCoeff() );
+    }
+
+    TEST(gsThbs_active_cache)
+    {
+        gsKnotVector<> kv(0, 1, 3, 3);
+        gsTensorBSplineBasis<2> tbasis(kv, kv);
+        gsTHBSplineBasis<2> THB(tbasis);
+        gsMatrix<> box(2, 2);
+        box << 0, 0.5, 0, 0.5;
+        THB.refine(box);
+
+        gsMatrix<> pts, nodes, supp;
+        gsVector<> weights;
+        gsMatrix<index_t> act, act2;
+        gsVector<index_t> numAct;
+        for (index_t step = 0; step != 2; ++step)
+        {
+            // Quadrature nodes of all elements and scattered points
+            pts.resize(2, 50);
+            for (index_t c = 0; c != pts.cols(); ++c)
+            {
+                const real_t x = 0.1 + 0.618034 * c, y = 0.3 + 0.414214 * c;
+                pts(0, c) = x - math::floor(x);
+                pts(1, c) = y - math::floor(y);
+            }
+            gsGaussRule<> qr(THB, 1.0, 1);
+            gsBasis<>::domainIter domIt = THB.makeDomainIterator();
+            for (; domIt->good(); domIt->next())
+            {
+                qr.mapTo(domIt->lowerCorner(), domIt->upperCorner(), nodes, weights);
+                pts.conservativeResize(2, pts.cols() + nodes.cols());
+                pts.rightCols(nodes.cols()) = nodes;
+            }
+
+            // Actives shared by the points of one element agree with the supports
+            THB.active_into(pts, act);
+            THB.numActive_into(pts, numAct);
+            bool ok = true;
+            for (index_t c = 0; c != pts.cols(); ++c)
+            {
+                index_t j = 0;
+                for (index_t i = 0; i != THB.size(); ++i)
+                {
+                    supp = THB.support(i);
+                    if ( (supp.col(0).array() <= pts.col(c).array()).all() &&
+                         (pts.col(c).array() <  supp.col(1).array()).all() )
+                        ok = ok && j < act.rows() && act(j++, c) == i;
+                }
+                ok = ok && j == numAct[c];
+            }
+            CHECK( ok );
+
+            // The second evaluation is served from the cache
+            THB.active_into(pts, act2);
+            CHECK( act2 == act );
+
+            // Refine half of a coarse element, which invalidates the cache
+            box << 0.5, 0.625, 0.5, 0.75;
+            THB.refine(box);
+        }
+    }
+
+    // Accumulates the area of the leaves of each level
+    struct leafArea
+    {
+        gsVector<index_t> * area;
+        unsigned indexLevel;
+        void operator()(const gsVector<index_t,2> & lower,
+                        const gsVector<index_t,2> & upper, int lvl) const
+        {
+            const index_t a = ((upper - lower).prod()) << (2 * (indexLevel - lvl));
+#           pragma omp atomic
+            (*area)[lvl] += a;
+        }
+    };
+
+    TEST(gsHDomain_packed)
+    {
+        gsHDomain<2> tree;
+        gsVector<index_t,2> upp, k1, k2;
+        upp << 8, 8;
+        tree.init(upp, 6);
+        k1 << 0, 0; k2 << 16, 12;
+        tree.insertBox(k1, k2, 1);
+        k1 << 4, 4; k2 << 20, 10;
+        tree.insertBox(k1, k2, 2);
+        k1 << 14, 6; k2 << 18, 18;
+        tree.insertBox(k1, k2, 3);
+        CHECK( !tree.isPacked() );
+        tree.makeCompressed();
+        CHECK( tree.isPacked() );
+
+        // The same tree, without the packed copy
+        gsHDomain<2> ptr(tree);
+        ptr.beginLeafIterator();
+        CHECK( !ptr.isPacked() );
+
+        // All cells of level 3, in lexicographic order
+        gsMatrix<index_t> pts(2, 64 * 64);
+        for (index_t j = 0; j != 64; ++j)
+            for (index_t i = 0; i != 64; ++i)
+                pts.col(64 * j + i) << i, j;
+
+        gsVector<index_t> lvl, lvlPtr;
+        tree.levelOf(pts, 3, lvl);
+        ptr .levelOf(pts, 3, lvlPtr);
+        CHECK( lvl == lvlPtr );
+        bool ok = true;
+        for (index_t c = 0; c != pts.cols(); ++c)
+        {
+            k1 = pts.col(c);
+            ok = ok && lvl[c] == ptr.levelOf(k1, 3) && lvl[c] == tree.levelOf(k1, 3);
+            k2 = k1.array() + 1;
+            ok = ok && tree.query3(k1, k2, 3) == ptr.query3(k1, k2, 3);
+            k1 /= 2; k2 = k1.array() + 1; // cells of level 2
+            ok = ok && tree.query2(k1, k2, 2) == ptr.query2(k1, k2, 2)
+                    && tree.query4(k1, k2, 2) == ptr.query4(k1, k2, 2);
+        }
+        CHECK( ok );
+
+        // Same leaves, visited in parallel
+        gsVector<index_t> area = gsVector<index_t>::Zero(4), areaPtr = area;
+        leafArea op = { &area, tree.getIndexLevel() };
+        tree.forEachLeaf(op);
+        op.area = &areaPtr;
+        ptr.forEachLeaf(op);
+        CHECK( area == areaPtr );
+        CHECK( area.sum() == (index_t)(64 * 64) << 6 );
+
+        // Modifying the tree discards the packed copy
+        tree.insertBox(k1, k2, 3);
+        CHECK( !tree.isPacked() );
+    }
+
+
+    // Builds the basis from scratch, out of the leaves of the tree of \a basis
+    gsTHBSplineBasis<2> rebuild(const gsTensorBSplineBasis<2> & tbasis,
+                                const gsTHBSplineBasis<2> & basis)
+    {
+        gsMatrix<index_t> b1, b2;
+        gsVector<index_t> level;
+        basis.tree().getBoxesInLevelIndex(b1, b2, level);
+        std::vector<index_t> boxes;
+        for (index_t i = 0; i != level.size(); ++i)
+        {
+            boxes.push_back(level[i]);
+            boxes.push_back(b1(i,0)); boxes.push_back(b1(i,1));
+            boxes.push_back(b2(i,0)); boxes.push_back(b2(i,1));
+        }
+        return gsTHBSplineBasis<2>(tbasis, boxes);
+    }
+
+    TEST(gsThbs_incremental_refine)
+    {
+        // Local refinements update the structure only around the
+        // refined boxes, the result has to agree with a full rebuild
+        gsKnotVector<> kv(0, 1, 7, 3);
+        gsTensorBSplineBasis<2> tbasis(kv, kv);
+        gsTHBSplineBasis<2> THB(tbasis);
+
+        gsMatrix<> pts(2, 21 * 21);
+        for (index_t j = 0; j != 21; ++j)
+            for (index_t i = 0; i != 21; ++i)
+                pts.col(21 * j + i) << i / 20.0, j / 20.0;
+
+        const index_t steps[6][5] = { {1,  0,  0,  4,  4},
+                                      {2,  2,  2,  6,  6},
+                                      {3,  5,  5,  9,  9},
+                                      {1, 10,  4, 14, 10},
+                                      {3, 20, 30, 40, 48},
+                                      {2,  0, 12,  8, 16} };
+        gsMatrix<> box(2, 2);
+        for (index_t s = 0; s != 8; ++s)
+        {
+            if (s < 6)
+                THB.refineElements(std::vector<index_t>(steps[s], steps[s] + 5));
+            else // sinking boxes
+            {
+                box << 0.1 * s - 0.5, 0.1 * s - 0.3, 0.3, 0.45;
+                THB.refine(box);
+            }
+
+            gsTHBSplineBasis<2> full = rebuild(tbasis, THB);
+            CHECK_EQUAL( full.size(), THB.size() );
+            CHECK( full.getXmatrix().size() <= THB.getXmatrix().size() );
+            bool ok = true;
+            for (size_t l = 0; l != THB.getXmatrix().size(); ++l)
+                ok = ok && ( l < full.getXmatrix().size() ?
+                             full.getXmatrix()[l] == THB.getXmatrix()[l] :
+                             THB.getXmatrix()[l].empty() );
+            CHECK( ok );
+            CHECK( (full.eval(pts) - THB.eval(pts)).norm() < 1e-12 );
+            CHECK( (full.deriv(pts) - THB.deriv(pts)).norm() < 1e-10 );
+        }
+    }
+
 }
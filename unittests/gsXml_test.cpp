@@ -0,0 +1,131 @@
+/** @file gsXml_test.cpp
+
+    @brief Tests the text and binary encodings of matrices in XML files
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+**/
+
+#include "gismo_unittest.h"
+
+SUITE(gsXml_test)
+{
+
+TEST(parseReal)
+{
+    const char * str = " 0.1 -2.5e-3\n1/4 123456789012345678901234 9007199254740993 7";
+    const double expected[] = {0.1, -2.5e-3, 0.25, 123456789012345678901234.0,
+                               9007199254740993.0, 7.0};
+    double val;
+    for (int i = 0; i != 6; ++i)
+    {
+        CHECK( internal::parseReal(str, val) );
+        CHECK_EQUAL( expected[i], val );
+    }
+    CHECK( !internal::parseReal(str, val) );
+
+    // Trailing characters are not accepted
+    const char * bad = " 1.5abc";
+    const char * pos = bad;
+    CHECK( !internal::parseReal(pos, val) );
+    CHECK( pos == bad );
+}
+
+TEST(base64)
+{
+    const std::string data("G+Smo\0\xff", 7);
+    std::string enc, dec;
+    internal::encodeBase64(data.data(), data.size(), enc);
+    CHECK_EQUAL("RytTbW8A/w==", enc);
+    CHECK( internal::decodeBase64(enc.c_str(), dec) );
+    CHECK( data == dec );
+    CHECK( !internal::decodeBase64("RytT*", dec) );
+}
+
+TEST(binary_matrices)
+{
+    gsMatrix<real_t> M(20, 3);
+    M.setRandom();
+    M(0,0) = (real_t)(1) / 3;
+    gsSparseMatrix<real_t> S(10, 8);
+    for (index_t i = 0; i != 10; ++i)
+        S.insert(i, (3*i) % 8) = (real_t)(i+1) / 7;
+    S.makeCompressed();
+
+    gsFileData<real_t> fd;
+    fd.setBinaryMatrices();
+    fd << M;
+    fd << S;
+
+    std::ostringstream os;
+    os << fd;
+    CHECK( os.str().find("format=\"base64\"") != std::string::npos );
+
+    gsMatrix<real_t> M2;
+    gsSparseMatrix<real_t> S2;
+    fd.getFirst(M2);
+    fd.getFirst(S2);
+    if ( std::numeric_limits<real_t>::is_iec559 ) // binary storage is exact
+    {
+        CHECK( M == M2 );
+        CHECK_EQUAL( S.nonZeros(), S2.nonZeros() );
+        CHECK_EQUAL( 0, (S - S2).norm() );
+    }
+}
+
+
+TEST(lazy_read)
+{
+    gsMultiPatch<real_t> mp = gsNurbsCreator<real_t>::BSplineSquareGrid(2, 2);
+    gsMatrix<real_t> M(2, 2);
+    M << 1, 2, 3, 4;
+
+    gsFileData<real_t> fd;
+    fd << M;
+    fd << mp;
+    fd.addComment("<Matrix> in a comment");
+    const std::string fn = gsFileManager::getTempPath() + "gsXml_test_lazy.xml";
+    fd.save(fn);
+
+    internal::gsXmlLazyFile file;
+    CHECK( file.open(fn) );
+    CHECK_EQUAL( 6u, file.entries().size() );
+    CHECK_EQUAL( 4, file.count("Geometry", "") );
+    CHECK_EQUAL( 1, file.count("MultiPatch", "") );
+    file.close();
+
+    gsFileData<real_t> lazy;
+    CHECK( lazy.readLazy(fn) );
+    gsMultiPatch<real_t> mp2;
+    CHECK( lazy.getFirst(mp2) );
+    CHECK_EQUAL( 4u, mp2.nPatches() );
+    CHECK( mp.patch(3).coefs() == mp2.patch(3).coefs() );
+    CHECK_EQUAL( 1, lazy.count< gsMatrix<real_t> >() );
+    gsMatrix<real_t> M2;
+    CHECK( lazy.getFirst(M2) );
+    CHECK( M == M2 );
+    CHECK_EQUAL( 6, lazy.numTags() );
+    std::remove(fn.c_str());
+}
+
+TEST(lazy_parse_error)
+{
+    // A malformed node is reported when it is loaded
+    const std::string fn = gsFileManager::getTempPath() + "gsXml_test_malformed.xml";
+    {
+        std::ofstream out(fn.c_str());
+        out << "<xml>\n<Matrix rows=\"1\" cols=1>1</Matrix>\n</xml>\n";
+    }
+    internal::gsXmlLazyFile file;
+    CHECK( file.open(fn) );
+    CHECK_EQUAL( 1u, file.entries().size() );
+    internal::gsXmlTree data;
+    CHECK( NULL == file.load(0, data) );
+    file.close();
+    std::remove(fn.c_str());
+}
+
+}